@@ -349,6 +349,8 @@ MACRO(ALLPIX_MODULE_TESTS name directory)
             SET(tmp "${tmp} ${item}")
         ENDFOREACH()
         SET_PROPERTY(GLOBAL PROPERTY MODULES_TEST_DESCRIPTIONS "${tmp}")
+        # Reset the descriptions in case further test directories are registered for the same module
+        SET(TEST_DESCRIPTIONS "")
     ENDIF()
 ENDMACRO()
 
@@ -0,0 +1,160 @@
+#!/usr/bin/python3
+
+# SPDX-FileCopyrightText: 2024 CERN and the Allpix Squared authors
+# SPDX-License-Identifier: MIT
+
+"""
+Read trajectory files written by the propagation modules with the output_trajectories option, verify their structure and
+print a summary. Optionally, the final points of all trajectories are compared to a second file with the same trajectories.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'APTRAJ01'
+PRECISIONS = {0: 'int16', 1: 'float16'}
+CARRIER_TYPES = {-1: 'electrons', 1: 'holes'}
+# Number of states defined in PropagatedCharge::CarrierState
+CARRIER_STATES = 5
+
+
+class TrajectoryFileError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.offset = 0
+
+    def read(self, fmt: str, count: int = 1) -> tuple:
+        fmt = '<{}{}'.format(count, fmt)
+        size = struct.calcsize(fmt)
+        if self.offset + size > len(self.data):
+            raise TrajectoryFileError('unexpected end of file at byte {}'.format(self.offset))
+        values = struct.unpack_from(fmt, self.data, self.offset)
+        self.offset += size
+        return values
+
+    def done(self) -> bool:
+        return self.offset == len(self.data)
+
+
+def read_file(file_name: str) -> dict:
+    """
+    Read a trajectory file and return its header and the events with the decoded trajectories.
+    """
+    with open(file_name, 'rb') as file:
+        reader = Reader(file.read())
+
+    if reader.read('s', 8)[0] != MAGIC:
+        raise TrajectoryFileError('file does not start with {}'.format(MAGIC.decode()))
+    version = reader.read('H')[0]
+    if version != 1:
+        raise TrajectoryFileError('unknown format version {}'.format(version))
+    precision = reader.read('B')[0]
+    if precision not in PRECISIONS:
+        raise TrajectoryFileError('unknown precision {}'.format(precision))
+    decimation = reader.read('I')[0]
+    step = reader.read('d')[0]
+    center = reader.read('f', 3)
+    half_size = reader.read('f', 3)
+    if decimation == 0 or step <= 0 or min(half_size) <= 0:
+        raise TrajectoryFileError('invalid header values')
+
+    def decode(values: tuple, axis: int) -> list:
+        if precision == 0:
+            return [center[axis] + value / 32767. * half_size[axis] for value in values]
+        return [center[axis] + value for value in struct.unpack('<{}e'.format(len(values)),
+                                                                 struct.pack('<{}H'.format(len(values)), *values))]
+
+    events = []
+    while not reader.done():
+        event_num, groups, total_points = reader.read('Q')[0], reader.read('I')[0], reader.read('I')[0]
+        if events and event_num <= events[-1]['number']:
+            raise TrajectoryFileError('event {} follows event {}'.format(event_num, events[-1]['number']))
+        times = reader.read('f', groups)
+        charges = reader.read('I', groups)
+        types = reader.read('b', groups)
+        states = reader.read('B', groups)
+        point_counts = reader.read('I', groups)
+        if sum(point_counts) != total_points or 0 in point_counts:
+            raise TrajectoryFileError('inconsistent number of points in event {}'.format(event_num))
+        if any(carrier_type not in CARRIER_TYPES for carrier_type in types):
+            raise TrajectoryFileError('unknown carrier type in event {}'.format(event_num))
+        if any(state >= CARRIER_STATES for state in states):
+            raise TrajectoryFileError('unknown carrier state in event {}'.format(event_num))
+
+        fmt = 'h' if precision == 0 else 'H'
+        columns = [decode(reader.read(fmt, total_points), axis) for axis in range(3)]
+        points = list(zip(*columns))
+        for point in points:
+            for axis in range(3):
+                if abs(point[axis] - center[axis]) > half_size[axis] * (1 + 1e-3):
+                    raise TrajectoryFileError('point {} outside of the sensor in event {}'.format(point, event_num))
+
+        trajectories = []
+        first = 0
+        for count in point_counts:
+            trajectories.append(points[first:first + count])
+            first += count
+        events.append({'number': event_num, 'times': times, 'charges': charges, 'types': types, 'states': states,
+                       'trajectories': trajectories})
+
+    return {'precision': precision, 'decimation': decimation, 'step': step, 'center': center, 'half_size': half_size,
+            'events': events}
+
+
+def resolution(content: dict, point: tuple, axis: int) -> float:
+    """
+    Largest difference between a stored and the original coordinate.
+    """
+    if content['precision'] == 0:
+        return content['half_size'][axis] / 32767.
+    return max(abs(point[axis] - content['center'][axis]), 6.1e-5) * 2**-11
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('file', help='trajectory file to read')
+    parser.add_argument('--compare', help='trajectory file with the same trajectories stored with different settings')
+    args = parser.parse_args()
+
+    try:
+        content = read_file(args.file)
+        events = content['events']
+        groups = sum(len(event['trajectories']) for event in events)
+        print('Trajectory file {} stores positions as {} with decimation {}'.format(
+            args.file, PRECISIONS[content['precision']], content['decimation']))
+        for carrier_type, name in CARRIER_TYPES.items():
+            charge = sum(charge for event in events for charge, other in zip(event['charges'], event['types'])
+                         if other == carrier_type)
+            if charge > 0:
+                print('Read {} events with {} charge carrier groups carrying {} {}'.format(len(events), groups, charge,
+                                                                                           name))
+
+        if args.compare:
+            other = read_file(args.compare)
+            if [event['number'] for event in other['events']] != [event['number'] for event in events]:
+                raise TrajectoryFileError('files contain different events')
+            compared = 0
+            for event, other_event in zip(events, other['events']):
+                if len(event['trajectories']) != len(other_event['trajectories']) or \
+                        event['charges'] != other_event['charges'] or event['types'] != other_event['types']:
+                    raise TrajectoryFileError('files contain different trajectories in event {}'.format(event['number']))
+                for trajectory, other_trajectory in zip(event['trajectories'], other_event['trajectories']):
+                    for axis in range(3):
+                        tolerance = resolution(content, trajectory[-1], axis) + resolution(other, trajectory[-1], axis)
+                        if abs(trajectory[-1][axis] - other_trajectory[-1][axis]) > tolerance * (1 + 1e-3):
+                            raise TrajectoryFileError('final points {} and {} differ in event {}'.format(
+                                trajectory[-1], other_trajectory[-1], event['number']))
+                    compared += 1
+            print('Final points of {} trajectories agree with {}'.format(compared, args.compare))
+    except (OSError, TrajectoryFileError) as error:
+        print('ERROR: Invalid trajectory file {}: {}'.format(args.file, error))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @brief Unit test of the random number pool
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/utils/random_pool.h"
+
+using namespace allpix;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& message) {
+        if(!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Check the sample mean and variance of a distribution against the expected values
+     */
+    void check_moments(const std::string& name, const std::function<double()>& draw, double mean, double variance) {
+        const std::size_t samples = 1000000;
+        double sum = 0, sum_squares = 0;
+        for(std::size_t i = 0; i < samples; ++i) {
+            auto value = draw();
+            sum += value;
+            sum_squares += value * value;
+        }
+        auto sample_mean = sum / samples;
+        auto sample_variance = sum_squares / samples - sample_mean * sample_mean;
+
+        // Allow for five standard errors of the mean and a relative deviation of one percent on the variance
+        check(std::fabs(sample_mean - mean) < 5. * std::sqrt(variance / samples),
+              name + " mean " + std::to_string(sample_mean));
+        check(std::fabs(sample_variance - variance) < 0.01 * variance,
+              name + " variance " + std::to_string(sample_variance));
+    }
+} // namespace
+
+int main() {
+    // The engine has to be reproducible from its seed, and different seeds have to lead to different sequences
+    Xoshiro256PlusPlus engine_a(42), engine_b(42), engine_c(43);
+    bool different = false;
+    for(int i = 0; i < 100; ++i) {
+        auto a = engine_a();
+        check(a == engine_b(), "engine not reproducible from seed");
+        different |= (a != engine_c());
+    }
+    check(different, "different seeds produce identical sequences");
+
+    // Batch draws across block boundaries have to return the same sequence as single draws
+    RandomNumberPool pool_single(1, 7), pool_batch(1, 7);
+    std::vector<double> batch(50);
+    pool_batch.uniform(batch.data(), batch.size());
+    for(auto value : batch) {
+        check(value == pool_single.uniform(), "uniform batch differs from single draws");
+    }
+    pool_batch.normal(batch.data(), batch.size());
+    for(auto value : batch) {
+        check(value == pool_single.normal(), "normal batch differs from single draws");
+    }
+    pool_batch.exponential(batch.data(), batch.size());
+    for(auto value : batch) {
+        check(value == pool_single.exponential(), "exponential batch differs from single draws");
+    }
+
+    // Uniform numbers have to be in the half-open unit interval
+    RandomNumberPool pool(0);
+    for(int i = 0; i < 100000; ++i) {
+        auto value = pool.uniform();
+        check(value >= 0. && value < 1., "uniform number out of range " + std::to_string(value));
+    }
+
+    check_moments("uniform", [&pool]() { return pool.uniform(); }, 0.5, 1. / 12.);
+    check_moments("normal", [&pool]() { return pool.normal(); }, 0., 1.);
+    check_moments("exponential", [&pool]() { return pool.exponential(); }, 1., 1.);
+
+    if(failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief Unit test of the shared memory ring buffer of the SharedMemoryWriter module
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "modules/SharedMemoryWriter/SharedMemoryRing.hpp"
+
+using namespace allpix::shm;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& message) {
+        if(!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++failures;
+        }
+    }
+
+    template <typename T> void append(std::vector<char>& buffer, const T& record) {
+        auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &record, sizeof(T));
+    }
+
+    /**
+     * @brief Build an event record with one detector holding one hit per particle, every hit linked to its particle
+     */
+    std::vector<char> make_event(uint64_t event, uint32_t hits) {
+        std::vector<char> buffer;
+        append(buffer, EventRecord{event, 1000 + event, 1, 0});
+        DetectorRecord detector{};
+        std::strncpy(detector.name, "dut", detector_name_length - 1);
+        detector.hits = hits;
+        detector.particles = hits;
+        detector.links = hits;
+        append(buffer, detector);
+        for(uint32_t i = 0; i < hits; ++i) {
+            append(buffer,
+                   HitRecord{static_cast<int32_t>(i), static_cast<int32_t>(event), 0.5 * i, 1. * event, 2. * event, i, 1});
+        }
+        for(uint32_t i = 0; i < hits; ++i) {
+            append(buffer, ParticleRecord{11, 0, {1. * i, 0, 0}, {1. * i, 0, 1}, 0, 0});
+        }
+        for(uint32_t i = 0; i < hits; ++i) {
+            append(buffer, i);
+        }
+        buffer.resize(align8(buffer.size()));
+        return buffer;
+    }
+
+    /**
+     * @brief Check that an event read by a consumer matches the record built by make_event
+     */
+    void check_event(const EventView& view, uint64_t event, uint32_t hits) {
+        check(view.event == event && view.seed == 1000 + event, "event " + std::to_string(event) + " has wrong header");
+        if(view.detectors.size() != 1) {
+            check(false, "event " + std::to_string(event) + " has wrong number of detectors");
+            return;
+        }
+        const auto& detector = view.detectors.front();
+        check(detector.name == "dut" && detector.hit_count == hits && detector.particle_count == hits,
+              "detector of event " + std::to_string(event) + " has wrong content");
+        for(size_t i = 0; i < detector.hit_count; ++i) {
+            const auto& hit = detector.hits[i];
+            auto particles = detector.getParticles(hit);
+            check(hit.x == static_cast<int32_t>(i) && hit.y == static_cast<int32_t>(event) && hit.signal == 0.5 * i,
+                  "hit " + std::to_string(i) + " of event " + std::to_string(event) + " has wrong content");
+            check(particles.size() == 1 && particles.front()->local_start_point[0] == 1. * i,
+                  "hit " + std::to_string(i) + " of event " + std::to_string(event) + " links wrong particles");
+        }
+    }
+} // namespace
+
+int main() {
+    const auto name = "/allpix_test_ring_" + std::to_string(getpid());
+    const auto no_wait = std::chrono::nanoseconds(0);
+    const auto timeout = std::chrono::milliseconds(50);
+
+    // Every consumer receives all events published after it attached, in order
+    {
+        RingProducer producer(name, 4096, FullPolicy::BLOCK, timeout);
+        check(producer.getCapacity() == 4096, "capacity not rounded to power of two");
+
+        // The segment must only be accessible to the owner
+        auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+        struct stat info {};
+        check(fd >= 0 && fstat(fd, &info) == 0 && (info.st_mode & 0777) == 0600, "segment is accessible to other users");
+        close(fd);
+
+        auto event = make_event(0, 2);
+        producer.publish(event.data(), event.size());
+
+        RingConsumer first(name);
+        RingConsumer second(name);
+        check(producer.getConsumerCount() == 2, "consumers not registered");
+
+        // Publish more data than the capacity such that the records wrap around the end of the data area
+        EventView view;
+        for(uint64_t number = 1; number <= 100; ++number) {
+            event = make_event(number, static_cast<uint32_t>(number % 5));
+            check(producer.publish(event.data(), event.size()) == 0, "event " + std::to_string(number) + " not published");
+            for(auto* consumer : {&first, &second}) {
+                check(consumer->next(view, no_wait), "event " + std::to_string(number) + " not received");
+                check_event(view, number, static_cast<uint32_t>(number % 5));
+            }
+        }
+        check(!first.next(view, no_wait), "event received that has not been published");
+        check(first.getPublishedEvents() == 101 && first.getDroppedEvents() == 0, "wrong event statistics");
+        producer.unlink();
+    }
+
+    // The block policy waits for consumers and detaches them after the timeout
+    {
+        RingProducer producer(name, 1024, FullPolicy::BLOCK, timeout);
+        RingConsumer consumer(name);
+        auto event = make_event(0, 1);
+
+        int published = 0;
+        int detached = 0;
+        auto start = std::chrono::steady_clock::now();
+        while(detached == 0 && published < 100) {
+            detached = producer.publish(event.data(), event.size());
+            ++published;
+        }
+        check(detached == 1, "blocking consumer not detached");
+        check(std::chrono::steady_clock::now() - start >= timeout, "producer did not wait for the blocking consumer");
+        check(!consumer.isAttached() && producer.getConsumerCount() == 0, "detached consumer still attached");
+        bool thrown = false;
+        try {
+            EventView view;
+            consumer.next(view, no_wait);
+        } catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown, "detached consumer can still read");
+        check(producer.publish(event.data(), event.size()) == 0, "event not published after detaching consumer");
+        producer.unlink();
+    }
+
+    // The drop policy skips events while the buffer is full, and the events before are delivered intact
+    {
+        RingProducer producer(name, 1024, FullPolicy::DROP, timeout);
+        RingConsumer consumer(name);
+
+        uint64_t published = 0;
+        while(true) {
+            auto event = make_event(published, 1);
+            if(producer.publish(event.data(), event.size()) < 0) {
+                break;
+            }
+            ++published;
+        }
+        check(published > 0 && consumer.getDroppedEvents() == 1, "no event dropped with full buffer");
+        check(consumer.isAttached(), "consumer detached with drop policy");
+
+        EventView view;
+        for(uint64_t number = 0; number < published; ++number) {
+            check(consumer.next(view, no_wait), "event " + std::to_string(number) + " not received");
+            check_event(view, number, 1);
+        }
+        check(consumer.release(), "consumer detached before releasing");
+
+        auto event = make_event(published, 1);
+        check(producer.publish(event.data(), event.size()) == 0, "event not published after releasing space");
+
+        // Records larger than the buffer are always dropped
+        auto large = make_event(published + 1, 100);
+        check(producer.publish(large.data(), large.size()) < 0, "record larger than the buffer published");
+        producer.unlink();
+
+        check(consumer.next(view, no_wait), "event not received after releasing space");
+        check_event(view, published, 1);
+    }
+
+    if(failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
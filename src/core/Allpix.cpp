@@ -74,6 +74,10 @@ Allpix::Allpix(std::string config_file_name,
     } else {
         log_level_string = Log::getStringFromLevel(Log::getReportingLevel());
     }
+    if(Log::getReportingLevel() > compiled_log_level) {
+        LOG(WARNING) << "Log level " << log_level_string << " is not available in this build, messages above level "
+                     << Log::getStringFromLevel(compiled_log_level) << " have been removed at compile time";
+    }
 
     // Set the log format from config
     auto log_format_string = global_config.get<std::string>("log_format", "DEFAULT");
@@ -95,6 +99,12 @@ Allpix::Allpix(std::string config_file_name,
         Log::addStream(log_file_);
     }
 
+    // Write log messages from a background thread if requested
+    if(global_config.get<bool>("log_asynchronous", false)) {
+        LOG(TRACE) << "Writing log messages asynchronously";
+        Log::setAsynchronous(true);
+    }
+
     // Wait for the first detailed messages until level and format are properly set
     LOG(TRACE) << "Global log level is set to " << log_level_string;
     LOG(TRACE) << "Global log format is set to " << log_format_string;
@@ -117,6 +127,17 @@ void Allpix::load() {
     LOG(STATUS) << "Welcome to Allpix^2 " << ALLPIX_PROJECT_VERSION;
     global_config.set<std::string>("version", ALLPIX_PROJECT_VERSION, true);
 
+    // Shards of a run need to be seeded identically to reproduce the event seeds of a single-process run
+    auto number_of_shards = global_config.get<uint64_t>("number_of_shards", 1);
+    if(number_of_shards == 0) {
+        throw InvalidValueError(global_config, "number_of_shards", "number of shards has to be positive");
+    }
+    if(number_of_shards > 1 && !global_config.has("random_seed")) {
+        throw InvalidCombinationError(global_config,
+                                      {"number_of_shards", "random_seed"},
+                                      "a fixed random seed is required when running multiple shards");
+    }
+
     uint64_t seed = 0;
     if(global_config.has("random_seed")) {
         // Use provided random seed
@@ -32,14 +32,13 @@ Detector::Detector(std::string name,
                    ROOT::Math::XYZPoint position,
                    const ROOT::Math::Rotation3D& orientation)
     : Detector(std::move(name), std::move(position), orientation) {
-    model_ = std::move(model); // NOLINT
     // Check if valid model is supplied
-    if(model_ == nullptr) {
+    if(model == nullptr) {
         throw InvalidModuleActionException("Detector model cannot be a null pointer");
     }
 
-    // Build the transformation matrix
-    build_transform();
+    // Attach the model to the fields and build the transformation matrix
+    set_model(std::move(model));
 }
 
 /**
@@ -58,6 +57,7 @@ void Detector::set_model(std::shared_ptr<DetectorModel> model) {
     electric_field_.set_model(model_);
     weighting_potential_.set_model(model_);
     doping_profile_.set_model(model_);
+    field_bundle_.set_model(model_);
 
     build_transform();
 }
@@ -129,12 +129,14 @@ void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<double>>&
                                     std::pair<double, double> thickness_domain) {
     check_field_match(size, mapping, scales, thickness_domain);
     electric_field_.setGrid(field, bins, size, mapping, scales, offset, thickness_domain);
+    build_field_bundle();
 }
 
 void Detector::setElectricFieldFunction(FieldFunction<ROOT::Math::XYZVector> function,
                                         std::pair<double, double> thickness_domain,
                                         FieldType type) {
     electric_field_.setFunction(std::move(function), thickness_domain, type);
+    build_field_bundle();
 }
 
 /**
@@ -206,6 +208,7 @@ void Detector::setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
                                     std::pair<double, double> thickness_domain) {
     check_field_match(size, mapping, scales, thickness_domain);
     doping_profile_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain);
+    build_field_bundle();
 }
 
 void Detector::setDopingProfileFunction(FieldFunction<double> function, FieldType type) {
@@ -213,6 +216,59 @@ void Detector::setDopingProfileFunction(FieldFunction<double> function, FieldTyp
                                 {model_->getSensorCenter().z() - model_->getSensorSize().z() / 2,
                                  model_->getSensorCenter().z() + model_->getSensorSize().z() / 2},
                                 type);
+    build_field_bundle();
+}
+
+/**
+ * The bundle is only used strictly inside the thickness domain, where neither the electric field nor the extrapolation of
+ * the doping profile along z need to be treated separately.
+ */
+std::pair<ROOT::Math::XYZVector, double> Detector::getElectricFieldAndDoping(const ROOT::Math::XYZPoint& local_pos) const {
+    if(field_bundle_.isValid() && field_bundle_.thickness_domain_.first <= local_pos.z() &&
+       local_pos.z() < field_bundle_.thickness_domain_.second) {
+        auto values = field_bundle_.get(local_pos);
+        return {ROOT::Math::XYZVector(values[0], values[1], values[2]), values[3]};
+    }
+    return {getElectricField(local_pos), getDopingConcentration(local_pos)};
+}
+
+/**
+ * The bundle stores the three components of the electric field followed by the doping concentration for every grid point,
+ * such that both are read from the same cache line. It is only built if the electric field and the doping profile are
+ * both grids with identical binning, mapping, scaling, offset and thickness domain, and is discarded whenever one of them
+ * is replaced.
+ */
+void Detector::build_field_bundle() {
+    field_bundle_ = DetectorField<FieldBundle, 4>();
+    field_bundle_.set_model(model_);
+
+    const auto& efield = electric_field_;
+    const auto& doping = doping_profile_;
+    if(efield.type_ != FieldType::GRID || doping.type_ != FieldType::GRID || efield.bins_ != doping.bins_ ||
+       efield.mapping_ != doping.mapping_ || efield.normalization_ != doping.normalization_ ||
+       efield.offset_ != doping.offset_ || efield.thickness_domain_ != doping.thickness_domain_) {
+        return;
+    }
+
+    auto points = efield.bins_[0] * efield.bins_[1] * efield.bins_[2];
+    auto bundle = std::make_shared<std::vector<double>>();
+    bundle->reserve(4 * points);
+    for(size_t i = 0; i < points; ++i) {
+        bundle->push_back((*efield.field_)[3 * i]);
+        bundle->push_back((*efield.field_)[3 * i + 1]);
+        bundle->push_back((*efield.field_)[3 * i + 2]);
+        bundle->push_back((*doping.field_)[i]);
+    }
+
+    field_bundle_.field_ = std::move(bundle);
+    field_bundle_.bins_ = efield.bins_;
+    field_bundle_.mapping_ = efield.mapping_;
+    field_bundle_.normalization_ = efield.normalization_;
+    field_bundle_.offset_ = efield.offset_;
+    field_bundle_.thickness_domain_ = efield.thickness_domain_;
+    field_bundle_.type_ = FieldType::GRID;
+    LOG(DEBUG) << "Interleaved electric field and doping profile of detector " << name_ << " on grid with "
+               << efield.bins_[0] << "x" << efield.bins_[1] << "x" << efield.bins_[2] << " bins";
 }
 
 void Detector::check_field_match(std::array<double, 3> size,
@@ -260,3 +316,12 @@ void Detector::check_field_match(std::array<double, 3> size,
                   << Units::display(model_->getPixelSize().y(), {"um", "mm"}) << ")";
     }
 }
+
+size_t Detector::replicate_fields(size_t replicas, bool huge_pages) {
+    auto mapped = electric_field_.replicate(replicas, huge_pages) + weighting_potential_.replicate(replicas, huge_pages) +
+                  doping_profile_.replicate(replicas, huge_pages) + field_bundle_.replicate(replicas, huge_pages);
+    if(mapped > 0) {
+        LOG(DEBUG) << "Replicated field grids of detector " << name_ << " to " << replicas << " NUMA nodes";
+    }
+    return mapped;
+}
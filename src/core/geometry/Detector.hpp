@@ -40,6 +40,7 @@ namespace allpix {
      */
     class Detector {
         friend class GeometryManager;
+        friend class ModuleManager;
 
     public:
         /**
@@ -189,6 +190,22 @@ namespace allpix {
          */
         void setDopingProfileFunction(FieldFunction<double> function, FieldType type = FieldType::CUSTOM);
 
+        /**
+         * @brief Returns if the electric field and the doping profile are stored interleaved for combined lookups
+         * @return True if both are grids with identical binning and mapping, false otherwise
+         */
+        bool hasFieldBundle() const { return field_bundle_.isValid(); }
+        /**
+         * @brief Get the electric field and the doping concentration in the sensor at a local position
+         * @param local_pos Position in the local frame
+         * @return Vector of the electric field and value of the doping concentration at the queried point
+         *
+         * If the electric field and the doping profile are grids sharing the same binning and mapping, both are obtained
+         * from a single index computation and memory access. Otherwise, this is equivalent to calling
+         * \ref getElectricField and \ref getDopingConcentration separately.
+         */
+        std::pair<ROOT::Math::XYZVector, double> getElectricFieldAndDoping(const ROOT::Math::XYZPoint& local_pos) const;
+
         /**
          * @brief Returns if the detector has a weighting potential in the sensor
          * @return True if the detector has a weighting potential, false otherwise
@@ -292,6 +309,19 @@ namespace allpix {
                                std::array<double, 2> field_scale,
                                std::pair<double, double> thickness_domain) const;
 
+        /**
+         * @brief Interleave the electric field and doping profile grids if they share the same binning and mapping
+         */
+        void build_field_bundle();
+
+        /**
+         * @brief Replicate all field grids of the detector to the memory of the NUMA nodes
+         * @param replicas Number of replicas, one per node
+         * @param huge_pages Back the replicas with huge pages
+         * @return Memory mapped for the replicas in bytes
+         */
+        size_t replicate_fields(size_t replicas, bool huge_pages);
+
         std::string name_;
         std::shared_ptr<DetectorModel> model_;
 
@@ -313,6 +343,9 @@ namespace allpix {
 
         // Doping profile properties
         DetectorField<double, 1> doping_profile_;
+
+        // Electric field and doping profile interleaved per grid point
+        DetectorField<FieldBundle, 4> field_bundle_;
     };
 
 } // namespace allpix
@@ -14,6 +14,7 @@
 
 #include <array>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include <Math/Point2D.h>
@@ -22,6 +23,7 @@
 #include <Math/Vector3D.h>
 
 #include "DetectorModel.hpp"
+#include "core/utils/numa.h"
 #include "objects/Pixel.hpp"
 #include "tools/ROOT.h"
 
@@ -88,6 +90,20 @@ namespace allpix {
      */
     template <> inline void flip_vector_components<double>(double&, bool, bool) {}
 
+    /**
+     * @brief Electric field vector and doping concentration stored interleaved for a single grid point
+     */
+    using FieldBundle = std::array<double, 4>;
+
+    /*
+     * Field bundle template specialization of helper function for field flipping
+     * Only the x and y components of the electric field are inverted, the doping concentration is a scalar
+     */
+    template <> inline void flip_vector_components<FieldBundle>(FieldBundle& values, bool x, bool y) {
+        values[0] = (x ? -values[0] : values[0]);
+        values[1] = (y ? -values[1] : values[1]);
+    }
+
     /**
      * @brief Field instance of a detector
      *
@@ -169,6 +185,14 @@ namespace allpix {
          */
         void set_model(const std::shared_ptr<DetectorModel>& model) { model_ = model; }
 
+        /**
+         * @brief Replicate the field grid to the memory of the NUMA nodes
+         * @param replicas Number of replicas, one per node
+         * @param huge_pages Back the replicas with huge pages
+         * @return Memory mapped for the replicas in bytes, zero if the field is not defined on a grid
+         */
+        size_t replicate(size_t replicas, bool huge_pages);
+
         /**
          * @brief Helper function to retrieve the return type from a calculated index of the field data vector
          * @param offset The calculated global index to start from
@@ -218,8 +242,11 @@ namespace allpix {
          * component in the flat field vector can be calculated as:
          *
          *   field_i(x, y, z) =  x * Y_SIZE* Z_SIZE * N + y * Z_SIZE * + z * N + i
+         *
+         * If replicated, the grid is read from the copy in the memory of the NUMA node of the calling thread.
          */
         std::shared_ptr<std::vector<double>> field_;
+        std::shared_ptr<ReplicatedArray> replicas_;
         std::pair<double, double> thickness_domain_{};
         FieldType type_{FieldType::NONE};
         FieldFunction<T> function_;
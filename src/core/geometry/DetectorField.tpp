@@ -207,6 +207,10 @@ namespace allpix {
     template <typename T, size_t N>
     template <std::size_t... I>
     auto DetectorField<T, N>::get_impl(size_t offset, std::index_sequence<I...>) const noexcept {
+        if(replicas_) {
+            const auto* data = replicas_->data();
+            return T{data[offset + I]...};
+        }
         return T{(*field_)[offset + I]...};
     }
 
@@ -236,6 +240,7 @@ namespace allpix {
         }
 
         field_ = std::move(field);
+        replicas_.reset();
         bins_ = bins;
         mapping_ = mapping;
 
@@ -249,6 +254,14 @@ namespace allpix {
         type_ = FieldType::GRID;
     }
 
+    template <typename T, size_t N> size_t DetectorField<T, N>::replicate(size_t replicas, bool huge_pages) {
+        if(type_ != FieldType::GRID || field_ == nullptr) {
+            return 0;
+        }
+        replicas_ = std::make_shared<ReplicatedArray>(*field_, replicas, huge_pages);
+        return replicas_->getMappedSize();
+    }
+
     template <typename T, size_t N>
     void
     DetectorField<T, N>::setFunction(FieldFunction<T> function, std::pair<double, double> thickness_domain, FieldType type) {
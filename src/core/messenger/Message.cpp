@@ -31,3 +31,5 @@ BaseMessage::~BaseMessage() = default;
 std::vector<std::reference_wrapper<Object>> BaseMessage::getObjectArray() {
     throw MessageWithoutObjectException(typeid(*this));
 }
+
+size_t BaseMessage::getMemorySize() const { return sizeof(*this); }
@@ -54,6 +54,12 @@ namespace allpix {
          */
         virtual std::vector<std::reference_wrapper<Object>> getObjectArray();
 
+        /**
+         * @brief Get the approximate memory retained by this message
+         * @return Size of the message and its contents in bytes
+         */
+        virtual size_t getMemorySize() const;
+
     protected:
         /**
          * @brief Construct a general message not linked to a detector
@@ -104,6 +110,12 @@ namespace allpix {
          */
         std::vector<std::reference_wrapper<Object>> getObjectArray() override;
 
+        /**
+         * @brief Get the approximate memory retained by this message, including memory allocated by the objects
+         * @return Size of the message and its contents in bytes
+         */
+        size_t getMemorySize() const override;
+
     private:
         /**
          * @brief Returns object array for messages containing objects
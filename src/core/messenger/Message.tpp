@@ -28,6 +28,16 @@ namespace allpix {
     template <typename T> std::vector<std::reference_wrapper<Object>> Message<T>::getObjectArray() {
         return get_object_array();
     }
+    template <typename T> size_t Message<T>::getMemorySize() const {
+        size_t size = sizeof(*this) + data_.capacity() * sizeof(T);
+        if constexpr(std::is_base_of<Object, T>::value) {
+            for(const auto& object : data_) {
+                size += object.getDynamicMemorySize();
+            }
+        }
+        return size;
+    }
+
     /**
      * Pass the data as a copy of the internal vector referencing the same data as the internal vector
      *
@@ -11,6 +11,7 @@
 
 #include "Messenger.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -88,6 +89,34 @@ bool Messenger::isSatisfied(BaseDelegate* delegate, Event* event) const {
     return local_messenger->isSatisfied(delegate);
 }
 
+/**
+ * Messages are dispatched under the output name of the source, which is matched against the name each delegate of the
+ * receiver is registered for. Detector delegates only receive messages of their own detector, which detector modules for
+ * another detector cannot provide. The message types a module dispatches are not known in advance, all of them are therefore
+ * considered possible.
+ */
+bool Messenger::canReceive(Module* source, Module* receiver) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(source == receiver) {
+        return false;
+    }
+
+    auto output = source->get_configuration().get<std::string>("output");
+    auto source_detector = source->getDetector();
+    return std::any_of(receiver->delegates_.cbegin(), receiver->delegates_.cend(), [&](const auto& delegate) {
+        auto iter = delegate_to_iterator_.find(delegate.second);
+        if(iter == delegate_to_iterator_.end()) {
+            return false;
+        }
+        const auto& name = std::get<1>(iter->second);
+        if(name != "*" && name != output && !(name == "?" && output.empty())) {
+            return false;
+        }
+        auto detector = delegate.second->getDetector();
+        return detector == nullptr || source_detector == nullptr || detector->getName() == source_detector->getName();
+    });
+}
+
 void Messenger::add_delegate(const std::type_info& message_type,
                              Module* module,
                              const std::shared_ptr<BaseDelegate>& delegate) {
@@ -147,6 +176,8 @@ void LocalMessenger::dispatchMessage(Module* source, std::shared_ptr<BaseMessage
     }
 
     bool send = false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    message_positions_.emplace(message.get(), source->position_);
 
     // Send messages to specific listeners
     send = dispatchMessage(source, message, name, name) || send;
@@ -223,10 +254,24 @@ bool LocalMessenger::dispatchMessage(Module* source,
 
 std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> LocalMessenger::fetchFilteredMessages(Module* module) {
     const std::type_index type_idx = typeid(BaseMessage);
-    return messages_.at(module->getUniqueName()).at(type_idx).filter_multi;
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto messages = messages_.at(module->getUniqueName()).at(type_idx).filter_multi;
+    sort_messages(messages);
+    return messages;
+}
+
+size_t LocalMessenger::getMemorySize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t size = 0;
+    for(const auto& message : sent_messages_) {
+        size += message->getMemorySize();
+    }
+    return size;
 }
 
 bool LocalMessenger::isSatisfied(BaseDelegate* delegate) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     // check our records for messages for this module
     const std::string name = delegate->getUniqueName();
     auto messages_iter = messages_.find(name);
@@ -12,8 +12,10 @@
 #ifndef ALLPIX_MESSENGER_H
 #define ALLPIX_MESSENGER_H
 
+#include <algorithm>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
@@ -157,6 +159,14 @@ namespace allpix {
          */
         bool isSatisfied(BaseDelegate* delegate, Event* event) const;
 
+        /**
+         * @brief Check if a module can receive messages dispatched by another module
+         * @param source Module dispatching the messages
+         * @param receiver Module to check the delegates of
+         * @return True if any delegate of the receiver might accept messages from the source, false otherwise
+         */
+        bool canReceive(Module* source, Module* receiver) const;
+
     private:
         /**
          * @brief Add a delegate to the listeners
@@ -195,6 +205,10 @@ namespace allpix {
         explicit LocalMessenger(Messenger& global_messenger);
 
         void dispatchMessage(Module* source, std::shared_ptr<BaseMessage> message, std::string name);
+        /**
+         * @brief Dispatch a message to the listeners registered with the given identifier
+         * @warning The mutex of the local messenger has to be held by the caller
+         */
         bool dispatchMessage(Module* source,
                              const std::shared_ptr<BaseMessage>& message,
                              const std::string& name,
@@ -224,12 +238,30 @@ namespace allpix {
          */
         std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> fetchFilteredMessages(Module* module);
 
+        /**
+         * @brief Get the approximate memory retained by all messages dispatched in this event
+         * @return Size of the messages and their contents in bytes
+         */
+        size_t getMemorySize() const;
+
     private:
         // The global messenger which contains the shared delegate information
         const Messenger& global_messenger_;
 
         std::unordered_map<std::string, std::unordered_map<std::type_index, DelegateTypes>> messages_;
         std::vector<std::shared_ptr<BaseMessage>> sent_messages_;
+
+        /**
+         * @brief Sort messages by the position of the module which dispatched them
+         * @param messages List of messages or pairs of messages and names to sort
+         */
+        template <typename T> void sort_messages(std::vector<T>& messages) const;
+
+        // Position of the dispatching module for every message
+        std::unordered_map<const BaseMessage*, size_t> message_positions_;
+
+        // Modules of an event might be executed concurrently
+        mutable std::mutex mutex_;
     };
 } // namespace allpix
 
@@ -73,6 +73,7 @@ namespace allpix {
     template <typename T> std::shared_ptr<T> LocalMessenger::fetchMessage(Module* module) {
         static_assert(std::is_base_of<BaseMessage, T>::value, "Fetched message should inherit from Message class");
         std::type_index type_idx = typeid(T);
+        std::lock_guard<std::mutex> lock(mutex_);
         return std::static_pointer_cast<T>(messages_.at(module->getUniqueName()).at(type_idx).single);
     }
 
@@ -83,7 +84,10 @@ namespace allpix {
         std::type_index type_idx = typeid(T);
 
         // Construct an empty vector in case no previous modules created one during dispatch
+        std::unique_lock<std::mutex> lock(mutex_);
         auto base_messages = messages_.at(module->getUniqueName()).at(type_idx).multi;
+        sort_messages(base_messages);
+        lock.unlock();
 
         std::vector<std::shared_ptr<T>> derived_messages;
         derived_messages.reserve(base_messages.size());
@@ -94,4 +98,25 @@ namespace allpix {
         return derived_messages;
     }
 
+    /**
+     * Messages from modules executed concurrently might be received in any order, sorting them by the position of the
+     * dispatching module restores the order of sequential execution
+     */
+    template <typename T> void LocalMessenger::sort_messages(std::vector<T>& messages) const {
+        auto position = [this](const auto& message) {
+            const BaseMessage* inst = nullptr;
+            if constexpr(std::is_same_v<T, std::shared_ptr<BaseMessage>>) {
+                inst = message.get();
+            } else {
+                inst = message.first.get();
+            }
+            auto iter = message_positions_.find(inst);
+            return (iter != message_positions_.end() ? iter->second : size_t(0));
+        };
+        auto compare = [&position](const auto& lhs, const auto& rhs) { return position(lhs) < position(rhs); };
+        if(!std::is_sorted(messages.begin(), messages.end(), compare)) {
+            std::stable_sort(messages.begin(), messages.end(), compare);
+        }
+    }
+
 } // namespace allpix
@@ -15,6 +15,7 @@
 #include <chrono>
 #include <list>
 #include <memory>
+#include <random>
 #include <string>
 
 #include "Module.hpp"
@@ -26,22 +27,167 @@ using namespace allpix;
 
 std::mutex Event::stats_mutex_;
 
+size_t Event::arena_size_ = 0;
+size_t Event::arena_max_buffers_ = 0;
+std::vector<std::unique_ptr<std::byte[]>> Event::arena_buffers_;
+std::mutex Event::arena_mutex_;
+std::atomic<uint64_t> Event::arena_events_{0};
+std::atomic<uint64_t> Event::arena_buffers_allocated_{0};
+std::atomic<uint64_t> Event::arena_buffers_released_{0};
+
+namespace {
+    /**
+     * @brief Upstream resource of the event arenas counting the allocations which do not fit into their initial buffer
+     */
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override {
+            allocations++;
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+        void do_deallocate(void* ptr, size_t size, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    CountingResource& arena_upstream() {
+        static CountingResource resource;
+        return resource;
+    }
+} // namespace
+
+thread_local Event::ModuleRandom* Event::module_random_ = nullptr;
+
 Event::Event(Messenger& messenger, uint64_t event_num, uint64_t seed) : number(event_num), seed_(seed) {
     local_messenger_ = std::make_unique<LocalMessenger>(messenger);
 }
 
+Event::~Event() {
+    // Release all messages before the arena they might hold memory from
+    local_messenger_.reset();
+    synchronized_arena_.reset();
+    arena_.reset();
+
+    // Return the initial buffer of the arena for reuse by later events. Buffers above the high-water mark were only needed
+    // while many events were alive at the same time, e.g. while buffered, and are released
+    if(arena_buffer_ != nullptr) {
+        std::lock_guard<std::mutex> lock{arena_mutex_};
+        if(arena_buffers_.size() < arena_max_buffers_) {
+            arena_buffers_.push_back(std::move(arena_buffer_));
+        } else {
+            arena_buffers_released_++;
+        }
+    }
+}
+
+/**
+ * Concurrently executed modules share the arena, their allocations are therefore serialized
+ */
+std::pmr::memory_resource* Event::getMemoryResource() {
+    if(concurrent_modules_) {
+        std::lock_guard<std::mutex> lock{resource_mutex_};
+        if(synchronized_arena_ == nullptr) {
+            synchronized_arena_ = std::make_unique<SynchronizedResource>(get_arena());
+        }
+        return synchronized_arena_.get();
+    }
+    return get_arena();
+}
+
+std::pmr::memory_resource* Event::get_arena() {
+    if(arena_ == nullptr) {
+        arena_events_++;
+        if(arena_size_ == 0) {
+            arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(&arena_upstream());
+        } else {
+            // Reuse a buffer from a previous event if available
+            {
+                std::lock_guard<std::mutex> lock{arena_mutex_};
+                if(!arena_buffers_.empty()) {
+                    arena_buffer_ = std::move(arena_buffers_.back());
+                    arena_buffers_.pop_back();
+                }
+            }
+            if(arena_buffer_ == nullptr) {
+                arena_buffer_ = std::make_unique<std::byte[]>(arena_size_);
+                arena_buffers_allocated_++;
+            }
+            arena_ =
+                std::make_unique<std::pmr::monotonic_buffer_resource>(arena_buffer_.get(), arena_size_, &arena_upstream());
+        }
+    }
+    return arena_.get();
+}
+
+Event::ArenaStatistics Event::get_arena_statistics() {
+    ArenaStatistics statistics;
+    statistics.events = arena_events_.load();
+    statistics.buffers = arena_buffers_allocated_.load();
+    statistics.released = arena_buffers_released_.load();
+    statistics.overflows = arena_upstream().allocations.load();
+    statistics.overflow_bytes = arena_upstream().bytes.load();
+    return statistics;
+}
+
 void Event::set_and_seed_random_engine(RandomNumberGenerator* random_engine) {
     random_engine_ = random_engine;
     random_engine_->seed(seed_);
 }
 
 RandomNumberGenerator& Event::getRandomEngine() {
+    if(module_random_ != nullptr) {
+        return module_random_->engine;
+    }
     if(random_engine_ == nullptr) {
         throw InvalidEventStateException("No PRNG available");
     }
     return *random_engine_;
 }
 
+RandomNumberPool& Event::getRandomPool() {
+    if(module_random_ != nullptr) {
+        if(module_random_->pool == nullptr) {
+            module_random_->pool = std::make_unique<RandomNumberPool>(getRandomNumber());
+        }
+        return *module_random_->pool;
+    }
+    if(random_pool_ == nullptr) {
+        random_pool_ = std::make_unique<RandomNumberPool>(getRandomNumber());
+    }
+    return *random_pool_;
+}
+
+/**
+ * The seed of the module engine is derived from the event seed and the module position, such that the random numbers do not
+ * depend on the order in which concurrent modules are executed
+ */
+void Event::set_module_random(ModuleRandom* random, size_t position) {
+    module_random_ = random;
+    if(random != nullptr) {
+        std::seed_seq seed_sequence{static_cast<uint32_t>(seed_ & 0xffffffff),
+                                    static_cast<uint32_t>(seed_ >> 32),
+                                    static_cast<uint32_t>(position)};
+        random->engine.seed(seed_sequence);
+        random->pool.reset();
+    }
+}
+
+void* Event::SynchronizedResource::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return upstream_->allocate(bytes, alignment);
+}
+
+void Event::SynchronizedResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    upstream_->deallocate(ptr, bytes, alignment);
+}
+
 void Event::store_random_engine_state() {
     if(random_engine_ != nullptr && state_.rdbuf()->in_avail() == 0) {
         LOG(PRNG) << "Storing PRNG state in event";
@@ -58,3 +204,7 @@ void Event::restore_random_engine_state() {
 }
 
 LocalMessenger* Event::get_local_messenger() const { return local_messenger_.get(); }
+
+size_t Event::get_memory_size() const {
+    return local_messenger_->getMemorySize() + (arena_buffer_ != nullptr ? arena_size_ : 0);
+}
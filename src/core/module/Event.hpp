@@ -17,10 +17,12 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <vector>
 
 #include "core/utils/prng.h"
+#include "core/utils/random_pool.h"
 
 namespace allpix {
     class Module;
@@ -45,9 +47,9 @@ namespace allpix {
          */
         explicit Event(Messenger& messenger, uint64_t event_num, uint64_t seed);
         /**
-         * @brief Use default destructor
+         * @brief Destructor returning the memory arena buffer for reuse by later events
          */
-        ~Event() = default;
+        ~Event();
 
         /// @{
         /**
@@ -65,6 +67,8 @@ namespace allpix {
         /**
          * @brief Access the random engine of this event
          * @return Reference to this event's random engine
+         *
+         * If the modules of the event are executed concurrently, every module is provided with its own random engine
          */
         RandomNumberGenerator& getRandomEngine();
 
@@ -74,6 +78,26 @@ namespace allpix {
          */
         uint64_t getRandomNumber() { return getRandomEngine()(); }
 
+        /**
+         * @brief Access the pool of pre-generated random numbers of this event
+         * @return Reference to this event's random number pool
+         *
+         * The pool is created when first requested and seeded from the random engine of this event. Drawing from the pool
+         * is considerably faster than using distributions on the random engine directly, and large batches of numbers can
+         * be obtained at once.
+         */
+        RandomNumberPool& getRandomPool();
+
+        /**
+         * @brief Access the memory arena of this event
+         * @return Pointer to the memory resource of this event
+         *
+         * The arena is a monotonic buffer which only releases its memory at the end of the event. It should be used for
+         * short-lived containers with many small allocations, e.g. via the `std::pmr` containers. Objects allocated from the
+         * arena must not outlive the event.
+         */
+        std::pmr::memory_resource* getMemoryResource();
+
         /**
          * @brief Returns the current seed for the ranom number generator
          * @return The random seed of the current event
@@ -81,6 +105,49 @@ namespace allpix {
         uint64_t getSeed() const { return seed_; }
 
     private:
+        /**
+         * @brief Random engine and pool of a module executed concurrently with other modules of the same event
+         */
+        struct ModuleRandom {
+            RandomNumberGenerator engine;
+            std::unique_ptr<RandomNumberPool> pool;
+        };
+
+        /**
+         * @brief Use a separate random engine for the module executed on the current thread
+         * @param random Random engine of the module, or nullptr to use the random engine of the event again
+         * @param position Position of the module, used to derive the seed of its random engine from the event seed
+         */
+        void set_module_random(ModuleRandom* random, size_t position);
+        static thread_local ModuleRandom* module_random_;
+
+        /**
+         * @brief Memory resource serializing the allocations from the arena of modules executed concurrently
+         */
+        class SynchronizedResource : public std::pmr::memory_resource {
+        public:
+            explicit SynchronizedResource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+            std::pmr::memory_resource* upstream_;
+            std::mutex mutex_;
+        };
+
+        /**
+         * @brief Get the memory arena of this event, creating it if necessary
+         * @return Pointer to the memory arena
+         */
+        std::pmr::memory_resource* get_arena();
+
+        // Flag if modules of this event are executed concurrently
+        bool concurrent_modules_{false};
+        std::mutex resource_mutex_;
+        std::unique_ptr<SynchronizedResource> synchronized_arena_;
+
         /**
          * @brief Sets the random engine and seed it to be used by this event
          * @param random_engine Pointer to RNG for this event
@@ -106,11 +173,68 @@ namespace allpix {
         // State of the random number generator
         std::stringstream state_;
 
+        // Pool of random numbers, seeded from the random number generator on first use
+        std::unique_ptr<RandomNumberPool> random_pool_;
+
+        /**
+         * @brief Set the size of the initial buffer of the memory arena of all events
+         * @param size Size of the buffer in bytes, zero disables recycling of buffers
+         * @param max_buffers Maximum number of buffers kept for reuse, buffers returned above this mark are released
+         */
+        static void set_arena_size(size_t size, size_t max_buffers) {
+            arena_size_ = size;
+            arena_max_buffers_ = max_buffers;
+        }
+
+        // Memory arena for this event with its initial buffer, recycled between events
+        std::unique_ptr<std::byte[]> arena_buffer_;
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+
+        // Buffers of finished events available for reuse
+        static size_t arena_size_;
+        static size_t arena_max_buffers_;
+        static std::vector<std::unique_ptr<std::byte[]>> arena_buffers_;
+        static std::mutex arena_mutex_;
+
+        /**
+         * @brief Usage of the memory arenas accumulated over all events
+         */
+        struct ArenaStatistics {
+            // Number of events which made use of their arena
+            uint64_t events{};
+            // Number of initial buffers allocated because no recycled buffer was available
+            uint64_t buffers{};
+            // Number of buffers released instead of being kept for reuse
+            uint64_t released{};
+            // Number and total size of allocations exceeding the initial buffer, served by the system allocator
+            uint64_t overflows{};
+            uint64_t overflow_bytes{};
+        };
+
+        /**
+         * @brief Get the usage statistics of the memory arenas of all events
+         * @return Accumulated statistics of the memory arenas
+         */
+        static ArenaStatistics get_arena_statistics();
+
+        static std::atomic<uint64_t> arena_events_;
+        static std::atomic<uint64_t> arena_buffers_allocated_;
+        static std::atomic<uint64_t> arena_buffers_released_;
+
         /**
          * @brief Returns a pointer to the event local messenger
          */
         LocalMessenger* get_local_messenger() const;
 
+        /**
+         * @brief Get the approximate memory retained by this event
+         * @return Size of the messages and the memory arena of the event in bytes
+         */
+        size_t get_memory_size() const;
+
+        // Memory accounted for this event while it is buffered
+        size_t buffered_memory_{0};
+
         // Local messenger used to dispatch messages in this event
         std::unique_ptr<LocalMessenger> local_messenger_;
 
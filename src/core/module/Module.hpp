@@ -240,6 +240,9 @@ namespace allpix {
 
         std::shared_ptr<Detector> detector_;
 
+        // Position of the module in the execution order
+        size_t position_{0};
+
         /**
          * @brief Sets the multithreading flag
          */
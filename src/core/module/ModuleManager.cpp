@@ -13,17 +13,20 @@
 #include "Event.hpp"
 
 #include <dlfcn.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <filesystem>
+#include <functional>
 #include <fstream>
 #include <limits>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include <TROOT.h>
 #include <TSystem.h>
@@ -34,6 +37,7 @@
 #include "core/geometry/GeometryManager.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/utils/log.h"
+#include "core/utils/numa.h"
 
 // Common prefix for all modules
 // TODO [doc] Should be provided by the build system
@@ -52,14 +56,20 @@ ModuleManager::ModuleManager() : terminate_(false) {}
  * automatically. After that the required modules are created from the configuration.
  */
 void ModuleManager::load(Messenger* messenger, ConfigManager* conf_manager, GeometryManager* geo_manager) {
-    // Store config manager and get configurations
+    // Store config and geometry manager and get configurations
     conf_manager_ = conf_manager;
+    geo_manager_ = geo_manager;
     auto& configs = conf_manager_->getModuleConfigurations();
     Configuration& global_config = conf_manager_->getGlobalConfiguration();
 
     // Set alias for backward compatibility with the previous keyword for multithreading
     global_config.setDefault("multithreading", true);
     multithreading_flag_ = global_config.get<bool>("multithreading");
+    global_config.setDefault("sequencer", false);
+    global_config.setDefault("module_graph", false);
+    global_config.setDefault("pin_workers", false);
+    global_config.setDefault("field_replicas", false);
+    global_config.setDefault("huge_pages", false);
 
     // Set default for performance plot creation:
     global_config.setDefault("performance_plots", false);
@@ -588,6 +598,12 @@ void ModuleManager::initialize() {
             throw InvalidValueError(global_config, "buffer_per_worker", "buffer per worker should be larger than one");
         }
         LOG(STATUS) << "Allocating a total of " << max_buffer_size_ << " event slots for buffered modules";
+
+        // Limit the memory retained by buffered events, zero disables the limit
+        max_buffer_memory_ = global_config.get<size_t>("buffer_memory", 0);
+        if(max_buffer_memory_ > 0) {
+            LOG(STATUS) << "Limiting the memory retained by buffered events to " << max_buffer_memory_ << " bytes";
+        }
     } else {
         // Issue a warning in case MT was requested but we can't actually run in MT
         if(multithreading_flag_ && !can_parallelize_) {
@@ -598,12 +614,67 @@ void ModuleManager::initialize() {
         }
     }
 
+    // Size of the memory arena buffer of each event, recycled between events. Only as many buffers are kept as events are
+    // processed at the same time by the workers and the main thread
+    Event::set_arena_size(global_config.get<size_t>("event_arena_size", 65536), number_of_threads_ + 1);
+
     // Store final number of threads to the config for later reference
     global_config.set<size_t>("workers", number_of_threads_, true);
 
+    // Group consecutive modules requiring the event sequence into segments executed by the sequencer thread
+    if(number_of_threads_ > 0 && global_config.get<bool>("sequencer")) {
+        bool in_segment = false;
+        for(auto& module : modules_) {
+            if(module->require_sequence()) {
+                sequence_segments_[module.get()] = number_of_segments_;
+                in_segment = true;
+            } else if(in_segment) {
+                number_of_segments_++;
+                in_segment = false;
+            }
+        }
+        if(in_segment) {
+            number_of_segments_++;
+        }
+        if(number_of_segments_ > 0) {
+            LOG(STATUS) << "Executing " << number_of_segments_
+                        << " segments of modules requiring the event sequence on a dedicated sequencer thread";
+        }
+    }
+
+    // Derive the dependencies between the modules from their message bindings, to execute independent modules concurrently.
+    // Modules requiring the event sequence depend on all previous modules and all following modules depend on them.
+    size_t position = 0;
+    for(auto& module : modules_) {
+        module->position_ = position++;
+    }
+    if(number_of_threads_ > 0 && global_config.get<bool>("module_graph")) {
+        if(number_of_segments_ > 0) {
+            throw InvalidCombinationError(
+                global_config, {"sequencer", "module_graph"}, "the sequencer cannot be used with the module graph");
+        }
+
+        module_graph_.assign(modules_.begin(), modules_.end());
+        module_successors_.assign(module_graph_.size(), {});
+        module_dependencies_.assign(module_graph_.size(), 0);
+        size_t edges = 0;
+        for(size_t receiver = 0; receiver < module_graph_.size(); ++receiver) {
+            for(size_t source = 0; source < receiver; ++source) {
+                if(module_graph_[source]->require_sequence() || module_graph_[receiver]->require_sequence() ||
+                   messenger_->canReceive(module_graph_[source].get(), module_graph_[receiver].get())) {
+                    module_successors_[source].push_back(receiver);
+                    module_dependencies_[receiver]++;
+                    edges++;
+                }
+            }
+        }
+        LOG(STATUS) << "Executing " << module_graph_.size() << " module instantiations following a dependency graph with "
+                    << edges << " dependencies";
+    }
+
     // Initialize the thread pool with the number of threads
     if(number_of_threads_ > 0) {
-        ThreadPool::registerThreadCount(number_of_threads_);
+        ThreadPool::registerThreadCount(number_of_threads_ + (number_of_segments_ > 0 ? 1 : 0));
     }
 
     // Book global performance histograms
@@ -614,6 +685,9 @@ void ModuleManager::initialize() {
                                                    0,
                                                    static_cast<double>(max_buffer_size_));
         event_time_ = CreateHistogram<TH1D>("event_time", "processing time per event;time [s];# events", 1000, 0, 10);
+        auto max_memory = (max_buffer_memory_ > 0 ? static_cast<double>(max_buffer_memory_) / (1 << 20) : 1024.);
+        buffer_memory_ = CreateHistogram<TH1D>(
+            "buffer_memory", "Memory retained by buffered events;memory [MiB];# events", 1000, 0, max_memory);
     }
 
     auto start_time = std::chrono::steady_clock::now();
@@ -689,15 +763,42 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     Configuration& global_config = conf_manager_->getGlobalConfiguration();
     auto plot = global_config.get<bool>("performance_plots");
+    auto account_memory = (plot || max_buffer_memory_ > 0);
+
+    // Distribute the workers over the NUMA nodes and replicate the field grids to the memory of every node
+    const auto& topology = NumaTopology::get();
+    auto pin_workers = (number_of_threads_ > 0 && global_config.get<bool>("pin_workers"));
+    if(pin_workers) {
+        LOG(STATUS) << "Pinning " << number_of_threads_ << " workers to the CPUs of " << topology.getNodeCount()
+                    << " NUMA nodes";
+    }
+    auto field_replicas = global_config.get<bool>("field_replicas");
+    auto huge_pages = global_config.get<bool>("huge_pages");
+    size_t replicated_memory = 0;
+    if(field_replicas || huge_pages) {
+        auto replicas = (field_replicas ? topology.getNodeCount() : 1);
+        for(auto& detector : geo_manager_->getDetectors()) {
+            replicated_memory += detector->replicate_fields(replicas, huge_pages);
+        }
+        LOG(STATUS) << "Replicated field grids to " << replicas << " NUMA nodes, mapping "
+                    << static_cast<double>(replicated_memory) / (1 << 20) << " MiB"
+                    << (huge_pages ? " with huge pages" : "");
+    }
 
     // Creates the thread pool
     LOG(TRACE) << "Initializing thread pool with " << number_of_threads_ << " threads";
     auto initialize_function =
-        [log_level = Log::getReportingLevel(), log_format = Log::getFormat(), modules_list = modules_]() {
+        [log_level = Log::getReportingLevel(), log_format = Log::getFormat(), modules_list = modules_, pin_workers]() {
             // Initialize the threads to the same log level and format as the master setting
             Log::setReportingLevel(log_level);
             Log::setFormat(log_format);
 
+            // Pin the thread to a CPU, distributing the workers over the nodes in turn
+            if(pin_workers) {
+                auto node = NumaTopology::get().pinThread(ThreadPool::threadNum() - 1);
+                LOG(DEBUG) << "Pinned thread " << std::this_thread::get_id() << " to NUMA node " << node;
+            }
+
             // Call per-thread initialization of each module
             for(const auto& module : modules_list) {
                 // Set module specific log settings
@@ -729,8 +830,12 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     // Push 128 events for each worker to maintain enough work
     auto max_queue_size = number_of_threads_ * 128;
-    thread_pool_ = std::make_unique<ThreadPool>(
-        number_of_threads_, max_queue_size, max_buffer_size_, initialize_function, finalize_function);
+    thread_pool_ = std::make_unique<ThreadPool>(number_of_threads_,
+                                                max_queue_size,
+                                                max_buffer_size_,
+                                                static_cast<unsigned int>(number_of_segments_),
+                                                initialize_function,
+                                                finalize_function);
 
     // Record the run stage total time
     auto start_time = std::chrono::steady_clock::now();
@@ -738,11 +843,30 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
     // Push all events to the thread pool
     std::atomic<uint64_t> finished_events{0};
     std::atomic<uint64_t> aborted_events{0};
+    std::atomic<uint64_t> skipped_events{0};
+    uint64_t delayed_events = 0;
     global_config.setDefault<uint64_t>("number_of_events", 1u);
     auto number_of_events = global_config.get<uint64_t>("number_of_events");
 
     // Skip first N events and discard their event seed from the seeder engine:
     auto skip_events = global_config.get<uint64_t>("skip_events", 0);
+
+    // Restrict the run to the event range of this shard. Event numbers and seeds are identical to a single-process run
+    // since the seeds of all preceding events are discarded:
+    auto number_of_shards = global_config.get<uint64_t>("number_of_shards", 1);
+    if(number_of_shards > 1) {
+        auto shard_index = global_config.get<uint64_t>("shard_index");
+        if(shard_index >= number_of_shards) {
+            throw InvalidValueError(global_config, "shard_index", "shard index has to be smaller than number of shards");
+        }
+
+        auto first_event = number_of_events * shard_index / number_of_shards;
+        auto last_event = number_of_events * (shard_index + 1) / number_of_shards;
+        LOG(STATUS) << "Running shard " << shard_index << " of " << number_of_shards << " with events "
+                    << (skip_events + first_event + 1) << " to " << (skip_events + last_event);
+        skip_events += first_event;
+        number_of_events = last_event - first_event;
+    }
     seeder.discard(skip_events);
 
     // Mark the first N events as completed for the thread pool. Since events start at one, always mark zero identifier as
@@ -751,6 +875,150 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         thread_pool_->markComplete(n);
     }
 
+    // State of an event whose modules are executed following the dependency graph
+    struct GraphEvent {
+        GraphEvent(std::shared_ptr<Event> graph_event, const std::vector<size_t>& dependencies)
+            : event(std::move(graph_event)), pending(dependencies.size()), remaining(dependencies.size()) {
+            for(size_t i = 0; i < dependencies.size(); ++i) {
+                pending[i] = dependencies[i];
+            }
+        }
+        std::shared_ptr<Event> event;
+        std::vector<std::atomic_size_t> pending;
+        std::atomic_size_t remaining;
+        std::atomic_bool interrupted{false};
+        std::atomic_int64_t event_time{0};
+    };
+
+    // Execute a module of a graph event and continue with the modules depending on it. If several modules become ready, all
+    // but the first are submitted as urgent jobs to be picked up by other workers.
+    std::function<void(const std::shared_ptr<GraphEvent>&, size_t)> run_graph_module;
+    run_graph_module = [&](const std::shared_ptr<GraphEvent>& state, size_t index) {
+        const auto& event = state->event;
+        while(true) {
+            const auto& module = module_graph_[index];
+            if(!state->interrupted && module->check_delegates(this->messenger_, event.get())) {
+                auto start = std::chrono::steady_clock::now();
+                auto old_settings = ModuleManager::set_module_before(
+                    module->get_identifier().getUniqueName(), module->get_configuration(), "R:", event->number);
+
+                // Provide a random engine independent of the execution order of the modules
+                Event::ModuleRandom random;
+                event->set_module_random(&random, index);
+
+                bool stop = false;
+                bool abort = false;
+                bool skip = false;
+                try {
+                    if(module->require_sequence() && event->number != thread_pool_->minimumUncompleted()) {
+                        stop = true;
+                    } else {
+                        module->run(event.get());
+                    }
+                } catch(const MissingDependenciesException& e) {
+                    stop = true;
+                } catch(const SkipEventException& e) {
+                    LOG(DEBUG) << "Event skipped: " << e.what();
+                    skip = true;
+                } catch(const AbortEventException& e) {
+                    LOG(WARNING) << "Event aborted:" << std::endl << e.what();
+                    abort = true;
+                } catch(const EndOfRunException& e) {
+                    LOG(WARNING) << "Request to terminate:" << std::endl << e.what();
+                    this->terminate_ = true;
+                }
+
+                event->set_module_random(nullptr, 0);
+                ModuleManager::set_module_after(std::move(old_settings));
+
+                auto end = std::chrono::steady_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                this->module_execution_time_[module.get()] += duration;
+                if(plot) {
+                    std::lock_guard<std::mutex> stat_lock{event->stats_mutex_};
+                    state->event_time += duration;
+                    this->module_event_time_[module.get()]->Fill(
+                        std::chrono::duration<double>(std::chrono::nanoseconds(duration)).count());
+                }
+
+                // The remaining modules are not executed for aborted or skipped events
+                if((abort || skip) && !state->interrupted.exchange(true)) {
+                    (abort ? aborted_events : skipped_events)++;
+                }
+
+                if(stop) {
+                    LOG(DEBUG) << "Event " << event->number << " was interrupted in module "
+                               << module->get_identifier().getUniqueName() << ", rescheduling...";
+                    if(account_memory) {
+                        event->buffered_memory_ = event->get_memory_size();
+                        thread_pool_->bufferMemory(event->buffered_memory_);
+                    }
+                    auto module_function = [this, &run_graph_module, state, index]() {
+                        thread_pool_->releaseMemory(std::exchange(state->event->buffered_memory_, 0));
+                        run_graph_module(state, index);
+                    };
+                    auto future = thread_pool_->submit(event->number, module_function);
+                    assert(future.valid() || !thread_pool_->valid());
+                    return;
+                }
+            }
+
+            // Release the modules depending on this one
+            std::vector<size_t> ready;
+            for(auto successor : module_successors_[index]) {
+                if(--state->pending[successor] == 0) {
+                    ready.push_back(successor);
+                }
+            }
+            if(--state->remaining == 0) {
+                break;
+            }
+            if(ready.empty()) {
+                return;
+            }
+            for(size_t i = 1; i < ready.size(); ++i) {
+                thread_pool_->submitUrgent(
+                    [&run_graph_module, state, next = ready[i]]() { run_graph_module(state, next); });
+            }
+            index = ready.front();
+        }
+
+        // All modules finished, mark as complete
+        thread_pool_->markComplete(event->number);
+        NumaTopology::countEvent();
+        LOG(INFO) << "Finished event " << event->number << " with seed " << event->getSeed();
+
+        auto buffered_events = thread_pool_->bufferedQueueSize();
+        if(plot) {
+            this->buffer_fill_level_->Fill(static_cast<double>(buffered_events));
+            this->buffer_memory_->Fill(static_cast<double>(thread_pool_->bufferedMemory()) / (1 << 20));
+            event_time_->Fill(static_cast<double>(state->event_time) * 1e-9);
+        }
+
+        finished_events++;
+        LOG_PROGRESS(STATUS, "EVENT_LOOP") << "Buffered " << buffered_events << ", finished " << finished_events << " of "
+                                           << number_of_events << " events";
+    };
+
+    // Create a graph event and start executing the modules without dependencies
+    auto start_graph_event = [&](uint64_t event_num, uint64_t event_seed) {
+        auto event = std::make_shared<Event>(*this->messenger_, event_num, event_seed);
+        event->concurrent_modules_ = true;
+        LOG(INFO) << "Starting event " << event_num << " with seed " << event_seed;
+
+        auto state = std::make_shared<GraphEvent>(event, module_dependencies_);
+        std::vector<size_t> roots;
+        for(size_t index = 0; index < module_dependencies_.size(); ++index) {
+            if(module_dependencies_[index] == 0) {
+                roots.push_back(index);
+            }
+        }
+        for(size_t i = 1; i < roots.size(); ++i) {
+            thread_pool_->submitUrgent([&run_graph_module, state, next = roots[i]]() { run_graph_module(state, next); });
+        }
+        run_graph_module(state, roots.front());
+    };
+
     LOG(STATUS) << "Starting event loop";
     for(uint64_t i = 1 + skip_events; i <= number_of_events + skip_events; i++) {
         // Check if run was aborted and stop pushing extra events to the threadpool
@@ -763,13 +1031,33 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         // Get a new seed for the new event
         uint64_t seed = seeder();
 
+        // Execute the modules of the event following the dependency graph
+        if(!module_graph_.empty()) {
+            if(max_buffer_memory_ > 0 && thread_pool_->waitBufferedMemory(max_buffer_memory_)) {
+                delayed_events++;
+            }
+            auto future = thread_pool_->submit(start_graph_event, i, seed);
+            assert(future.valid() || !thread_pool_->valid());
+            thread_pool_->checkException();
+            continue;
+        }
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstrict-overflow"
         auto event_function_with_module =
-            [this, plot, number_of_events, event_num = i, event_seed = seed, &finished_events, &aborted_events](
+            [this,
+             plot,
+             account_memory,
+             number_of_events,
+             event_num = i,
+             event_seed = seed,
+             &finished_events,
+             &aborted_events,
+             &skipped_events](
                 std::shared_ptr<Event> event,
                 ModuleList::iterator module_iter,
                 int64_t event_time,
+                bool sequenced,
                 auto&& self_func) mutable -> void {
             // The RNG to be used by all events running on this thread
             static thread_local RandomNumberGenerator random_engine;
@@ -783,11 +1071,30 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 LOG(TRACE) << "Continue with earlier event, restoring random seed";
                 event->set_and_seed_random_engine(&random_engine);
                 event->restore_random_engine_state();
+                thread_pool_->releaseMemory(std::exchange(event->buffered_memory_, 0));
             }
 
             while(module_iter != modules_.end()) {
                 auto module = *module_iter;
 
+                // Hand segments of modules requiring the event sequence over to the sequencer and back after the segment
+                if(number_of_segments_ > 0 && module->require_sequence() != sequenced) {
+                    event->store_random_engine_state();
+                    if(account_memory) {
+                        event->buffered_memory_ = event->get_memory_size();
+                        thread_pool_->bufferMemory(event->buffered_memory_);
+                    }
+                    auto event_function = std::bind(self_func, event, module_iter, event_time, !sequenced, self_func);
+                    if(sequenced) {
+                        auto future = thread_pool_->submit(event_function);
+                        assert(future.valid() || !thread_pool_->valid());
+                    } else {
+                        LOG(TRACE) << "Passing event " << event->number << " to the sequencer";
+                        thread_pool_->submitSequenced(sequence_segments_.at(module.get()), event->number, event_function);
+                    }
+                    return;
+                }
+
                 LOG_PROGRESS(TRACE, "EVENT_LOOP")
                     << "Running event " << event->number << " [" << module->get_identifier().getUniqueName() << "]";
 
@@ -809,14 +1116,18 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 // Run module
                 bool stop = false;
                 bool abort = false;
+                bool skip = false;
                 try {
-                    if(module->require_sequence() && event_num != thread_pool_->minimumUncompleted()) {
+                    if(module->require_sequence() && !sequenced && event_num != thread_pool_->minimumUncompleted()) {
                         stop = true;
                     } else {
                         module->run(event.get());
                     }
                 } catch(const MissingDependenciesException& e) {
                     stop = true;
+                } catch(const SkipEventException& e) {
+                    LOG(DEBUG) << "Event skipped: " << e.what();
+                    skip = true;
                 } catch(const AbortEventException& e) {
                     LOG(WARNING) << "Event aborted:" << std::endl << e.what();
                     abort = true;
@@ -848,15 +1159,30 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                     break;
                 }
 
+                if(skip) {
+                    // Break module execution loop, the remaining modules are not executed for this event:
+                    skipped_events++;
+                    break;
+                }
+
                 if(stop) {
                     LOG(DEBUG) << "Event " << event->number
                                << " was interrupted because of missing dependencies, rescheduling...";
                     // Store state of PRNG engine:
                     event->store_random_engine_state();
+                    // Account for the memory retained while buffered:
+                    if(account_memory) {
+                        event->buffered_memory_ = event->get_memory_size();
+                        thread_pool_->bufferMemory(event->buffered_memory_);
+                    }
                     // Reschedule the event:
-                    auto event_function = std::bind(self_func, event, module_iter, event_time, self_func);
-                    auto future = thread_pool_->submit(event->number, event_function, false);
-                    assert(future.valid() || !thread_pool_->valid());
+                    auto event_function = std::bind(self_func, event, module_iter, event_time, sequenced, self_func);
+                    if(sequenced) {
+                        thread_pool_->submitSequenced(sequence_segments_.at(module.get()), event->number, event_function);
+                    } else {
+                        auto future = thread_pool_->submit(event->number, event_function, false);
+                        assert(future.valid() || !thread_pool_->valid());
+                    }
                     auto buffered_events = thread_pool_->bufferedQueueSize();
                     LOG_PROGRESS(STATUS, "EVENT_LOOP") << "Buffered " << buffered_events << ", finished " << finished_events
                                                        << " of " << number_of_events << " events";
@@ -869,11 +1195,13 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
             // All modules finished, mark as complete
             thread_pool_->markComplete(event->number);
+            NumaTopology::countEvent();
             LOG(INFO) << "Finished event " << event_num << " with seed " << event_seed;
 
             auto buffered_events = thread_pool_->bufferedQueueSize();
             if(plot) {
                 this->buffer_fill_level_->Fill(static_cast<double>(buffered_events));
+                this->buffer_memory_->Fill(static_cast<double>(thread_pool_->bufferedMemory()) / (1 << 20));
                 event_time_->Fill(static_cast<double>(event_time) * 1e-9);
             }
 
@@ -883,7 +1211,17 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         };
 
         auto event_function =
-            std::bind(event_function_with_module, nullptr, modules_.begin(), 0, event_function_with_module);
+            std::bind(event_function_with_module, nullptr, modules_.begin(), 0, false, event_function_with_module);
+
+        // Limit the number of events waiting in the reorder buffer of the sequencer
+        if(number_of_segments_ > 0) {
+            thread_pool_->waitSequenceBuffer(max_buffer_size_);
+        }
+
+        // Throttle the submission of new events while the buffered events exceed the memory budget
+        if(max_buffer_memory_ > 0 && thread_pool_->waitBufferedMemory(max_buffer_memory_)) {
+            delayed_events++;
+        }
 
         auto future = thread_pool_->submit(event_function);
         assert(future.valid() || !thread_pool_->valid());
@@ -904,12 +1242,28 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
     if(aborted_events > 0) {
         LOG(WARNING) << "Aborted " << aborted_events << " events in this run";
     }
+    if(skipped_events > 0) {
+        LOG(STATUS) << "Skipped " << skipped_events << " events in this run on request of modules";
+    }
+    if(delayed_events > 0) {
+        LOG(STATUS) << "Delayed the submission of " << delayed_events
+                    << " events while the buffered events exceeded the memory budget";
+    }
 
     auto end_time = std::chrono::steady_clock::now();
     run_time_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
 
     LOG(TRACE) << "Destroying thread pool";
     thread_pool_.reset();
+
+    // Report the throughput of events per node
+    if(pin_workers || replicated_memory > 0) {
+        for(size_t node = 0; node < topology.getNodeCount(); ++node) {
+            auto events = NumaTopology::getEvents(node);
+            LOG(STATUS) << "NUMA node " << node << " processed " << events << " events at "
+                        << std::round(static_cast<double>(events) / Units::convert(run_time_, "s")) << " events/s";
+        }
+    }
 }
 
 static std::string nanoseconds_to_time(uint64_t nanoseconds) {
@@ -975,6 +1329,7 @@ void ModuleManager::finalize() {
 
         event_time_->Write();
         buffer_fill_level_->Write();
+        buffer_memory_->Write();
 
         for(auto& module : modules_) {
             const auto& module_name = module->get_configuration().getName();
@@ -1058,6 +1413,27 @@ void ModuleManager::finalize() {
         LOG(STATUS) << "This corresponds to a processing time of \x1B[1m"
                     << Units::display(event_processing_time, {"ms", "us"}) << "/event\x1B[0m per worker";
     }
+
+    // Report the allocations of the event memory arenas and the peak resident memory of the process
+    auto arena_statistics = Event::get_arena_statistics();
+    if(arena_statistics.events > 0) {
+        LOG(STATUS) << "Event memory arenas served " << arena_statistics.events << " events from "
+                    << arena_statistics.buffers << " allocated buffers of " << (Event::arena_size_ >> 10) << " kiB, "
+                    << arena_statistics.released << " buffers released above the high-water mark, "
+                    << arena_statistics.overflows << " allocations of " << (arena_statistics.overflow_bytes >> 10)
+                    << " kiB exceeded the buffers";
+    }
+    struct rusage usage {};
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        // Reported in bytes on macOS
+        auto peak_memory = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        // Reported in kilobytes on Linux
+        auto peak_memory = static_cast<uint64_t>(usage.ru_maxrss) << 10;
+#endif
+        LOG(STATUS) << "Peak resident memory of the process is " << (peak_memory >> 20) << " MiB";
+    }
 }
 
 /**
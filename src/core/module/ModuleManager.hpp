@@ -155,6 +155,7 @@ namespace allpix {
         IdentifierToModuleMap id_to_module_;
 
         ConfigManager* conf_manager_{};
+        GeometryManager* geo_manager_{};
 
         std::unique_ptr<TFile> modules_file_;
 
@@ -163,6 +164,7 @@ namespace allpix {
         std::map<Module*, Histogram<TH1D>> module_event_time_;
         Histogram<TH1D> event_time_;
         Histogram<TH1D> buffer_fill_level_;
+        Histogram<TH1D> buffer_memory_;
 
         // Durations in ns
         uint64_t initialize_time_{}, run_time_{}, finalize_time_{};
@@ -180,6 +182,17 @@ namespace allpix {
         bool multithreading_flag_{false};
         unsigned int number_of_threads_{0};
         size_t max_buffer_size_{1};
+        size_t max_buffer_memory_{0};
+
+        // Segments of consecutive modules requiring the event sequence, executed by the sequencer if enabled
+        std::map<const Module*, size_t> sequence_segments_;
+        size_t number_of_segments_{0};
+
+        // Modules in execution order with the modules depending on them and their number of dependencies, if the modules
+        // of an event are executed following their dependency graph
+        std::vector<std::shared_ptr<Module>> module_graph_;
+        std::vector<std::vector<size_t>> module_successors_;
+        std::vector<size_t> module_dependencies_;
 
         // Possibility of running loaded modules in parallel
         bool can_parallelize_{true};
@@ -37,6 +37,17 @@ ThreadPool::ThreadPool(unsigned int num_threads,
                        unsigned int max_buffered_size,
                        const std::function<void()>& worker_init_function,
                        const std::function<void()>& worker_finalize_function)
+    : ThreadPool(num_threads, max_queue_size, max_buffered_size, 0, worker_init_function, worker_finalize_function) {}
+
+/**
+ * The sequencer is only started if there are workers, otherwise all jobs are already executed in order
+ */
+ThreadPool::ThreadPool(unsigned int num_threads,
+                       unsigned int max_queue_size,
+                       unsigned int max_buffered_size,
+                       unsigned int num_sequences,
+                       const std::function<void()>& worker_init_function,
+                       const std::function<void()>& worker_finalize_function)
     : queue_(max_queue_size, max_buffered_size) {
     assert(max_buffered_size == 0 || max_buffered_size >= num_threads);
     // Create threads
@@ -49,6 +60,14 @@ ThreadPool::ThreadPool(unsigned int num_threads,
                                   worker_finalize_function);
         }
 
+        // Create the sequencer thread with an empty reorder buffer for every sequence
+        if(num_threads > 0 && num_sequences > 0) {
+            sequence_jobs_.resize(num_sequences);
+            sequence_passed_.resize(num_sequences);
+            sequence_next_.resize(num_sequences, 0);
+            sequencer_thread_ = std::thread(&ThreadPool::sequencer, this, worker_init_function, worker_finalize_function);
+        }
+
         // When running single-threadedly, execute initialize function directly and store finalize function for later
         if(threads_.empty()) {
             if(worker_init_function) {
@@ -67,7 +86,91 @@ ThreadPool::ThreadPool(unsigned int num_threads,
 
 ThreadPool::~ThreadPool() { destroy(); }
 
-void ThreadPool::markComplete(uint64_t n) { queue_.complete(n); }
+/**
+ * Completed identifiers will never be submitted to any sequence and therefore count as passed for all of them
+ */
+void ThreadPool::markComplete(uint64_t n) {
+    queue_.complete(n);
+    if(!sequence_jobs_.empty()) {
+        std::unique_lock<std::mutex> lock{sequence_mutex_};
+        for(size_t sequence = 0; sequence < sequence_jobs_.size(); ++sequence) {
+            pass_sequence(sequence, n);
+        }
+        lock.unlock();
+        sequence_condition_.notify_all();
+    }
+}
+
+void ThreadPool::submitSequenced(size_t sequence, uint64_t n, std::function<void()> func) {
+    if(sequence_jobs_.empty()) {
+        func();
+        return;
+    }
+    assert(sequence < sequence_jobs_.size());
+
+    // Increment run count before the job can be picked up by the sequencer
+    std::unique_lock<std::mutex> run_lock{run_mutex_};
+    ++run_cnt_;
+    run_lock.unlock();
+
+    std::unique_lock<std::mutex> lock{sequence_mutex_};
+    sequence_jobs_[sequence].emplace(n, std::move(func));
+    ++sequence_buffer_size_;
+    lock.unlock();
+    sequence_condition_.notify_all();
+}
+
+void ThreadPool::waitSequenceBuffer(size_t max_size) {
+    std::unique_lock<std::mutex> lock{sequence_mutex_};
+    sequence_condition_.wait(lock, [this, max_size]() {
+        return sequence_buffer_size_ < max_size || done_ || !queue_.valid();
+    });
+}
+
+void ThreadPool::bufferMemory(size_t bytes) { buffered_memory_ += bytes; }
+
+void ThreadPool::releaseMemory(size_t bytes) {
+    buffered_memory_ -= bytes;
+    notify_sequencer();
+}
+
+bool ThreadPool::waitBufferedMemory(size_t max_bytes) {
+    std::unique_lock<std::mutex> lock{sequence_mutex_};
+    auto below_budget = [this, max_bytes]() { return buffered_memory_ < max_bytes || done_ || !queue_.valid(); };
+    if(below_budget()) {
+        return false;
+    }
+    sequence_condition_.wait(lock, below_budget);
+    return true;
+}
+
+void ThreadPool::pass_sequence(size_t sequence, uint64_t n) {
+    auto& next = sequence_next_[sequence];
+    auto& passed = sequence_passed_[sequence];
+    if(n < next) {
+        return;
+    }
+    passed.insert(n);
+    auto iter = passed.begin();
+    while(iter != passed.end() && *iter == next) {
+        iter = passed.erase(iter);
+        ++next;
+    }
+}
+
+void ThreadPool::notify_sequencer() {
+    // Lock the mutex to not miss threads which are about to wait
+    std::unique_lock<std::mutex> lock{sequence_mutex_};
+    lock.unlock();
+    sequence_condition_.notify_all();
+}
+
+void ThreadPool::release_run() {
+    std::unique_lock<std::mutex> lock{run_mutex_};
+    if(--run_cnt_ == 0) {
+        run_condition_.notify_all();
+    }
+}
 
 void ThreadPool::checkException() {
     // If exception has been thrown, destroy pool and propagate it
@@ -109,10 +212,7 @@ void ThreadPool::worker(size_t min_thread_buffer,
                 // Fetch the future to propagate exceptions
                 task->get_future().get();
                 // Update the run count and propagate update
-                std::unique_lock<std::mutex> lock{run_mutex_};
-                if(--run_cnt_ == 0) {
-                    run_condition_.notify_all();
-                }
+                release_run();
             }
         }
 
@@ -131,6 +231,81 @@ void ThreadPool::worker(size_t min_thread_buffer,
         }
         // Propagate that the worker terminated
         run_condition_.notify_all();
+        lock.unlock();
+        notify_sequencer();
+    }
+}
+
+/**
+ * The sequencer executes the job of a sequence as soon as its identifier is the next one to pass. Jobs arriving out of order
+ * are kept in the reorder buffer, such that no job is ever requeued. Exceptions are handled like for the workers.
+ */
+void ThreadPool::sequencer(const std::function<void()>& initialize_function,
+                           const std::function<void()>& finalize_function) {
+    try {
+        // Register the thread
+        unsigned int thread_num = thread_cnt_++;
+        assert(thread_num < thread_total_);
+        thread_nums_[std::this_thread::get_id()] = thread_num;
+
+        // Initialize the sequencer
+        if(initialize_function) {
+            initialize_function();
+        }
+
+        std::unique_lock<std::mutex> lock{sequence_mutex_};
+        while(!done_ && queue_.valid()) {
+            // Find a sequence for which the next job is available
+            auto sequence = sequence_jobs_.size();
+            for(size_t i = 0; i < sequence_jobs_.size(); ++i) {
+                if(!sequence_jobs_[i].empty() && sequence_jobs_[i].begin()->first == sequence_next_[i]) {
+                    sequence = i;
+                    break;
+                }
+            }
+            if(sequence == sequence_jobs_.size()) {
+                sequence_condition_.wait(lock);
+                continue;
+            }
+
+            auto node = sequence_jobs_[sequence].extract(sequence_jobs_[sequence].begin());
+            --sequence_buffer_size_;
+            lock.unlock();
+            sequence_condition_.notify_all();
+
+            // Execute job
+            node.mapped()();
+
+            // Pass the sequence unless the job has been resubmitted
+            lock.lock();
+            if(sequence_jobs_[sequence].count(node.key()) == 0) {
+                pass_sequence(sequence, node.key());
+            }
+            lock.unlock();
+
+            // Update the run count and propagate update
+            release_run();
+            lock.lock();
+        }
+        lock.unlock();
+
+        // Execute the cleanup function at the end of run
+        if(finalize_function) {
+            finalize_function();
+        }
+    } catch(...) {
+        // Check if the first exception thrown
+        std::unique_lock<std::mutex> lock{run_mutex_};
+        if(!has_exception_.test_and_set()) {
+            // Save the first exception
+            exception_ptr_ = std::current_exception();
+            // Invalidate the queue to terminate the workers
+            queue_.invalidate();
+        }
+        // Propagate that the sequencer terminated
+        run_condition_.notify_all();
+        lock.unlock();
+        notify_sequencer();
     }
 }
 
@@ -147,6 +322,10 @@ void ThreadPool::destroy() {
             thread.join();
         }
     }
+    notify_sequencer();
+    if(sequencer_thread_.joinable()) {
+        sequencer_thread_.join();
+    }
 
     // Execute the cleanup function at the end of run if running single-threaded
     if(threads_.empty() && finalize_function_) {
@@ -33,12 +33,13 @@ namespace allpix {
         /**
          * @brief Internal thread-safe queuing system
          *
-         * It internally consists of two separate queues
+         * It internally consists of three separate queues
          * - A standard queue pushed in order of jobs to process
          * - An ordered priority queue for work that need linear processing
+         * - An unbounded urgent queue for parts of jobs that are already being processed
          *
-         * The priority queue is popped if the top of the queue can be directly processed. Otherwise work is popped from the
-         * default queue unless the priority queue size is too large.
+         * The urgent queue is always popped first. The priority queue is popped if the top of the queue can be directly
+         * processed. Otherwise work is popped from the default queue unless the priority queue size is too large.
          */
         template <typename T> class SafeQueue {
         public:
@@ -77,6 +78,12 @@ namespace allpix {
              * @return If the push was successful
              */
             bool push(uint64_t n, T value, bool wait = true);
+            /**
+             * @brief Push a new value onto the urgent queue, never blocks
+             * @param value Value to push to the queue
+             * @return If the push was successful
+             */
+            bool pushUrgent(T value);
 
             /**
              * @brief Mark an identifier as complete
@@ -103,7 +110,7 @@ namespace allpix {
             bool empty() const;
 
             /**
-             * @brief Return total size of values stored in both queues
+             * @brief Return total size of values stored in all queues
              * @return Size of of the internal queues
              */
             size_t size() const;
@@ -123,6 +130,7 @@ namespace allpix {
             std::atomic_bool valid_{true};
             mutable std::mutex mutex_{};
             std::queue<T> queue_;
+            std::queue<T> urgent_queue_;
             std::set<uint64_t> completed_ids_;
             uint64_t current_id_{0};
             using PQValue = std::pair<uint64_t, T>;
@@ -162,6 +170,25 @@ namespace allpix {
                    const std::function<void()>& worker_init_function = nullptr,
                    const std::function<void()>& worker_finalize_function = nullptr);
 
+        /**
+         * @brief Construct thread pool with provided number of threads with buffered jobs and a sequencer
+         * @param num_threads Number of threads in the pool
+         * @param max_queue_size Maximum size of the standard job queue
+         * @param max_buffered_size Maximum size of the buffered job queue (should be at least number of threads)
+         * @param num_sequences Number of independent sequences executed in order by the sequencer, no sequencer is started
+         *                      if zero
+         * @param worker_init_function Function run by all the workers and the sequencer to initialize
+         * @param worker_finalize_function Function run by all the workers and the sequencer to cleanup
+         * @warning Total count of threads, including the sequencer, need to be preregistered via
+         *          \ref ThreadPool::registerThreadCount
+         */
+        ThreadPool(unsigned int num_threads,
+                   unsigned int max_queue_size,
+                   unsigned int max_buffered_size,
+                   unsigned int num_sequences,
+                   const std::function<void()>& worker_init_function = nullptr,
+                   const std::function<void()>& worker_finalize_function = nullptr);
+
         /// @{
         /**
          * @brief Copying the thread pool is not allowed
@@ -188,6 +215,27 @@ namespace allpix {
          */
         template <typename Func, typename... Args> auto submit(uint64_t n, Func&& func, Args&&... args);
 
+        /**
+         * @brief Submit an urgent job to be run by the thread pool before all standard and priority jobs. The submission
+         * never blocks, such that workers can split the job they are processing. In case no workers are registered, the
+         * function will be executed immediately.
+         * @param func Function to execute by the pool
+         */
+        template <typename Func> void submitUrgent(Func&& func);
+
+        /**
+         * @brief Submit a job to the sequencer, which executes the jobs of every sequence in order of their identifiers. In
+         * case no sequencer is running, the function will be executed immediately.
+         * @param sequence Index of the sequence the job belongs to
+         * @param n Identifier of the job within the sequence
+         * @param func Function to execute by the sequencer
+         *
+         * A job is executed as soon as all lower identifiers have either passed the sequence or have been marked as
+         * completed. The job is regarded as passed once it returns, unless it has resubmitted itself to the same sequence.
+         * This function never blocks, the reorder buffer can be limited with \ref ThreadPool::waitSequenceBuffer.
+         */
+        void submitSequenced(size_t sequence, uint64_t n, std::function<void()> func);
+
         /**
          * @brief Mark identifier as completed
          * @param n Identifier that is complete
@@ -210,7 +258,38 @@ namespace allpix {
          * @brief Return the number of jobs in buffered priority queue
          * @return The number of enqueued jobs in the buffered queue
          */
-        size_t bufferedQueueSize() const { return queue_.prioritySize(); }
+        size_t bufferedQueueSize() const { return queue_.prioritySize() + sequence_buffer_size_; }
+
+        /**
+         * @brief Block until the reorder buffer of the sequencer holds less than the given number of jobs
+         * @param max_size Maximum number of jobs waiting in the reorder buffer
+         */
+        void waitSequenceBuffer(size_t max_size);
+
+        /**
+         * @brief Account for the memory retained by a job while it is buffered
+         * @param bytes Approximate number of bytes retained by the job
+         */
+        void bufferMemory(size_t bytes);
+
+        /**
+         * @brief Release the memory accounted for a buffered job when it is resumed
+         * @param bytes Number of bytes previously accounted via \ref ThreadPool::bufferMemory
+         */
+        void releaseMemory(size_t bytes);
+
+        /**
+         * @brief Return the approximate memory retained by all buffered jobs
+         * @return Buffered memory in bytes
+         */
+        size_t bufferedMemory() const { return buffered_memory_; }
+
+        /**
+         * @brief Block until the memory retained by buffered jobs is below the given budget
+         * @param max_bytes Maximum memory in bytes retained by buffered jobs
+         * @return True if the budget was exceeded and the call had to wait
+         */
+        bool waitBufferedMemory(size_t max_bytes);
 
         /**
          * @brief Check if any worker thread has thrown an exception
@@ -267,6 +346,31 @@ namespace allpix {
                     const std::function<void()>& initialize_function,
                     const std::function<void()>& finalize_function);
 
+        /**
+         * @brief Internal function of the sequencer thread executing the jobs of all sequences in order
+         * @param initialize_function Function to initialize the thread
+         * @param finalize_function   Function to finalize the thread
+         */
+        void sequencer(const std::function<void()>& initialize_function, const std::function<void()>& finalize_function);
+
+        /**
+         * @brief Mark identifier as passed for a sequence and advance the next identifier to execute
+         * @param sequence Index of the sequence
+         * @param n Identifier that passed
+         * @warning The sequence mutex has to be held by the caller
+         */
+        void pass_sequence(size_t sequence, uint64_t n);
+
+        /**
+         * @brief Wake up the sequencer and threads waiting for space in the buffers
+         */
+        void notify_sequencer();
+
+        /**
+         * @brief Decrement the run count for a finished or rejected job and wake up waiting threads if no job is left
+         */
+        void release_run();
+
         // The queue holds the task functions to be executed by the workers
         using Task = std::unique_ptr<std::packaged_task<void()>>;
         SafeQueue<Task> queue_;
@@ -280,6 +384,18 @@ namespace allpix {
         std::condition_variable run_condition_;
         std::vector<std::thread> threads_;
 
+        // Reorder buffer and next identifier to execute for every sequence of the sequencer
+        std::thread sequencer_thread_;
+        std::vector<std::map<uint64_t, std::function<void()>>> sequence_jobs_;
+        std::vector<std::set<uint64_t>> sequence_passed_;
+        std::vector<uint64_t> sequence_next_;
+        std::atomic_size_t sequence_buffer_size_{0};
+        std::mutex sequence_mutex_{};
+        std::condition_variable sequence_condition_;
+
+        // Approximate memory retained by buffered jobs
+        std::atomic_size_t buffered_memory_{0};
+
         std::atomic_flag has_exception_{false};
         std::exception_ptr exception_ptr_{nullptr};
 
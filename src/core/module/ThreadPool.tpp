@@ -31,20 +31,25 @@ namespace allpix {
         }
 
         // Wait for one of the queues to be available
+        bool pop_urgent = !urgent_queue_.empty();
         bool pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
         bool pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
-        while(!pop_priority && !pop_standard) {
+        while(!pop_urgent && !pop_priority && !pop_standard) {
             // Wait for new item in the queue (unlocks the mutex while waiting)
             pop_condition_.wait(lock);
             if(!valid_) {
                 return false;
             }
+            pop_urgent = !urgent_queue_.empty();
             pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
             pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
         }
 
         // Pop the appropriate queue
-        if(pop_priority) {
+        if(pop_urgent) {
+            out = std::move(urgent_queue_.front());
+            urgent_queue_.pop();
+        } else if(pop_priority) {
             // Priority queue is missing a pop returning a non-const reference, so need to apply a const_cast
             out = std::move(const_cast<PQValue&>(priority_queue_.top())).second; // NOLINT
             priority_queue_.pop();
@@ -56,6 +61,9 @@ namespace allpix {
 
         // Notify possible pusher waiting to fill the queue
         lock.unlock();
+        if(pop_urgent) {
+            return true;
+        }
         if(pop_priority) {
             pop_condition_.notify_one();
         }
@@ -119,6 +127,19 @@ namespace allpix {
     }
 #pragma GCC diagnostic pop
 
+    template <typename T> bool ThreadPool::SafeQueue<T>::pushUrgent(T value) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        if(!valid_) {
+            return false;
+        }
+
+        // Push a new element to the queue and notify possible consumer
+        urgent_queue_.push(std::move(value));
+        lock.unlock();
+        pop_condition_.notify_one();
+        return true;
+    }
+
     template <typename T> void ThreadPool::SafeQueue<T>::complete(uint64_t n) {
         std::unique_lock<std::mutex> lock{mutex_};
         completed_ids_.insert(n);
@@ -132,6 +153,8 @@ namespace allpix {
             lock.unlock();
             pop_condition_.notify_one();
             lock.lock();
+            // Other threads might have altered the set while the mutex was released
+            iter = completed_ids_.begin();
         }
     }
 
@@ -147,12 +170,12 @@ namespace allpix {
 
     template <typename T> bool ThreadPool::SafeQueue<T>::empty() const {
         std::lock_guard<std::mutex> lock{mutex_};
-        return !valid_ || (queue_.empty() && priority_queue_.empty());
+        return !valid_ || (queue_.empty() && priority_queue_.empty() && urgent_queue_.empty());
     }
 
     template <typename T> size_t ThreadPool::SafeQueue<T>::size() const {
         std::lock_guard<std::mutex> lock{mutex_};
-        return queue_.size() + priority_queue_.size();
+        return queue_.size() + priority_queue_.size() + urgent_queue_.size();
     }
 
     template <typename T> size_t ThreadPool::SafeQueue<T>::prioritySize() const { return priority_queue_size_; }
@@ -166,6 +189,7 @@ namespace allpix {
         std::priority_queue<PQValue, std::vector<PQValue>, std::greater<>>().swap(priority_queue_);
         priority_queue_size_ = 0;
         std::queue<T>().swap(queue_);
+        std::queue<T>().swap(urgent_queue_);
         valid_ = false;
         lock.unlock();
         push_condition_.notify_all();
@@ -195,14 +219,21 @@ namespace allpix {
         if(threads_.empty()) {
             task_function();
         } else {
+            // Increment run count before the task can be picked up by a worker
+            std::unique_lock<std::mutex> lock{run_mutex_};
+            ++run_cnt_;
+            lock.unlock();
+
             if(n == UINT64_MAX) {
                 success = queue_.push(std::make_unique<std::packaged_task<void()>>(std::move(task_function)), true);
             } else {
                 success = queue_.push(n, std::make_unique<std::packaged_task<void()>>(std::move(task_function)), false);
             }
-            // Increment run count:
-            std::unique_lock<std::mutex> lock{run_mutex_};
-            ++run_cnt_;
+
+            // Roll back the run count if the task was not queued, e.g. because the queue has been invalidated
+            if(!success) {
+                release_run();
+            }
         }
         if(success) {
             return future;
@@ -211,4 +242,20 @@ namespace allpix {
         }
     }
 
+    template <typename Func> void ThreadPool::submitUrgent(Func&& func) {
+        if(threads_.empty()) {
+            func();
+            return;
+        }
+
+        // Increment run count before the task can be picked up by a worker
+        std::unique_lock<std::mutex> lock{run_mutex_};
+        ++run_cnt_;
+        lock.unlock();
+
+        if(!queue_.pushUrgent(std::make_unique<std::packaged_task<void()>>(std::forward<Func>(func)))) {
+            release_run();
+        }
+    }
+
 } // namespace allpix
@@ -157,6 +157,23 @@ namespace allpix {
         explicit AbortEventException(std::string reason) : EndOfRunException(reason) { error_message_ = std::move(reason); }
     };
 
+    /**
+     * @ingroup Exceptions
+     * @brief Exception for modules to request skipping the remaining modules of the current event
+     * @note Non-fatal error used to end the processing of the current event without reporting it as an issue.
+     *
+     * This error can be raised by modules which select events, e.g. filters rejecting events that do not fulfill a trigger
+     * condition. In contrast to the \ref AbortEventException, the event is counted as skipped and not as aborted.
+     */
+    class SkipEventException : public AbortEventException {
+    public:
+        /**
+         * @brief Constructs request to skip the remainder of the current event with a description
+         * @param reason Text explaining the reason why the event is skipped
+         */
+        explicit SkipEventException(std::string reason) : AbortEventException(reason) { error_message_ = std::move(reason); }
+    };
+
     /**
      * @ingroup Exceptions
      * @brief Exception for modules to request an interrupt because dependencies are missing
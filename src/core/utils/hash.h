@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief Incremental hash over raw data for identifying inputs of cached results
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_HASH_H
+#define ALLPIX_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace allpix {
+
+    /**
+     * @brief Incremental 64-bit FNV-1a hash over the raw bytes of the added values
+     *
+     * In contrast to a sum of values, the hash depends on the order of the values and changes under any modification of
+     * the input, e.g. when values are permuted or changes compensate each other. It is not a cryptographic hash and should
+     * only be used to detect whether data such as field maps changed between runs.
+     */
+    class FNV1aHash {
+    public:
+        /**
+         * @brief Add a range of raw bytes to the hash
+         * @param data Pointer to the first byte
+         * @param size Number of bytes to add
+         */
+        void add(const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for(std::size_t i = 0; i < size; ++i) {
+                hash_ ^= bytes[i];
+                hash_ *= 0x100000001b3;
+            }
+        }
+
+        /**
+         * @brief Add the object representation of a value to the hash
+         * @param value Value to add
+         */
+        template <typename T> void add(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be hashed");
+            add(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Get the hash of all data added so far
+         * @return 64-bit hash value
+         */
+        std::uint64_t value() const { return hash_; }
+
+    private:
+        std::uint64_t hash_{0xcbf29ce484222325};
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_HASH_H */
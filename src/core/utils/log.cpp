@@ -13,18 +13,133 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <ostream>
-#include <regex>
 #include <string>
 #include <thread>
 #include <unistd.h>
 
 using namespace allpix;
 
+namespace {
+    // Interval in which the background writer collects the queued messages
+    constexpr auto write_interval = std::chrono::milliseconds(10);
+
+    // Formatted log message waiting to be written by the background writer
+    struct LogRecord {
+        std::string message;
+        std::string identifier;
+    };
+
+    /**
+     * @brief Lock-free queue of log messages with a single producer and a single consumer
+     *
+     * Every thread writes its messages to its own queue, which is emptied by the background writer.
+     */
+    class LogQueue {
+    public:
+        static constexpr uint64_t capacity = 1024;
+
+        /**
+         * @brief Append a message to the queue
+         * @param record Message to append, only moved from if there is space in the queue
+         * @return True if the message was appended, false if the queue is full
+         */
+        bool push(LogRecord& record) {
+            auto head = head_.load(std::memory_order_relaxed);
+            if(head - tail_.load(std::memory_order_acquire) == capacity) {
+                return false;
+            }
+            records_[head % capacity] = std::move(record);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Remove the oldest message from the queue
+         * @param record Message removed from the queue
+         * @return True if a message was removed, false if the queue is empty
+         */
+        bool pop(LogRecord& record) {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            if(tail == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            record = std::move(records_[tail % capacity]);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Number of messages appended to the queue so far
+        uint64_t appended() const { return head_.load(std::memory_order_acquire); }
+        // Number of messages in the queue
+        uint64_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+
+        // Mark all removed messages as written to the streams
+        void setWritten() { written_.store(tail_.load(std::memory_order_relaxed), std::memory_order_release); }
+        // Number of messages written to the streams so far
+        uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    private:
+        std::array<LogRecord, capacity> records_;
+        alignas(64) std::atomic<uint64_t> head_{0};
+        alignas(64) std::atomic<uint64_t> tail_{0};
+        std::atomic<uint64_t> written_{0};
+    };
+
+    // State of the asynchronous logging shared by all threads
+    struct AsyncState {
+        AsyncState() = default;
+        AsyncState(const AsyncState&) = delete;
+        AsyncState& operator=(const AsyncState&) = delete;
+        AsyncState(AsyncState&&) = delete;
+        AsyncState& operator=(AsyncState&&) = delete;
+        ~AsyncState() {
+            // Do not leave a running thread behind if the logging has not been finished
+            if(writer.joinable()) {
+                running.store(false);
+                wake.notify_one();
+                writer.join();
+            }
+        }
+
+        std::atomic<bool> running{false};
+        std::thread writer;
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+
+        // Queues of all threads, replaced every time the asynchronous logging is started
+        std::mutex queues_mutex;
+        std::vector<std::shared_ptr<LogQueue>> queues;
+        std::atomic<uint64_t> generation{0};
+    };
+    AsyncState& async_state() {
+        static AsyncState state;
+        return state;
+    }
+
+    // Queue of the calling thread, registered with the background writer on first use
+    LogQueue& thread_queue() {
+        thread_local std::shared_ptr<LogQueue> queue;
+        thread_local uint64_t generation = 0;
+
+        auto& state = async_state();
+        if(queue == nullptr || generation != state.generation.load()) {
+            std::lock_guard<std::mutex> lock(state.queues_mutex);
+            queue = std::make_shared<LogQueue>();
+            state.queues.push_back(queue);
+            generation = state.generation.load();
+        }
+        return *queue;
+    }
+} // namespace
+
 // Last name used while printing (for identifying process logs)
 std::string DefaultLogger::last_identifier_;
 // Last message send used to check if extra spaces are needed
@@ -65,12 +180,48 @@ DefaultLogger::~DefaultLogger() {
         } while((start_pos = out.find('\n', start_pos)) != std::string::npos);
     }
 
-    // Lock the mutex to guard last identifier usage
-    std::unique_lock<std::mutex> lock(write_mutex_);
+    auto& state = async_state();
+    if(state.running.load(std::memory_order_acquire)) {
+        // Hand the message to the background writer, waiting for space if the queue of this thread is full
+        auto& queue = thread_queue();
+        LogRecord record{std::move(out), identifier_};
+        while(!queue.push(record)) {
+            state.wake.notify_one();
+            std::this_thread::yield();
+            if(!state.running.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                write_message(std::move(record.message), record.identifier);
+                flush_streams();
+                return;
+            }
+        }
 
+        if(level_ == LogLevel::FATAL) {
+            // Fatal messages typically precede the termination of the program and are waited for
+            auto position = queue.appended();
+            while(queue.written() < position && state.running.load(std::memory_order_acquire)) {
+                state.wake.notify_one();
+                std::this_thread::yield();
+            }
+        } else if(queue.size() > LogQueue::capacity / 2) {
+            state.wake.notify_one();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write_message(std::move(out), identifier_);
+    flush_streams();
+}
+
+/**
+ * Process logs with the same identifier as the previous message overwrite the previous line, all other messages end the
+ * previous process log.
+ */
+void DefaultLogger::write_message(std::string out, const std::string& identifier) {
     // Add extra spaces if necessary
     size_t extra_spaces = 0;
-    if(!identifier_.empty() && last_identifier_ == identifier_) {
+    if(!identifier.empty() && last_identifier_ == identifier) {
         // Put carriage return for process logs
         out = '\r' + out;
 
@@ -82,7 +233,7 @@ DefaultLogger::~DefaultLogger() {
         // End process log and continue normal logging
         out = '\n' + out;
     }
-    last_identifier_ = identifier_;
+    last_identifier_ = identifier;
 
     // Save last message
     last_message_ = out;
@@ -94,7 +245,7 @@ DefaultLogger::~DefaultLogger() {
     }
 
     // Add final newline if not a progress log
-    if(identifier_.empty()) {
+    if(identifier.empty()) {
         out += '\n';
     }
 
@@ -110,11 +261,8 @@ DefaultLogger::~DefaultLogger() {
     }
     out_no_special += out.substr(prev);
 
-    // Replace carriage return by newline:
-    try {
-        out_no_special = std::regex_replace(out_no_special, std::regex("\\\r"), "\n");
-    } catch(std::regex_error&) {
-    }
+    // Replace carriage return by newline
+    std::replace(out_no_special.begin(), out_no_special.end(), '\r', '\n');
 
     // Print output to streams
     for(auto* stream : get_streams()) {
@@ -123,16 +271,90 @@ DefaultLogger::~DefaultLogger() {
         } else {
             (*stream) << out_no_special;
         }
+    }
+}
+
+void DefaultLogger::flush_streams() {
+    for(auto* stream : get_streams()) {
         (*stream).flush();
     }
-    lock.unlock();
 }
 
+/**
+ * The writer sleeps for a short interval or until woken by a thread with a filling queue, and then writes all collected
+ * messages at once. This avoids contention between the logging threads and flushing the streams for every message.
+ */
+void DefaultLogger::write_asynchronous() {
+    auto& state = async_state();
+    while(state.running.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(state.wake_mutex);
+            state.wake.wait_for(lock, write_interval);
+        }
+        write_queues();
+    }
+}
+
+void DefaultLogger::write_queues() {
+    auto& state = async_state();
+    std::vector<std::shared_ptr<LogQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(state.queues_mutex);
+        queues = state.queues;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    LogRecord record;
+    bool written = false;
+    for(auto& queue : queues) {
+        while(queue->pop(record)) {
+            write_message(std::move(record.message), record.identifier);
+            written = true;
+        }
+    }
+    if(written) {
+        flush_streams();
+    }
+    for(auto& queue : queues) {
+        queue->setWritten();
+    }
+}
+
+/**
+ * Stopping the asynchronous logging waits for the background writer to finish and writes all messages still queued.
+ */
+void DefaultLogger::setAsynchronous(bool asynchronous) {
+    auto& state = async_state();
+    if(asynchronous == state.running.load()) {
+        return;
+    }
+
+    if(asynchronous) {
+        // Start with new queues for all threads
+        state.generation++;
+        state.running.store(true);
+        state.writer = std::thread(&DefaultLogger::write_asynchronous);
+        return;
+    }
+
+    state.running.store(false);
+    state.wake.notify_one();
+    state.writer.join();
+    write_queues();
+
+    std::lock_guard<std::mutex> lock(state.queues_mutex);
+    state.queues.clear();
+}
+bool DefaultLogger::isAsynchronous() { return async_state().running.load(); }
+
 /**
  * @warning No other log message should be send after this method
  * @note Does not close the streams
  */
 void DefaultLogger::finish() {
+    // Write all remaining messages of the background writer
+    setAsynchronous(false);
+
     // Lock the mutex to guard output writing
     std::lock_guard<std::mutex> lock(write_mutex_);
 
@@ -164,6 +386,8 @@ void DefaultLogger::finish() {
  */
 std::ostringstream&
 DefaultLogger::getStream(LogLevel level, const std::string& file, const std::string& function, uint32_t line) {
+    level_ = level;
+
     // Add date in all except short format
     if(get_format() != LogFormat::SHORT) {
         os << "\x1B[1m"; // BOLD
@@ -342,7 +566,10 @@ std::vector<std::ostream*>& DefaultLogger::get_streams() {
     static std::vector<std::ostream*> streams;
     return streams;
 }
-void DefaultLogger::clearStreams() { get_streams().clear(); }
+void DefaultLogger::clearStreams() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    get_streams().clear();
+}
 /**
  * The caller has to make sure that the added ostream exists for as long log messages may be written. The std::cout stream is
  * added automatically to the list of streams and does not need to be added itself.
@@ -355,6 +582,8 @@ void DefaultLogger::addStream(std::ostream& stream) {
         stream << "\x1B[?25l";
     }
 
+    // Guard against the background writer using the streams
+    std::lock_guard<std::mutex> lock(write_mutex_);
     get_streams().push_back(&stream);
 }
 
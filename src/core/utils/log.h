@@ -38,6 +38,21 @@ namespace allpix {
         TRACE,     ///< Software debugging information about what part is currently running
         PRNG,      ///< Logging level printing every pseudo-random number requested
     };
+
+#ifndef ALLPIX_LOG_LEVEL_COMPILED
+/**
+ * @brief Name of the most verbose log level compiled into the framework, set by the CMake option LOG_LEVEL_COMPILED
+ */
+#define ALLPIX_LOG_LEVEL_COMPILED PRNG
+#endif
+
+    /**
+     * @brief Most verbose log level compiled into the framework
+     *
+     * The level is part of the condition of all logging macros. Since it is a constant expression, messages of more verbose
+     * levels are removed by the compiler and cannot be enabled at runtime.
+     */
+    constexpr LogLevel compiled_log_level = LogLevel::ALLPIX_LOG_LEVEL_COMPILED;
     /**
      * @brief Format of the logger
      */
@@ -199,6 +214,22 @@ namespace allpix {
          */
         static uint64_t getEventNum();
 
+        /**
+         * @brief Enable or disable asynchronous writing of log messages
+         * @param asynchronous True to hand messages to a background writer thread, false to write them directly
+         *
+         * When enabled, every thread formats its messages and appends them to its own queue without locking. A background
+         * thread collects the messages of all queues and writes them to the streams in batches. Messages of a single thread
+         * keep their order, messages of different threads are only ordered between batches. Should not be called while
+         * other threads are logging.
+         */
+        static void setAsynchronous(bool asynchronous);
+        /**
+         * @brief Return if log messages are written asynchronously
+         * @return True if a background writer thread is used, false otherwise
+         */
+        static bool isAsynchronous();
+
     private:
         /**
          * @brief Get the current date as a printable string
@@ -212,6 +243,29 @@ namespace allpix {
          */
         static bool is_terminal(std::ostream& stream);
 
+        /**
+         * @brief Write a formatted message to all streams without flushing them
+         * @param out Formatted message
+         * @param identifier Identifier of the process log, empty for a normal log message
+         * @warning The write mutex has to be held by the caller
+         */
+        static void write_message(std::string out, const std::string& identifier);
+        /**
+         * @brief Flush all streams
+         * @warning The write mutex has to be held by the caller
+         */
+        static void flush_streams();
+
+        /**
+         * @brief Loop of the background writer thread, writing all queued messages in regular intervals
+         */
+        static void write_asynchronous();
+        /**
+         * @brief Write all queued messages of all threads to the streams and flush them once
+         * @warning Only a single thread may empty the queues at any time
+         */
+        static void write_queues();
+
         // Output stream
         std::ostringstream os;
 
@@ -219,6 +273,8 @@ namespace allpix {
         int exception_count_{};
         // Saved value of the length of the header indent
         unsigned int indent_count_{};
+        // Level of the message
+        LogLevel level_{LogLevel::INFO};
 
         // Internal methods to store static values
         static std::string& get_section();
@@ -244,18 +300,28 @@ namespace allpix {
 #define __FILE_NAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 #endif
 
+/**
+ * @brief Check if messages of a log level are compiled in, requested and can be written
+ * @param level The log level
+ *
+ * The comparison with the compiled log level is evaluated at compile time, removing all messages of more verbose levels.
+ */
+#define LOG_ENABLED(level)                                                                                                  \
+    (allpix::LogLevel::level <= allpix::compiled_log_level &&                                                               \
+     allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())
+
 /**
  * @brief Execute a block only if the reporting level is high enough
  * @param level The minimum log level
  */
-#define IFLOG(level) if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())
+#define IFLOG(level) if(LOG_ENABLED(level))
 
 /**
  * @brief Create a logging stream if the reporting level is high enough
  * @param level The log level of the stream
  */
 #define LOG(level)                                                                                                          \
-    if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())                   \
+    if(LOG_ENABLED(level))                                                                                                  \
     allpix::Log().getStream(                                                                                                \
         allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)
 
@@ -265,7 +331,7 @@ namespace allpix {
  * @param identifier Identifier for this stream to determine overwrites
  */
 #define LOG_PROGRESS(level, identifier)                                                                                     \
-    if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())                   \
+    if(LOG_ENABLED(level))                                                                                                  \
     allpix::Log().getProcessStream(                                                                                         \
         identifier, allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)
 
@@ -297,7 +363,7 @@ namespace allpix {
 #define LOG_N(level, max_log_count)                                                                                         \
     GENERATE_LOG_VAR(max_log_count);                                                                                        \
     if(GET_LOG_VARIABLE() > 0)                                                                                              \
-        if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())               \
+        if(LOG_ENABLED(level))                                                                                              \
     allpix::Log().getStream(                                                                                                \
         allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)                  \
         << ((--GET_LOG_VARIABLE() == 0) ? "[further messages suppressed] " : "")
@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Implementation of the NUMA utilities
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "numa.h"
+
+#include <sys/mman.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace allpix;
+
+std::array<std::atomic<uint64_t>, NumaTopology::max_nodes> NumaTopology::events_{};
+
+namespace {
+    // Size of the huge pages the replicas are aligned to
+    constexpr size_t huge_page_size = 2 << 20;
+
+    // Parse a CPU list of the form "0-3,8,10-11"
+    std::vector<unsigned int> parse_cpu_list(const std::string& list) {
+        std::vector<unsigned int> cpus;
+        std::stringstream stream(list);
+        std::string range;
+        while(std::getline(stream, range, ',')) {
+            auto dash = range.find('-');
+            try {
+                auto first = static_cast<unsigned int>(std::stoul(range.substr(0, dash)));
+                auto last =
+                    (dash == std::string::npos ? first : static_cast<unsigned int>(std::stoul(range.substr(dash + 1))));
+                for(auto cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch(const std::logic_error&) {
+                continue;
+            }
+        }
+        return cpus;
+    }
+} // namespace
+
+/**
+ * The CPUs of every node are read from sysfs and restricted to the affinity mask of the process, such that CPU sets
+ * assigned by batch systems are respected.
+ */
+NumaTopology::NumaTopology() {
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    auto has_mask = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    auto is_allowed = [&](unsigned int cpu) { return !has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+
+    std::error_code error;
+    for(size_t node = 0; node < max_nodes; ++node) {
+        auto path = std::filesystem::path("/sys/devices/system/node") / ("node" + std::to_string(node)) / "cpulist";
+        if(!std::filesystem::exists(path, error)) {
+            continue;
+        }
+        std::ifstream file(path);
+        std::string list;
+        std::getline(file, list);
+
+        std::vector<unsigned int> cpus;
+        for(auto cpu : parse_cpu_list(list)) {
+            if(is_allowed(cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if(!cpus.empty()) {
+            nodes_.push_back(std::move(cpus));
+        }
+    }
+
+    // Fall back to a single node with all allowed CPUs
+    if(nodes_.empty()) {
+        std::vector<unsigned int> cpus;
+        for(unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if(has_mask ? CPU_ISSET(cpu, &allowed) : cpu < std::thread::hardware_concurrency()) {
+                cpus.push_back(cpu);
+            }
+        }
+        nodes_.push_back(std::move(cpus));
+    }
+#else
+    std::vector<unsigned int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+    std::iota(cpus.begin(), cpus.end(), 0u);
+    nodes_.push_back(std::move(cpus));
+#endif
+}
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology topology;
+    return topology;
+}
+
+/**
+ * Workers are assigned to the nodes in turn, and within a node to consecutive CPUs. Pinning is only supported on Linux,
+ * on other systems only the node is assigned.
+ */
+size_t NumaTopology::pinThread(unsigned int worker) const {
+    auto node = worker % nodes_.size();
+    const auto& cpus = nodes_[node];
+    auto cpu = cpus[(worker / nodes_.size()) % cpus.size()];
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+    current_node_ = node;
+    return node;
+}
+
+void NumaTopology::runOnNode(size_t node, const std::function<void()>& function) const {
+#ifdef __linux__
+    cpu_set_t previous;
+    auto restore = (pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) == 0);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto cpu : nodes_.at(node)) {
+        CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    function();
+    if(restore) {
+        pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+    }
+#else
+    (void)node;
+    function();
+#endif
+}
+
+size_t NumaTopology::find_current_node() const noexcept {
+#ifdef __linux__
+    auto cpu = sched_getcpu();
+    for(size_t node = 0; node < nodes_.size(); ++node) {
+        if(std::find(nodes_[node].begin(), nodes_[node].end(), static_cast<unsigned int>(cpu)) != nodes_[node].end()) {
+            return node;
+        }
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Explicit huge pages are only available if the administrator reserved them, otherwise the kernel is advised to use
+ * transparent huge pages for the mapping. The advice has to be given before the pages are first touched.
+ */
+ReplicatedArray::ReplicatedArray(const std::vector<double>& data, size_t replicas, bool huge_pages) {
+    const auto& topology = NumaTopology::get();
+    auto bytes = std::max(data.size() * sizeof(double), sizeof(double));
+    mapped_size_ = (huge_pages ? (bytes + huge_page_size - 1) / huge_page_size * huge_page_size : bytes);
+
+    for(size_t replica = 0; replica < std::max(replicas, size_t(1)); ++replica) {
+        void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if(huge_pages) {
+            memory = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if(memory == MAP_FAILED) {
+            memory = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(memory == MAP_FAILED) {
+                for(auto* mapped : replicas_) {
+                    munmap(mapped, mapped_size_);
+                }
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            if(huge_pages) {
+                madvise(memory, mapped_size_, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        replicas_.push_back(static_cast<double*>(memory));
+
+        // Copy the data from a thread on the node to allocate the pages there
+        topology.runOnNode(replica % topology.getNodeCount(),
+                           [&]() { std::memcpy(memory, data.data(), data.size() * sizeof(double)); });
+        mprotect(memory, mapped_size_, PROT_READ);
+    }
+}
+
+ReplicatedArray::~ReplicatedArray() {
+    for(auto* replica : replicas_) {
+        munmap(replica, mapped_size_);
+    }
+    replicas_.clear();
+}
@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief Utilities to place threads and read-only data on the NUMA nodes of the machine
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_NUMA_H
+#define ALLPIX_NUMA_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace allpix {
+
+    /**
+     * @brief NUMA topology of the machine, restricted to the CPUs the process is allowed to run on
+     *
+     * The topology is read from the system once. On systems without NUMA information all allowed CPUs are assigned to a
+     * single node. The class also keeps track of the number of events processed per node.
+     */
+    class NumaTopology {
+    public:
+        /**
+         * @brief Get the topology of the machine, detected at the first call
+         * @return Reference to the topology
+         */
+        static const NumaTopology& get();
+
+        /**
+         * @brief Get the number of NUMA nodes with at least one allowed CPU
+         * @return Number of nodes
+         */
+        size_t getNodeCount() const { return nodes_.size(); }
+
+        /**
+         * @brief Get the CPUs belonging to a NUMA node
+         * @param node Index of the node
+         * @return List of CPU identifiers
+         */
+        const std::vector<unsigned int>& getCPUs(size_t node) const { return nodes_.at(node); }
+
+        /**
+         * @brief Pin the calling thread to a single CPU
+         * @param worker Number of the worker, consecutive workers are distributed round-robin over the nodes
+         * @return Index of the node the thread has been pinned to
+         */
+        size_t pinThread(unsigned int worker) const;
+
+        /**
+         * @brief Execute a function with the calling thread temporarily bound to the CPUs of a node
+         * @param node Index of the node
+         * @param function Function to execute, memory first touched by it is allocated on the node
+         */
+        void runOnNode(size_t node, const std::function<void()>& function) const;
+
+        /**
+         * @brief Get the node of the calling thread, as pinned or as determined from the CPU at its first call
+         * @return Index of the node
+         */
+        static size_t currentNode() noexcept {
+            if(current_node_ == std::numeric_limits<size_t>::max()) {
+                current_node_ = get().find_current_node();
+            }
+            return current_node_;
+        }
+
+        /**
+         * @brief Count an event processed on the node of the calling thread
+         */
+        static void countEvent() noexcept { events_[currentNode() % max_nodes]++; }
+
+        /**
+         * @brief Get the number of events processed on a node
+         * @param node Index of the node
+         * @return Number of events processed by threads on this node
+         */
+        static uint64_t getEvents(size_t node) noexcept { return events_[node % max_nodes].load(); }
+
+    private:
+        NumaTopology();
+
+        size_t find_current_node() const noexcept;
+
+        std::vector<std::vector<unsigned int>> nodes_;
+
+        static constexpr size_t max_nodes = 64;
+        static std::array<std::atomic<uint64_t>, max_nodes> events_;
+        static inline thread_local size_t current_node_{std::numeric_limits<size_t>::max()};
+    };
+
+    /**
+     * @brief Read-only array of doubles with one copy in the memory of every NUMA node
+     *
+     * Every replica is first touched by a thread bound to its node, such that the operating system allocates its pages
+     * locally. The replicas can optionally be backed by huge pages to reduce the TLB misses for large arrays.
+     */
+    class ReplicatedArray {
+    public:
+        /**
+         * @brief Copy data into replicas on the first NUMA nodes
+         * @param data Data to replicate
+         * @param replicas Number of replicas, assigned to the nodes in order
+         * @param huge_pages Back the replicas with huge pages, explicitly reserved ones if available and transparent ones
+         * otherwise
+         * @throws std::bad_alloc If the memory for a replica cannot be mapped
+         */
+        ReplicatedArray(const std::vector<double>& data, size_t replicas, bool huge_pages);
+
+        /**
+         * @brief Unmap the memory of all replicas
+         */
+        ~ReplicatedArray();
+
+        /// @{
+        /**
+         * @brief Replicas cannot be copied or moved
+         */
+        ReplicatedArray(const ReplicatedArray&) = delete;
+        ReplicatedArray& operator=(const ReplicatedArray&) = delete;
+        ReplicatedArray(ReplicatedArray&&) = delete;
+        ReplicatedArray& operator=(ReplicatedArray&&) = delete;
+        /// @}
+
+        /**
+         * @brief Get the replica of the node of the calling thread
+         * @return Pointer to the first element
+         */
+        const double* data() const noexcept { return replicas_[NumaTopology::currentNode() % replicas_.size()]; }
+
+        /**
+         * @brief Get the total memory mapped for all replicas
+         * @return Size in bytes
+         */
+        size_t getMappedSize() const { return mapped_size_ * replicas_.size(); }
+
+    private:
+        std::vector<double*> replicas_;
+        size_t mapped_size_{};
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_NUMA_H */
@@ -0,0 +1,205 @@
+/**
+ * @file
+ * @brief Pool of pre-generated random numbers filled in blocks for fast sampling
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_RANDOM_POOL_H
+#define ALLPIX_RANDOM_POOL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "core/utils/distributions.h"
+
+namespace allpix {
+
+    /**
+     * @brief Small and fast pseudo-random number engine of the xoshiro256++ family
+     *
+     * The engine fulfills the requirements of a uniform random bit generator and can be used with the standard library and
+     * Boost.Random distributions. Its state is seeded from a single 64-bit value via the splitmix64 generator as recommended
+     * by the authors, see https://prng.di.unimi.it/
+     */
+    class Xoshiro256PlusPlus {
+    public:
+        using result_type = std::uint64_t;
+
+        /**
+         * @brief Construct the engine from a seed
+         * @param seed Seed value
+         */
+        explicit Xoshiro256PlusPlus(std::uint64_t seed = 0) { this->seed(seed); }
+
+        /**
+         * @brief Seed the engine state from a single value
+         * @param seed Seed value
+         */
+        void seed(std::uint64_t seed) {
+            for(auto& s : state_) {
+                seed += 0x9e3779b97f4a7c15;
+                std::uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+                s = z ^ (z >> 31);
+            }
+        }
+
+        static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * @brief Advance the engine state
+         * @return 64-bit pseudo-random number
+         */
+        result_type operator()() {
+            const auto result = rotl(state_[0] + state_[3], 23) + state_[0];
+            const auto t = state_[1] << 17;
+
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = rotl(state_[3], 45);
+
+            return result;
+        }
+
+    private:
+        static std::uint64_t rotl(const std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        std::uint64_t state_[4]{};
+    };
+
+    /**
+     * @brief Pool of random numbers following uniform, normal and exponential distributions
+     *
+     * Random numbers are generated in blocks of configurable size and handed out one by one or in batches. Each distribution
+     * is backed by its own buffer which is only allocated when first used, and is refilled as a whole once exhausted. Normal
+     * and exponential numbers are obtained via the Ziggurat algorithm of Boost.Random from the fast xoshiro256++ engine,
+     * which is about twice as fast as sampling from the Mersenne Twister of the event.
+     *
+     * The pool is fully determined by its seed, the sequence of returned numbers is therefore reproducible as long as the
+     * order of requests is the same.
+     *
+     * @note The pool is not thread-safe, every event owns its own pool, see \ref Event::getRandomPool
+     */
+    class RandomNumberPool {
+    public:
+        /**
+         * @brief Construct a pool of random numbers
+         * @param seed Seed of the underlying random engine
+         * @param block_size Number of random numbers generated per refill of any distribution
+         */
+        explicit RandomNumberPool(std::uint64_t seed, std::size_t block_size = 256)
+            : engine_(seed), block_size_(std::max<std::size_t>(1, block_size)) {}
+
+        /**
+         * @brief Draw a uniformly distributed random number
+         * @return Random number in the interval [0, 1)
+         */
+        double uniform() { return next(uniform_, &RandomNumberPool::refill_uniform); }
+
+        /**
+         * @brief Draw a random number from a standard normal distribution
+         * @return Normally distributed random number with mean zero and unit standard deviation
+         */
+        double normal() { return next(normal_, &RandomNumberPool::refill_normal); }
+
+        /**
+         * @brief Draw a random number from an exponential distribution
+         * @return Exponentially distributed random number with unit mean
+         */
+        double exponential() { return next(exponential_, &RandomNumberPool::refill_exponential); }
+
+        /// @{
+        /**
+         * @brief Fill a range with random numbers of the respective distribution
+         * @param output Pointer to the first element to be filled
+         * @param count Number of elements to fill
+         */
+        void uniform(double* output, std::size_t count) { fill(output, count, uniform_, &RandomNumberPool::refill_uniform); }
+        void normal(double* output, std::size_t count) { fill(output, count, normal_, &RandomNumberPool::refill_normal); }
+        void exponential(double* output, std::size_t count) {
+            fill(output, count, exponential_, &RandomNumberPool::refill_exponential);
+        }
+        /// @}
+
+    private:
+        /**
+         * @brief Buffer of pre-generated numbers with the position of the next number to hand out
+         */
+        struct Block {
+            std::vector<double> values;
+            std::size_t index{0};
+        };
+        using Refill = void (RandomNumberPool::*)(std::vector<double>&);
+
+        double next(Block& block, Refill refill) {
+            if(block.index == block.values.size()) {
+                (this->*refill)(block.values);
+                block.index = 0;
+            }
+            return block.values[block.index++];
+        }
+
+        void fill(double* output, std::size_t count, Block& block, Refill refill) {
+            while(count > 0) {
+                if(block.index == block.values.size()) {
+                    (this->*refill)(block.values);
+                    block.index = 0;
+                }
+                auto available = std::min(count, block.values.size() - block.index);
+                std::copy_n(block.values.begin() + static_cast<std::ptrdiff_t>(block.index), available, output);
+                block.index += available;
+                output += available;
+                count -= available;
+            }
+        }
+
+        void refill_uniform(std::vector<double>& values) {
+            values.resize(block_size_);
+            for(auto& value : values) {
+                // Use the upper 53 bits to obtain a double with full mantissa precision
+                value = static_cast<double>(engine_() >> 11) * 0x1.0p-53;
+            }
+        }
+
+        void refill_normal(std::vector<double>& values) {
+            values.resize(block_size_);
+            for(auto& value : values) {
+                value = normal_distribution_(engine_);
+            }
+        }
+
+        void refill_exponential(std::vector<double>& values) {
+            values.resize(block_size_);
+            for(auto& value : values) {
+                value = exponential_distribution_(engine_);
+            }
+        }
+
+        Xoshiro256PlusPlus engine_;
+        std::size_t block_size_;
+
+        // Ziggurat-based distributions of unit width drawn from the fast engine
+        allpix::normal_distribution<double> normal_distribution_{0., 1.};
+        allpix::exponential_distribution<double> exponential_distribution_{1.};
+
+        Block uniform_;
+        Block normal_;
+        Block exponential_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_RANDOM_POOL_H */
@@ -226,6 +226,8 @@ void CSADigitizerModule::run(Event* event) {
     // Loop through all pixels with charges
     std::vector<PixelHit> hits;
     std::vector<PixelPulse> pulses;
+    // Hits refer to their pulse, reserve to keep the pulses in place
+    pulses.reserve(pixel_message->getData().size());
     for(const auto& pixel_charge : pixel_message->getData()) {
         auto pixel = pixel_charge.getPixel();
         auto pixel_index = pixel.getIndex();
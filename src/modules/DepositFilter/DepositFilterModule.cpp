@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @brief Implementation of DepositFilter module
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "DepositFilterModule.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/utils/log.h"
+
+using namespace allpix;
+
+DepositFilterModule::DepositFilterModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager)
+    : Module(config), geo_manager_(geo_manager), messenger_(messenger) {
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    // Bind to all deposits, but do not require them: events without any deposit should be filtered as well
+    messenger_->bindMulti<DepositedChargeMessage>(this);
+
+    config_.setDefault<unsigned int>("charge_threshold", 1);
+    config_.setDefault<unsigned int>("minimum_detectors", 1);
+
+    charge_threshold_ = config_.get<unsigned int>("charge_threshold");
+    minimum_detectors_ = config_.get<unsigned int>("minimum_detectors");
+}
+
+void DepositFilterModule::initialize() {
+
+    for(const auto& name : config_.getArray<std::string>("required_detectors", std::vector<std::string>())) {
+        if(!geo_manager_->hasDetector(name)) {
+            throw InvalidValueError(config_, "required_detectors", "detector " + name + " not defined");
+        }
+        required_detectors_.insert(name);
+    }
+
+    if(minimum_detectors_ > geo_manager_->getDetectors().size()) {
+        throw InvalidValueError(
+            config_, "minimum_detectors", "cannot require more detectors than present in the geometry, no event would pass");
+    }
+
+    // Region of interest in pixel indices, applied to all detectors
+    if(config_.count({"roi_min", "roi_max"}) == 1) {
+        throw InvalidCombinationError(
+            config_, {"roi_min", "roi_max"}, "both corners of the region of interest have to be provided");
+    }
+    if(config_.has("roi_min")) {
+        use_roi_ = true;
+        roi_min_ = config_.get<Pixel::Index>("roi_min");
+        roi_max_ = config_.get<Pixel::Index>("roi_max");
+        if(roi_min_.x() > roi_max_.x() || roi_min_.y() > roi_max_.y()) {
+            throw InvalidValueError(config_, "roi_max", "upper corner of region of interest below lower corner");
+        }
+        LOG(DEBUG) << "Only considering deposits in pixels between " << roi_min_ << " and " << roi_max_;
+    }
+
+    LOG(DEBUG) << "Requiring at least " << minimum_detectors_ << " detectors with " << charge_threshold_ << "e deposited";
+}
+
+bool DepositFilterModule::within_roi(const DepositedCharge& deposit, const std::shared_ptr<DetectorModel>& model) const {
+    if(!use_roi_) {
+        return true;
+    }
+
+    auto [xpixel, ypixel] = model->getPixelIndex(deposit.getLocalPosition());
+    return xpixel >= roi_min_.x() && xpixel <= roi_max_.x() && ypixel >= roi_min_.y() && ypixel <= roi_max_.y();
+}
+
+void DepositFilterModule::run(Event* event) {
+    auto messages = messenger_->fetchMultiMessage<DepositedChargeMessage>(this, event);
+
+    // Sum up deposited charge per detector
+    std::map<std::string, unsigned int> charge_per_detector;
+    for(const auto& message : messages) {
+        auto detector = message->getDetector();
+        auto& charge = charge_per_detector[detector->getName()];
+        for(const auto& deposit : message->getData()) {
+            if(within_roi(deposit, detector->getModel())) {
+                charge += deposit.getCharge();
+            }
+        }
+    }
+
+    // Count detectors above threshold and check for detectors required in coincidence
+    unsigned int detectors_above_threshold = 0;
+    for(const auto& [name, charge] : charge_per_detector) {
+        LOG(TRACE) << "Detector " << name << " has " << charge << "e deposited";
+        if(charge >= charge_threshold_) {
+            detectors_above_threshold++;
+        }
+    }
+
+    for(const auto& name : required_detectors_) {
+        auto it = charge_per_detector.find(name);
+        if(it == charge_per_detector.end() || it->second < charge_threshold_) {
+            rejected_events_++;
+            throw SkipEventException("Required detector " + name + " without sufficient deposited charge");
+        }
+    }
+
+    if(detectors_above_threshold < minimum_detectors_) {
+        rejected_events_++;
+        throw SkipEventException("Only " + std::to_string(detectors_above_threshold) +
+                                 " detectors with sufficient deposited charge, " + std::to_string(minimum_detectors_) +
+                                 " required");
+    }
+
+    LOG(DEBUG) << "Accepting event with " << detectors_above_threshold << " detectors above threshold";
+    accepted_events_++;
+}
+
+void DepositFilterModule::finalize() {
+    LOG(STATUS) << "Accepted " << accepted_events_ << " events, rejected " << rejected_events_ << " events";
+}
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Definition of DepositFilter module
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/GeometryManager.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
+#include "core/module/Module.hpp"
+
+#include "objects/DepositedCharge.hpp"
+#include "objects/Pixel.hpp"
+
+namespace allpix {
+    /**
+     * @ingroup Modules
+     * @brief Module to reject events without sufficient charge deposition before the propagation stage
+     *
+     * Sums up the deposited charge per detector, optionally restricted to a region of interest of the pixel matrix, and
+     * compares it to a threshold. The event is skipped if fewer detectors than required are above threshold or if one of
+     * the explicitly required detectors did not see sufficient charge. All modules following this module are then not
+     * executed for the rejected event.
+     */
+    class DepositFilterModule : public Module {
+    public:
+        /**
+         * @brief Constructor for this unique module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param geo_manager Pointer to the geometry manager, containing the detectors
+         */
+        DepositFilterModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager);
+
+        /**
+         * @brief Check the configured detectors and region of interest
+         */
+        void initialize() override;
+
+        /**
+         * @brief Evaluate the filter conditions on the deposited charges and skip the event if they are not met
+         */
+        void run(Event* event) override;
+
+        /**
+         * @brief Report the number of accepted and rejected events
+         */
+        void finalize() override;
+
+    private:
+        /**
+         * @brief Check whether a deposit is located within the configured region of interest
+         * @param deposit Deposited charge to check
+         * @param model Model of the detector the deposit belongs to
+         * @return True if the deposit is within the region of interest or no region has been configured
+         */
+        bool within_roi(const DepositedCharge& deposit, const std::shared_ptr<DetectorModel>& model) const;
+
+        GeometryManager* geo_manager_;
+        Messenger* messenger_;
+
+        // Filter conditions
+        unsigned int charge_threshold_{};
+        unsigned int minimum_detectors_{};
+        std::set<std::string> required_detectors_;
+        bool use_roi_{false};
+        Pixel::Index roi_min_;
+        Pixel::Index roi_max_;
+
+        // Statistics
+        std::atomic<uint64_t> accepted_events_{0};
+        std::atomic<uint64_t> rejected_events_{0};
+    };
+} // namespace allpix
@@ -12,15 +12,24 @@
 
 #include "DepositionGeant4Module.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <utility>
 
 #include <G4Box.hh>
 #include <G4EmParameters.hh>
+#include <G4FastSimulationPhysics.hh>
 #include <G4HadronicParameters.hh>
 #include <G4HadronicProcessStore.hh>
 #include <G4LogicalVolume.hh>
+#include <G4Material.hh>
 #include <G4NuclearLevelData.hh>
 #include <G4PhysListFactory.hh>
 #include <G4ProcessTable.hh>
@@ -28,6 +37,8 @@
 #include <G4StepLimiterPhysics.hh>
 #include <G4UImanager.hh>
 #include <G4UserLimits.hh>
+#include <G4VModularPhysicsList.hh>
+#include <G4Version.hh>
 
 #include "G4FieldManager.hh"
 #include "G4TransportationManager.hh"
@@ -37,6 +48,7 @@
 #include "core/geometry/GeometryManager.hpp"
 #include "core/geometry/RadialStripDetectorModel.hpp"
 #include "core/module/exceptions.h"
+#include "core/utils/hash.h"
 #include "core/utils/log.h"
 #include "objects/DepositedCharge.hpp"
 #include "physics/MaterialProperties.hpp"
@@ -48,6 +60,7 @@
 #include "AdditionalPhysicsLists.hpp"
 
 #include "ActionInitializationG4.hpp"
+#include "FastSimulationModelsG4.hpp"
 #include "GeneratorActionG4.hpp"
 #include "SDAndFieldConstruction.hpp"
 #include "SensitiveDetectorActionG4.hpp"
@@ -87,6 +100,20 @@ DepositionGeant4Module::DepositionGeant4Module(Configuration& config, Messenger*
     config_.setDefault<bool>("deposit_in_frontside_implants", true);
     config_.setDefault<bool>("deposit_in_backside_implants", false);
 
+    // Defaults for merging of deposits
+    config_.setDefault<bool>("merge_deposits", false);
+    config_.setDefault<ROOT::Math::XYZVector>("merging_voxel_size",
+                                              {Units::get(0.5, "um"), Units::get(0.5, "um"), Units::get(0.5, "um")});
+    config_.setDefault<double>("merging_time_window", Units::get(0.1, "ns"));
+
+    // Reserve the thread numbers of the sub-event threads already now, since other modules size their per-thread storage
+    // during initialization, possibly before the threads are started in initialize()
+    config_.setDefault<unsigned int>("number_of_subevents", 1);
+    auto number_of_subevents = config_.get<unsigned int>("number_of_subevents");
+    if(number_of_subevents > 1) {
+        ThreadPool::registerThreadCount(config_.get<unsigned int>("subevent_threads", number_of_subevents - 1));
+    }
+
     // Create user limits for maximum step length and maximum event time in the sensor
     user_limits_ =
         std::make_unique<G4UserLimits>(config_.get<double>("max_step_length"), DBL_MAX, config_.get<double>("cutoff_time"));
@@ -126,6 +153,16 @@ void DepositionGeant4Module::initialize() {
     number_of_particles_ = config_.get<unsigned int>("number_of_particles", 1);
     output_plots_ = config_.get<bool>("output_plots");
 
+    // Split events into sub-events simulated in parallel
+    number_of_subevents_ = config_.get<unsigned int>("number_of_subevents");
+    if(number_of_subevents_ == 0) {
+        throw InvalidValueError(config_, "number_of_subevents", "number of sub-events has to be at least one");
+    }
+    if(number_of_subevents_ > 1 && !multithreadingEnabled()) {
+        throw InvalidValueError(
+            config_, "number_of_subevents", "sub-events can only be simulated in parallel with multithreading enabled");
+    }
+
     // Load the G4 run manager (which is owned by the geometry builder)
     if(multithreadingEnabled()) {
         run_manager_g4_ = G4MTRunManager::GetMasterRunManager();
@@ -289,6 +326,12 @@ void DepositionGeant4Module::initialize() {
     }
     user_limits_world_->SetUserMinEkine(min_charge_creation_energy);
 
+    // Reuse physics tables stored by previous runs with identical physics configuration
+    physics_list_ = physicsList;
+    if(config_.has("physics_table_directory")) {
+        setup_physics_tables(physics_list, production_cut);
+    }
+
     // Set user limits on world volume:
     auto world_log_volume = geo_manager_->getExternalObject<G4LogicalVolume>("", "world_log");
     if(world_log_volume != nullptr) {
@@ -304,6 +347,11 @@ void DepositionGeant4Module::initialize() {
         world_log_volume->GetRegion()->SetUserLimits(user_limits_world_.get());
     }
 
+    // Parameterize the transport through the selected volumes with fast simulation models
+    if(config_.has("fast_simulation_volumes")) {
+        setup_fast_simulation(physicsList);
+    }
+
     // Initialize the physics list
     LOG(TRACE) << "Initializing physics processes";
     run_manager_g4_->SetUserInitialization(physicsList);
@@ -336,10 +384,149 @@ void DepositionGeant4Module::initialize() {
         run_manager_mt->SetSDAndFieldConstruction(std::move(detector_construction));
     }
 
+    // Start the threads for sub-events, which are initialized like the threads of the framework
+    if(number_of_subevents_ > 1) {
+        auto subevent_threads = config_.get<unsigned int>("subevent_threads", number_of_subevents_ - 1);
+        LOG(INFO) << "Splitting events into " << number_of_subevents_ << " sub-events, simulated on " << subevent_threads
+                  << " additional threads";
+
+        // Without additional threads, the sub-events are simulated sequentially on the already initialized calling thread
+        std::function<void()> init_function, finalize_function;
+        if(subevent_threads > 0) {
+            init_function = [this]() { initializeThread(); };
+            finalize_function = [this]() { finalizeThread(); };
+        }
+        subevent_pool_ = std::make_unique<ThreadPool>(
+            subevent_threads, std::max(subevent_threads, 1u) * 128, init_function, finalize_function);
+    }
+
     // Flush the Geant4 stream buffer because some elements in the initialization never do:
     G4cout << G4endl;
 }
 
+/**
+ * The physics tables depend on the Geant4 version, the physics list and its options, the production cuts and the materials
+ * present in the geometry. All of these are combined into a key, and the tables are stored in a subdirectory named after the
+ * hash of the key. The full key is stored alongside the tables to detect hash collisions.
+ */
+void DepositionGeant4Module::setup_physics_tables(const std::string& physics_list, double production_cut) {
+    std::stringstream key;
+    key << std::setprecision(17) << "Geant4 " << G4VERSION_NUMBER << "\nphysics_list=" << physics_list
+        << "\nenable_pai=" << config_.get<bool>("enable_pai", false)
+        << "\npai_model=" << config_.get<std::string>("pai_model") << "\nproduction_cut=" << production_cut;
+    for(const auto* material : *G4Material::GetMaterialTable()) {
+        key << "\nmaterial=" << material->GetName() << "," << material->GetDensity() << ","
+            << material->GetNumberOfElements();
+    }
+    physics_table_key_ = key.str();
+
+    FNV1aHash hash;
+    hash.add(physics_table_key_.data(), physics_table_key_.size());
+    std::stringstream name;
+    name << std::hex << hash.value();
+    physics_table_directory_ = config_.getPath("physics_table_directory") / name.str();
+
+    std::ifstream key_file(physics_table_directory_ / "physics.key");
+    if(key_file.is_open()) {
+        std::string cached_key((std::istreambuf_iterator<char>(key_file)), std::istreambuf_iterator<char>());
+        if(cached_key == physics_table_key_) {
+            LOG(INFO) << "Retrieving physics tables from " << physics_table_directory_;
+            physics_list_->SetPhysicsTableRetrieved(physics_table_directory_.string());
+            return;
+        }
+        LOG(WARNING) << "Physics tables in " << physics_table_directory_
+                     << " belong to a different configuration, tables are rebuilt";
+    }
+
+    LOG(INFO) << "No stored physics tables found for the current configuration, storing them after the run";
+    store_physics_tables_ = true;
+}
+
+/**
+ * Every configured volume is assigned to a region to which the fast simulation models of all threads are attached. Sensors
+ * are selected by the name of their detector, passive volumes by the name of the passive element. For passive elements
+ * read from GDML files, all top-level volumes of the file are parameterized.
+ */
+void DepositionGeant4Module::setup_fast_simulation(G4VModularPhysicsList* physics_list) {
+    auto volumes = config_.getArray<std::string>("fast_simulation_volumes");
+    auto models = config_.getArray<std::string>("fast_simulation_models");
+    auto thresholds = config_.getArray<double>("fast_simulation_energy_thresholds",
+                                               std::vector<double>(volumes.size(), Units::get(1.0, "MeV")));
+    if(models.size() != volumes.size() || thresholds.size() != volumes.size()) {
+        throw InvalidCombinationError(
+            config_,
+            {"fast_simulation_volumes", "fast_simulation_models", "fast_simulation_energy_thresholds"},
+            "a model and an energy threshold are required for every volume");
+    }
+
+    for(size_t i = 0; i < volumes.size(); ++i) {
+        auto model = allpix::transform(models[i], ::tolower);
+        if(model != "absorber" && model != "sensor") {
+            throw InvalidValueError(config_, "fast_simulation_models", "model has to be either 'absorber' or 'sensor'");
+        }
+        if(thresholds[i] <= 0) {
+            throw InvalidValueError(config_, "fast_simulation_energy_thresholds", "energy thresholds need to be positive");
+        }
+
+        std::vector<std::shared_ptr<G4LogicalVolume>> logical_volumes;
+        if(geo_manager_->hasDetector(volumes[i])) {
+            if(model != "sensor") {
+                throw InvalidValueError(config_,
+                                        "fast_simulation_models",
+                                        "detector '" + volumes[i] + "' can only be parameterized with the 'sensor' model");
+            }
+            logical_volumes.push_back(geo_manager_->getExternalObject<G4LogicalVolume>(volumes[i], "sensor_log"));
+        } else {
+            if(model != "absorber") {
+                throw InvalidValueError(config_,
+                                        "fast_simulation_models",
+                                        "passive volume '" + volumes[i] +
+                                            "' can only be parameterized with the 'absorber' model");
+            }
+            logical_volumes =
+                geo_manager_->getExternalObjects<G4LogicalVolume>(volumes[i], std::regex("passive_material_log.*"));
+        }
+        if(logical_volumes.empty() || logical_volumes.front() == nullptr) {
+            throw InvalidValueError(
+                config_, "fast_simulation_volumes", "no detector or passive volume named '" + volumes[i] + "' found");
+        }
+
+        // Reuse regions already defined for a single volume, such as the sensor regions of the PAI model
+        G4Region* region = nullptr;
+        if(logical_volumes.size() == 1 && logical_volumes.front()->IsRootRegion()) {
+            region = logical_volumes.front()->GetRegion();
+            if(region->GetNumberOfRootVolumes() > 1) {
+                throw InvalidValueError(config_,
+                                        "fast_simulation_volumes",
+                                        "volume '" + volumes[i] + "' shares the region '" + region->GetName() +
+                                            "' with other volumes and cannot be parameterized");
+            }
+        } else {
+            region = new G4Region(volumes[i] + "_fast_simulation_region");
+            for(auto& logical_volume : logical_volumes) {
+                region->AddRootLogicalVolume(logical_volume.get());
+            }
+        }
+
+        // Passive volumes leave the world region and need its limits on the event time and track length
+        if(model == "absorber") {
+            region->SetUserLimits(user_limits_world_.get());
+        }
+
+        LOG(INFO) << "Parameterizing " << volumes[i] << " with fast simulation model \"" << model
+                  << "\" above " << Units::display(thresholds[i], {"keV", "MeV", "GeV"});
+        fast_simulation_regions_.push_back({region, model, thresholds[i]});
+    }
+
+    auto* fast_simulation_physics = new G4FastSimulationPhysics();
+    for(const auto* particle :
+        {"e-", "e+", "gamma", "mu-", "mu+", "pi-", "pi+", "kaon-", "kaon+", "proton", "anti_proton"}) {
+        fast_simulation_physics->ActivateFastSimulation(particle);
+    }
+    LOG(DEBUG) << "Registering Geant4 fast simulation physics";
+    physics_list->RegisterPhysics(fast_simulation_physics);
+}
+
 void DepositionGeant4Module::initialize_g4_action() {
     auto* action_initialization =
         new ActionInitializationG4<GeneratorActionG4, GeneratorActionInitializationMaster>(config_);
@@ -370,24 +557,59 @@ void DepositionGeant4Module::initializeThread() {
 
 void DepositionGeant4Module::run(Event* event) {
 
-    // Seed the sensitive detectors RNG
-    for(auto& sensor : sensors_) {
-        sensor->seed(event->getRandomNumber());
+    // Draw the seeds of all Geant4 runs in a fixed order on the calling thread, such that the results of split events
+    // depend neither on the number of sub-events nor on the number of threads. Every set holds the seeds for the sensitive
+    // detectors followed by the two seeds for Geant4
+    std::vector<std::vector<uint64_t>> seeds(number_of_seed_sets());
+    for(auto& seed_set : seeds) {
+        for(size_t i = 0; i < sensors_.size() + 2; ++i) {
+            seed_set.push_back(event->getRandomNumber());
+        }
+    }
+    auto subevent_seeds = [&](unsigned int subevent) {
+        auto first = seeds.size() * subevent / number_of_subevents_;
+        auto last = seeds.size() * (subevent + 1) / number_of_subevents_;
+        return std::vector<std::vector<uint64_t>>(seeds.begin() + static_cast<std::ptrdiff_t>(first),
+                                                  seeds.begin() + static_cast<std::ptrdiff_t>(last));
+    };
+
+    // Submit all but the first sub-event to the sub-event threads
+    std::vector<std::shared_future<std::shared_ptr<SubEventResult>>> subevents;
+    for(unsigned int subevent = 1; subevent < number_of_subevents_; ++subevent) {
+        subevents.push_back(subevent_pool_->submit([this, subevent, seeds = subevent_seeds(subevent)]() {
+            return simulate_subevent(subevent, seeds);
+        }));
+    }
+    if(subevent_pool_ != nullptr) {
+        subevent_pool_->checkException();
     }
-
-    // Start a single event from the beam
-    LOG(TRACE) << "Enabling beam";
-    auto seed1 = event->getRandomNumber();
-    auto seed2 = event->getRandomNumber();
-    LOG(DEBUG) << "Seeding Geant4 event with seeds " << seed1 << " " << seed2;
 
     try {
-        if(multithreadingEnabled()) {
-            auto* run_manager_mt = static_cast<MTRunManager*>(run_manager_g4_);
-            run_manager_mt->Run(static_cast<int>(number_of_particles_), seed1, seed2);
-        } else {
-            auto* run_manager = static_cast<RunManager*>(run_manager_g4_);
-            run_manager->Run(static_cast<int>(number_of_particles_), seed1, seed2);
+        // Simulate the first sub-event on this thread, but wait for all other sub-events before propagating failures
+        std::exception_ptr exception;
+        try {
+            run_subevent(0, subevent_seeds(0));
+        } catch(...) {
+            exception = std::current_exception();
+        }
+
+        // Merge the tracks and deposits of the other sub-events in order
+        for(auto& subevent : subevents) {
+            const auto& result = subevent.get();
+            if(exception == nullptr) {
+                exception = result->exception;
+            }
+            if(exception != nullptr) {
+                continue;
+            }
+
+            auto offset = track_info_manager_->mergeTrackInfo(std::move(*result->tracks));
+            for(size_t i = 0; i < sensors_.size(); ++i) {
+                sensors_[i]->mergeEventInfo(std::move(result->sensors[i]), offset);
+            }
+        }
+        if(exception != nullptr) {
+            std::rethrow_exception(exception);
         }
 
         uint64_t last_event_num = last_event_num_.load();
@@ -418,7 +640,6 @@ void DepositionGeant4Module::run(Event* event) {
         for(auto& sensor : sensors_) {
             sensor->clearEventInfo();
         }
-        run_manager_g4_->AbortRun();
         track_info_manager_->resetTrackInfoManager();
         throw;
     }
@@ -426,7 +647,72 @@ void DepositionGeant4Module::run(Event* event) {
     track_info_manager_->resetTrackInfoManager();
 }
 
+/**
+ * Without splitting, all primary particles are simulated in a single Geant4 run as before. Otherwise, every particle is
+ * simulated in its own Geant4 run with its own seeds.
+ */
+void DepositionGeant4Module::run_subevent(unsigned int, const std::vector<std::vector<uint64_t>>& seeds) {
+    if(number_of_subevents_ == 1) {
+        beam_on(seeds.front(), number_of_particles_);
+        return;
+    }
+
+    for(const auto& seed_set : seeds) {
+        beam_on(seed_set);
+    }
+}
+
+/**
+ * The sensitive detectors and Geant4 are seeded for every Geant4 run, such that the simulated particles do not depend on
+ * the Geant4 events simulated before on the same thread.
+ */
+void DepositionGeant4Module::beam_on(const std::vector<uint64_t>& seeds, unsigned int number_of_events) {
+    for(size_t i = 0; i < sensors_.size(); ++i) {
+        sensors_[i]->seed(seeds[i]);
+    }
+    auto seed1 = seeds[sensors_.size()];
+    auto seed2 = seeds[sensors_.size() + 1];
+    LOG(DEBUG) << "Seeding Geant4 event with seeds " << seed1 << " " << seed2;
+
+    try {
+        if(multithreadingEnabled()) {
+            auto* run_manager_mt = static_cast<MTRunManager*>(run_manager_g4_);
+            run_manager_mt->Run(static_cast<int>(number_of_events), seed1, seed2);
+        } else {
+            auto* run_manager = static_cast<RunManager*>(run_manager_g4_);
+            run_manager->Run(static_cast<int>(number_of_events), seed1, seed2);
+        }
+    } catch(AbortEventException& e) {
+        run_manager_g4_->AbortRun();
+        throw;
+    }
+}
+
+/**
+ * Runs on a thread of the sub-event pool. The tracks and deposits are moved out of the thread-local instances, since the
+ * thread continues with sub-events of other events before the calling thread merges them.
+ */
+std::shared_ptr<DepositionGeant4Module::SubEventResult>
+DepositionGeant4Module::simulate_subevent(unsigned int subevent, const std::vector<std::vector<uint64_t>>& seeds) {
+    auto result = std::make_shared<SubEventResult>();
+    try {
+        run_subevent(subevent, seeds);
+    } catch(...) {
+        result->exception = std::current_exception();
+    }
+
+    result->tracks = std::make_unique<TrackInfoManager>(config_.get<bool>("record_all_tracks"));
+    std::swap(*result->tracks, *track_info_manager_);
+    for(auto& sensor : sensors_) {
+        result->sensors.push_back(sensor->takeEventInfo());
+    }
+    return result;
+}
+
 void DepositionGeant4Module::finalize() {
+    // Stop the sub-event threads, which adds their statistics
+    subevent_pool_.reset();
+
     if(output_plots_) {
         // Write histograms
         LOG(TRACE) << "Writing output plots to file";
@@ -441,6 +727,23 @@ void DepositionGeant4Module::finalize() {
         }
     }
 
+    // Store the physics tables, which are only built after the first event in single-threaded mode
+    if(store_physics_tables_ && (multithreadingEnabled() || last_event_num_ > 0)) {
+        std::error_code error;
+        std::filesystem::create_directories(physics_table_directory_, error);
+        if(error) {
+            LOG(WARNING) << "Cannot create physics table directory " << physics_table_directory_ << ": "
+                         << error.message();
+        } else {
+            LOG(INFO) << "Storing physics tables in " << physics_table_directory_;
+            physics_list_->StorePhysicsTable(physics_table_directory_.string());
+
+            // Write the key last to only mark complete sets of tables as valid
+            std::ofstream key_file(physics_table_directory_ / "physics.key");
+            key_file << physics_table_key_;
+        }
+    }
+
     // Print summary or warns if module did not output any charges
     if(number_of_sensors_ > 0 && total_charges_ > 0 && last_event_num_ > 0) {
         size_t average_charge = total_charges_ / number_of_sensors_ / last_event_num_;
@@ -506,6 +809,20 @@ void DepositionGeant4Module::construct_sensitive_detectors_and_fields() {
         // Get model of the sensitive device
         auto* sensitive_detector_action = new SensitiveDetectorActionG4(
             detector, track_info_manager_.get(), charge_creation_energy, fano_factor, cutoff_time);
+        if(config_.get<bool>("merge_deposits")) {
+            auto voxel_size = config_.get<ROOT::Math::XYZVector>("merging_voxel_size");
+            auto time_window = config_.get<double>("merging_time_window");
+            if(voxel_size.x() <= 0 || voxel_size.y() <= 0 || voxel_size.z() <= 0) {
+                throw InvalidValueError(config_, "merging_voxel_size", "voxel size needs to be positive");
+            }
+            if(time_window <= 0) {
+                throw InvalidValueError(config_, "merging_time_window", "time window needs to be positive");
+            }
+            LOG(DEBUG) << "Merging deposits in " << detector->getName() << " within voxels of "
+                       << Units::display(voxel_size, {"nm", "um"}) << " and time windows of "
+                       << Units::display(time_window, {"ps", "ns"});
+            sensitive_detector_action->setDepositMerging(voxel_size, time_window);
+        }
         auto logical_volume = geo_manager_->getExternalObject<G4LogicalVolume>(detector->getName(), "sensor_log");
         if(logical_volume == nullptr) {
             throw ModuleError("Detector " + detector->getName() + " has no sensitive device (broken Geant4 geometry)");
@@ -589,6 +906,18 @@ void DepositionGeant4Module::construct_sensitive_detectors_and_fields() {
         }
     }
 
+    // Create the fast simulation models of this thread, which register themselves with the regions
+    for(const auto& fast_simulation : fast_simulation_regions_) {
+        auto name = fast_simulation.region->GetName() + "_" + fast_simulation.model;
+        LOG(DEBUG) << "Attaching fast simulation model " << name;
+        if(fast_simulation.model == "absorber") {
+            new AbsorberModelG4(name, fast_simulation.region, fast_simulation.energy_threshold);
+        } else {
+            new SensorModelG4(
+                name, fast_simulation.region, fast_simulation.energy_threshold, config_.get<double>("max_step_length"));
+        }
+    }
+
     if(!useful_deposition) {
         LOG(ERROR) << "Not a single listener for deposited charges, module is useless!";
     }
@@ -13,8 +13,11 @@
 #define ALLPIX_SIMPLE_DEPOSITION_MODULE_H
 
 #include <atomic>
+#include <exception>
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <G4UserLimits.hh>
 
@@ -23,6 +26,7 @@
 #include "core/messenger/Messenger.hpp"
 #include "core/module/Event.hpp"
 #include "core/module/Module.hpp"
+#include "core/module/ThreadPool.hpp"
 
 #include "SensitiveDetectorActionG4.hpp"
 #include "TrackInfoManager.hpp"
@@ -32,8 +36,10 @@
 #include <TH1D.h>
 #include <TH2D.h>
 
+class G4Region;
 class G4UserLimits;
 class G4RunManager;
+class G4VModularPhysicsList;
 
 namespace allpix {
     /**
@@ -92,7 +98,53 @@ namespace allpix {
 
         virtual void initialize_g4_action();
 
+        /**
+         * @brief Number of Geant4 events simulated for every event, each with its own set of seeds
+         *
+         * Without splitting, all primary particles are simulated in a single Geant4 event. When events are split into
+         * sub-events, every primary particle is simulated as a separate Geant4 event, such that the results do not depend on
+         * how the particles are divided into sub-events.
+         */
+        virtual unsigned int number_of_seed_sets() const { return number_of_subevents_ > 1 ? number_of_particles_ : 1; }
+
+        /**
+         * @brief Simulate one sub-event of the current event on the calling thread
+         * @param subevent Index of the sub-event
+         * @param seeds Sets of seeds of the Geant4 events belonging to this sub-event
+         *
+         * The Geant4 events of the event, and with them their sets of seeds, are distributed evenly over the sub-events.
+         */
+        virtual void run_subevent(unsigned int subevent, const std::vector<std::vector<uint64_t>>& seeds);
+
+        /**
+         * @brief Run Geant4 events on the run manager of the calling thread
+         * @param seeds Seeds for the sensitive detectors followed by the two seeds for the Geant4 random number generator
+         * @param number_of_events Number of Geant4 events to run with these seeds
+         */
+        void beam_on(const std::vector<uint64_t>& seeds, unsigned int number_of_events = 1);
+
+        // Number of sub-events every event is split into
+        unsigned int number_of_subevents_{1};
+
     private:
+        /**
+         * @brief Tracks and deposits of a sub-event simulated by the sub-event thread pool
+         */
+        struct SubEventResult {
+            std::unique_ptr<TrackInfoManager> tracks;
+            std::vector<SensitiveDetectorActionG4::EventInfo> sensors;
+            std::exception_ptr exception;
+        };
+
+        /**
+         * @brief Simulate a sub-event on a thread of the sub-event thread pool
+         * @param subevent Index of the sub-event
+         * @param seeds Sets of seeds of the Geant4 events belonging to this sub-event
+         * @return Tracks and deposits of the sub-event or the exception thrown during its simulation
+         */
+        std::shared_ptr<SubEventResult> simulate_subevent(unsigned int subevent,
+                                                          const std::vector<std::vector<uint64_t>>& seeds);
+
         /**
          * @brief Construct the sensitive detectors and magnetic fields.
          */
@@ -103,6 +155,30 @@ namespace allpix {
          */
         void record_module_statistics();
 
+        /**
+         * @brief Select the directory of stored physics tables for the current physics configuration
+         * @param physics_list Name of the physics list
+         * @param production_cut Range cut for the production of secondaries
+         *
+         * Enables the retrieval of the physics tables if they have been stored before, otherwise marks them for storage.
+         */
+        void setup_physics_tables(const std::string& physics_list, double production_cut);
+
+        /**
+         * @brief Create the regions for the volumes with fast simulation models and enable the fast simulation physics
+         * @param physics_list Physics list to register the fast simulation physics with
+         */
+        void setup_fast_simulation(G4VModularPhysicsList* physics_list);
+
+        /**
+         * @brief Region of volumes to parameterize with one of the fast simulation models
+         */
+        struct FastSimulationRegion {
+            G4Region* region;
+            std::string model;
+            double energy_threshold;
+        };
+
         // Configuration parameters:
         bool output_plots_{};
         unsigned int number_of_particles_{};
@@ -116,6 +192,18 @@ namespace allpix {
         // Number of the last event
         std::atomic_uint64_t last_event_num_{0};
 
+        // Physics list and storage of its physics tables
+        G4VModularPhysicsList* physics_list_{};
+        std::filesystem::path physics_table_directory_;
+        std::string physics_table_key_;
+        bool store_physics_tables_{};
+
+        // Regions with fast simulation models, the models themselves are created per thread
+        std::vector<FastSimulationRegion> fast_simulation_regions_;
+
+        // Threads simulating sub-events in parallel, each with its own Geant4 worker run manager
+        std::unique_ptr<ThreadPool> subevent_pool_;
+
         // Class holding the limits for the step size
         std::unique_ptr<G4UserLimits> user_limits_;
         std::unique_ptr<G4UserLimits> user_limits_world_;
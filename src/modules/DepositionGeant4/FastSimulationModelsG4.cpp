@@ -0,0 +1,250 @@
+/**
+ * @file
+ * @brief Implements Geant4 fast simulation models to parameterize the particle transport through passive and sensor volumes
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "FastSimulationModelsG4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <G4DynamicParticle.hh>
+#include <G4Electron.hh>
+#include <G4Gamma.hh>
+#include <G4GeometryTolerance.hh>
+#include <G4IonisParamMat.hh>
+#include <G4Material.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4Positron.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+using namespace allpix;
+
+namespace {
+    // Maximum number of steps for the transport through a passive volume within a single call
+    constexpr unsigned int max_absorber_steps = 1000;
+
+    /**
+     * @brief Distance from the current position of the track to the surface of its volume along its direction
+     * @param fast_track Track in the volume
+     * @return Distance to the surface, in local coordinates of the volume
+     */
+    double distance_to_out(const G4FastTrack& fast_track) {
+        return fast_track.GetEnvelopeSolid()->DistanceToOut(fast_track.GetPrimaryTrackLocalPosition(),
+                                                            fast_track.GetPrimaryTrackLocalDirection());
+    }
+
+    /**
+     * @brief Width of the multiple scattering angle after the Highland formula
+     * @param momentum Momentum of the particle
+     * @param beta Velocity of the particle
+     * @param charge Charge of the particle in units of the elementary charge
+     * @param thickness Traversed thickness in units of the radiation length
+     * @return Width of the projected scattering angle
+     */
+    double highland_angle(double momentum, double beta, double charge, double thickness) {
+        if(thickness <= 0) {
+            return 0;
+        }
+        auto correction = 1 + 0.038 * std::log(thickness * charge * charge / (beta * beta));
+        return 13.6 * MeV / (beta * momentum) * std::fabs(charge) * std::sqrt(thickness) * std::max(correction, 0.);
+    }
+
+    /**
+     * @brief Deflect a direction by Gaussian distributed projected angles
+     * @param direction Direction to deflect
+     * @param theta Width of the projected angles
+     * @return Deflected direction
+     */
+    G4ThreeVector scatter(const G4ThreeVector& direction, double theta) {
+        auto axis_u = direction.orthogonal().unit();
+        auto axis_v = direction.cross(axis_u);
+        return (direction + std::tan(G4RandGauss::shoot(0., theta)) * axis_u +
+                std::tan(G4RandGauss::shoot(0., theta)) * axis_v)
+            .unit();
+    }
+} // namespace
+
+AbsorberModelG4::AbsorberModelG4(const G4String& name, G4Region* region, double energy_threshold)
+    : G4VFastSimulationModel(name, region), energy_threshold_(energy_threshold) {}
+
+G4bool AbsorberModelG4::IsApplicable(const G4ParticleDefinition& particle) {
+    return particle.GetPDGCharge() != 0 || &particle == G4Gamma::Definition();
+}
+
+G4bool AbsorberModelG4::ModelTrigger(const G4FastTrack& fast_track) {
+    return distance_to_out(fast_track) > G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+}
+
+void AbsorberModelG4::DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step) {
+    const auto* track = fast_track.GetPrimaryTrack();
+    const auto* particle = track->GetDefinition();
+    const auto* solid = fast_track.GetEnvelopeSolid();
+    const auto* material = fast_track.GetEnvelopeMaterial();
+
+    auto position = fast_track.GetPrimaryTrackLocalPosition();
+    auto direction = fast_track.GetPrimaryTrackLocalDirection();
+    auto energy = track->GetKineticEnergy();
+    auto time = track->GetGlobalTime();
+
+    // Photons either cross the volume without interaction or are absorbed
+    if(particle == G4Gamma::Definition()) {
+        auto distance = solid->DistanceToOut(position, direction);
+        auto attenuation_length = calculator_.ComputeGammaAttenuationLength(energy, material);
+        if(G4UniformRand() < std::exp(-distance / attenuation_length)) {
+            fast_step.ProposePrimaryTrackFinalPosition(position + distance * direction);
+            fast_step.ProposePrimaryTrackFinalTime(time + distance / c_light);
+            fast_step.ProposePrimaryTrackPathLength(distance);
+        } else {
+            fast_step.KillPrimaryTrack();
+            fast_step.ProposeTotalEnergyDeposited(energy);
+        }
+        return;
+    }
+
+    auto mass = particle->GetPDGMass();
+    auto charge = particle->GetPDGCharge() / eplus;
+    auto is_electron = (particle == G4Electron::Definition() || particle == G4Positron::Definition());
+    auto is_hadron = (particle->GetBaryonNumber() != 0 || particle->GetParticleType() == "meson");
+    auto radiation_length = material->GetRadlen();
+    auto interaction_length = material->GetNuclearInterLength();
+    auto tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+
+    // Photons radiated by electrons and positrons, emitted as secondary particles after the transport
+    struct RadiatedPhoton {
+        G4ThreeVector position;
+        G4ThreeVector direction;
+        double energy;
+        double time;
+    };
+    std::vector<RadiatedPhoton> photons;
+
+    double path_length = 0;
+    double deposited_energy = 0;
+    for(unsigned int n = 0; n < max_absorber_steps && energy > energy_threshold_; ++n) {
+        auto distance = solid->DistanceToOut(position, direction);
+        if(distance < tolerance) {
+            break;
+        }
+
+        // Limit the step to lose at most a tenth of the energy by ionization
+        auto dedx = calculator_.ComputeElectronicDEDX(energy, particle, material);
+        auto step = (dedx > 0 ? std::min(distance, 0.1 * energy / dedx) : distance);
+
+        auto momentum = std::sqrt(energy * (energy + 2 * mass));
+        auto beta = momentum / (energy + mass);
+        position += step * direction;
+        path_length += step;
+        time += step / (beta * c_light);
+
+        // Hadrons are absorbed in nuclear interactions
+        if(is_hadron && G4UniformRand() > std::exp(-step / interaction_length)) {
+            deposited_energy += energy;
+            energy = 0;
+            break;
+        }
+
+        auto loss = std::min(energy, dedx * step);
+        energy -= loss;
+        deposited_energy += loss;
+
+        if(is_electron && energy > 0) {
+            // Remaining energy fraction after bremsstrahlung follows the Bethe-Heitler distribution. The radiated energy is
+            // emitted as a single photon along the direction of the particle, soft photons are absorbed locally.
+            auto radiated = energy * (1 - std::exp(-CLHEP::RandGamma::shoot(step / radiation_length / std::log(2.), 1.)));
+            energy -= radiated;
+            if(radiated > energy_threshold_) {
+                photons.push_back({position, direction, radiated, time});
+            } else {
+                deposited_energy += radiated;
+            }
+        }
+
+        // Only deflect the particle if it has not yet reached the surface
+        if(step < distance) {
+            direction = scatter(direction, highland_angle(momentum, beta, charge, step / radiation_length));
+        }
+    }
+
+    if(energy <= energy_threshold_) {
+        deposited_energy += energy;
+        fast_step.KillPrimaryTrack();
+    } else {
+        fast_step.ProposePrimaryTrackFinalPosition(position);
+        fast_step.ProposePrimaryTrackFinalMomentumDirection(direction);
+        fast_step.ProposePrimaryTrackFinalKineticEnergy(energy);
+        fast_step.ProposePrimaryTrackFinalTime(time);
+    }
+    fast_step.ProposePrimaryTrackPathLength(path_length);
+    fast_step.ProposeTotalEnergyDeposited(deposited_energy);
+
+    // Radiated photons are transported further by this model if they are created within the volume
+    fast_step.SetNumberOfSecondaryTracks(static_cast<G4int>(photons.size()));
+    for(const auto& photon : photons) {
+        G4DynamicParticle dynamic_particle(G4Gamma::Definition(), photon.direction, photon.energy);
+        fast_step.CreateSecondaryTrack(dynamic_particle, photon.position, photon.time);
+    }
+}
+
+SensorModelG4::SensorModelG4(const G4String& name, G4Region* region, double energy_threshold, double max_step_length)
+    : G4VFastSimulationModel(name, region), energy_threshold_(energy_threshold), max_step_length_(max_step_length) {}
+
+G4bool SensorModelG4::IsApplicable(const G4ParticleDefinition& particle) { return particle.GetPDGCharge() != 0; }
+
+G4bool SensorModelG4::ModelTrigger(const G4FastTrack& fast_track) {
+    return fast_track.GetPrimaryTrack()->GetKineticEnergy() > energy_threshold_ &&
+           distance_to_out(fast_track) > G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+}
+
+void SensorModelG4::DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step) {
+    const auto* track = fast_track.GetPrimaryTrack();
+    const auto* particle = track->GetDefinition();
+    const auto* material = fast_track.GetEnvelopeMaterial();
+    const auto* ionisation = material->GetIonisation();
+
+    auto position = fast_track.GetPrimaryTrackLocalPosition();
+    auto direction = fast_track.GetPrimaryTrackLocalDirection();
+    auto energy = track->GetKineticEnergy();
+
+    auto distance = fast_track.GetEnvelopeSolid()->DistanceToOut(position, direction);
+    auto step = std::min(distance, max_step_length_);
+
+    auto mass = particle->GetPDGMass();
+    auto charge = particle->GetPDGCharge() / eplus;
+    auto momentum = std::sqrt(energy * (energy + 2 * mass));
+    auto beta = momentum / (energy + mass);
+    auto beta_gamma = momentum / mass;
+
+    // Sample the energy loss from the Landau distribution around the most probable energy loss
+    auto excitation_energy = ionisation->GetMeanExcitationEnergy();
+    auto xi = twopi_mc2_rcl2 * charge * charge * material->GetElectronDensity() * step / (beta * beta);
+    auto most_probable = xi * (std::log(2 * electron_mass_c2 * beta_gamma * beta_gamma / excitation_energy) +
+                               std::log(xi / excitation_energy) + 0.2 - beta * beta -
+                               ionisation->DensityCorrection(std::log10(beta_gamma)));
+    auto loss = std::clamp(most_probable + xi * (CLHEP::RandLandau::shoot() + 0.22278), 0., energy);
+
+    // The end point of the step is also required for stopping particles to place the deposit in the middle of the step
+    fast_step.ProposePrimaryTrackFinalPosition(position + step * direction);
+    fast_step.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + step / (beta * c_light));
+    if(loss < energy) {
+        // Only deflect the particle if it has not yet reached the surface
+        if(step < distance) {
+            auto radiation_length = material->GetRadlen();
+            direction = scatter(direction, highland_angle(momentum, beta, charge, step / radiation_length));
+        }
+        fast_step.ProposePrimaryTrackFinalMomentumDirection(direction);
+        fast_step.ProposePrimaryTrackFinalKineticEnergy(energy - loss);
+    } else {
+        fast_step.KillPrimaryTrack();
+    }
+    fast_step.ProposePrimaryTrackPathLength(step);
+    fast_step.ProposeTotalEnergyDeposited(loss);
+}
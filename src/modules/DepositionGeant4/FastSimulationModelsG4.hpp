@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief Defines Geant4 fast simulation models to parameterize the particle transport through passive and sensor volumes
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_FAST_SIMULATION_MODELS_G4_H
+#define ALLPIX_FAST_SIMULATION_MODELS_G4_H
+
+#include <G4EmCalculator.hh>
+#include <G4FastStep.hh>
+#include <G4FastTrack.hh>
+#include <G4Region.hh>
+#include <G4VFastSimulationModel.hh>
+
+namespace allpix {
+    /**
+     * @brief Fast simulation model replacing the full transport through a passive volume
+     *
+     * Particles entering the volume are transported through it in a single step. Photons are either absorbed according to
+     * their attenuation length or leave the volume unaffected. Charged particles lose their energy continuously by
+     * ionization and, for electrons and positrons, by bremsstrahlung, are deflected by multiple scattering and hadrons can
+     * be absorbed in nuclear interactions. Particles below the energy threshold are absorbed. The energy radiated by
+     * electrons and positrons is emitted as bremsstrahlung photons along their direction, which are transported further by
+     * this model. No other secondary particles are produced, the energy lost by ionization is deposited locally.
+     */
+    class AbsorberModelG4 : public G4VFastSimulationModel {
+    public:
+        /**
+         * @brief Constructs the model and attaches it to a region
+         * @param name Name of the model
+         * @param region Region with the volumes to parameterize as root volumes
+         * @param energy_threshold Kinetic energy below which charged particles are absorbed
+         */
+        AbsorberModelG4(const G4String& name, G4Region* region, double energy_threshold);
+
+        /**
+         * @brief Applies to photons and charged particles
+         * @param particle Definition of the particle
+         */
+        G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+
+        /**
+         * @brief Triggers for particles which are not on the surface of the volume they are about to leave
+         * @param fast_track Track in the volume
+         */
+        G4bool ModelTrigger(const G4FastTrack& fast_track) override;
+
+        /**
+         * @brief Transport the particle through the volume
+         * @param fast_track Track in the volume
+         * @param fast_step Final state of the track
+         */
+        void DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step) override;
+
+    private:
+        double energy_threshold_;
+        G4EmCalculator calculator_;
+    };
+
+    /**
+     * @brief Fast simulation model for the energy deposition of charged particles in a sensor volume
+     *
+     * Charged particles above the energy threshold are moved along straight steps of at most the maximum step length. The
+     * energy loss of every step is sampled from the Landau distribution with the most probable value and width for the
+     * traversed material, and the direction is changed by multiple scattering after every step. No secondary particles are
+     * produced, the energy is deposited along the step and converted into charge carriers by the sensitive detector of the
+     * volume. Particles below the threshold are handed back to the full simulation.
+     */
+    class SensorModelG4 : public G4VFastSimulationModel {
+    public:
+        /**
+         * @brief Constructs the model and attaches it to a region
+         * @param name Name of the model
+         * @param region Region with the sensor volume as root volume
+         * @param energy_threshold Kinetic energy below which the full simulation is used
+         * @param max_step_length Maximum length of a single step
+         */
+        SensorModelG4(const G4String& name, G4Region* region, double energy_threshold, double max_step_length);
+
+        /**
+         * @brief Applies to charged particles
+         * @param particle Definition of the particle
+         */
+        G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+
+        /**
+         * @brief Triggers for particles above the energy threshold which are not leaving the volume
+         * @param fast_track Track in the volume
+         */
+        G4bool ModelTrigger(const G4FastTrack& fast_track) override;
+
+        /**
+         * @brief Perform a single step of the particle
+         * @param fast_track Track in the volume
+         * @param fast_step Final state of the track
+         */
+        void DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step) override;
+
+    private:
+        double energy_threshold_;
+        double max_step_length_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_FAST_SIMULATION_MODELS_G4_H */
@@ -13,7 +13,10 @@
 #include "SensitiveDetectorActionG4.hpp"
 #include "TrackInfoG4.hpp"
 
+#include <cmath>
+#include <map>
 #include <memory>
+#include <tuple>
 
 #include "G4DecayTable.hh"
 #include "G4HCofThisEvent.hh"
@@ -126,6 +129,65 @@ G4bool SensitiveDetectorActionG4::ProcessHits(G4Step* step, G4TouchableHistory*)
     return true;
 }
 
+void SensitiveDetectorActionG4::setDepositMerging(const ROOT::Math::XYZVector& voxel_size, double time_window) {
+    merge_deposits_ = true;
+    merging_voxel_size_ = voxel_size;
+    merging_time_window_ = time_window;
+}
+
+void SensitiveDetectorActionG4::merge_deposits() {
+    // Deposits are identified by their voxel indices, their time bin and the track they originate from. The latter ensures
+    // that the relation to the MCParticle is retained.
+    using VoxelKey = std::tuple<long, long, long, long, int>;
+    std::map<VoxelKey, size_t> voxel_to_deposit;
+
+    std::vector<ROOT::Math::XYZPoint> merged_position;
+    std::vector<unsigned int> merged_charge;
+    std::vector<double> merged_energy;
+    std::vector<double> merged_time;
+    std::vector<int> merged_to_id;
+
+    for(size_t i = 0; i < deposit_position_.size(); i++) {
+        const auto& position = deposit_position_[i];
+        VoxelKey key{static_cast<long>(std::floor(position.x() / merging_voxel_size_.x())),
+                     static_cast<long>(std::floor(position.y() / merging_voxel_size_.y())),
+                     static_cast<long>(std::floor(position.z() / merging_voxel_size_.z())),
+                     static_cast<long>(std::floor(deposit_time_[i] / merging_time_window_)),
+                     deposit_to_id_[i]};
+
+        auto [it, inserted] = voxel_to_deposit.emplace(key, merged_charge.size());
+        if(inserted) {
+            merged_position.push_back(position);
+            merged_charge.push_back(deposit_charge_[i]);
+            merged_energy.push_back(deposit_energy_[i]);
+            merged_time.push_back(deposit_time_[i]);
+            merged_to_id.push_back(deposit_to_id_[i]);
+            continue;
+        }
+
+        // Update the charge-weighted position and time of the existing deposit
+        auto idx = it->second;
+        auto charge_before = static_cast<double>(merged_charge[idx]);
+        auto charge_total = charge_before + deposit_charge_[i];
+        merged_position[idx] = ROOT::Math::XYZPoint(
+            (static_cast<ROOT::Math::XYZVector>(merged_position[idx]) * charge_before +
+             static_cast<ROOT::Math::XYZVector>(position) * static_cast<double>(deposit_charge_[i])) /
+            charge_total);
+        merged_time[idx] = (merged_time[idx] * charge_before + deposit_time_[i] * deposit_charge_[i]) / charge_total;
+        merged_charge[idx] += deposit_charge_[i];
+        merged_energy[idx] += deposit_energy_[i];
+    }
+
+    LOG(DEBUG) << "Merged " << deposit_position_.size() << " deposits into " << merged_position.size() << " voxels in "
+               << detector_->getName();
+
+    deposit_position_ = std::move(merged_position);
+    deposit_charge_ = std::move(merged_charge);
+    deposit_energy_ = std::move(merged_energy);
+    deposit_time_ = std::move(merged_time);
+    deposit_to_id_ = std::move(merged_to_id);
+}
+
 std::string SensitiveDetectorActionG4::getName() const { return detector_->getName(); }
 
 unsigned int SensitiveDetectorActionG4::getTotalDepositedCharge() const { return total_deposited_charge_; }
@@ -161,6 +223,56 @@ void SensitiveDetectorActionG4::clearEventInfo() {
     id_to_particle_.clear();
 }
 
+SensitiveDetectorActionG4::EventInfo SensitiveDetectorActionG4::takeEventInfo() {
+    EventInfo info;
+    info.deposit_position = std::move(deposit_position_);
+    info.deposit_charge = std::move(deposit_charge_);
+    info.deposit_energy = std::move(deposit_energy_);
+    info.deposit_time = std::move(deposit_time_);
+    info.deposit_to_id = std::move(deposit_to_id_);
+
+    info.track_begin = std::move(track_begin_);
+    info.track_end = std::move(track_end_);
+    info.track_parents = std::move(track_parents_);
+    info.track_pdg = std::move(track_pdg_);
+    info.track_time = std::move(track_time_);
+    info.track_charge = std::move(track_charge_);
+    info.track_total_energy_start = std::move(track_total_energy_start_);
+    info.track_kinetic_energy_start = std::move(track_kinetic_energy_start_);
+
+    clearEventInfo();
+    return info;
+}
+
+void SensitiveDetectorActionG4::mergeEventInfo(EventInfo info, int track_id_offset) {
+    // Track id zero refers to particles entering the sensor and is not shifted
+    auto shift = [track_id_offset](int track_id) { return (track_id == 0 ? 0 : track_id + track_id_offset); };
+
+    deposit_position_.insert(deposit_position_.end(), info.deposit_position.begin(), info.deposit_position.end());
+    deposit_charge_.insert(deposit_charge_.end(), info.deposit_charge.begin(), info.deposit_charge.end());
+    deposit_energy_.insert(deposit_energy_.end(), info.deposit_energy.begin(), info.deposit_energy.end());
+    deposit_time_.insert(deposit_time_.end(), info.deposit_time.begin(), info.deposit_time.end());
+    for(const auto& track_id : info.deposit_to_id) {
+        deposit_to_id_.push_back(shift(track_id));
+    }
+
+    for(const auto& [track_id, parent_id] : info.track_parents) {
+        track_parents_.emplace(shift(track_id), shift(parent_id));
+    }
+    auto merge = [&shift](auto& target, const auto& source) {
+        for(const auto& [track_id, value] : source) {
+            target.emplace(shift(track_id), value);
+        }
+    };
+    merge(track_begin_, info.track_begin);
+    merge(track_end_, info.track_end);
+    merge(track_pdg_, info.track_pdg);
+    merge(track_time_, info.track_time);
+    merge(track_charge_, info.track_charge);
+    merge(track_total_energy_start_, info.track_total_energy_start);
+    merge(track_kinetic_energy_start_, info.track_kinetic_energy_start);
+}
+
 void SensitiveDetectorActionG4::dispatchMessages(Module* module, Messenger* messenger, Event* event) {
 
     // Clear previous event's track_begin cache and reserve number of elements to be stored:
@@ -223,6 +335,11 @@ void SensitiveDetectorActionG4::dispatchMessages(Module* module, Messenger* mess
     auto mc_particle_message = std::make_shared<MCParticleMessage>(std::move(mc_particles), detector_);
     messenger->dispatchMessage(module, mc_particle_message, event);
 
+    // Combine deposits located close to each other if requested
+    if(merge_deposits_ && !deposit_position_.empty()) {
+        merge_deposits();
+    }
+
     // Send a deposit message if we have any deposits
     unsigned int charges = 0;
     double energies = 0.;
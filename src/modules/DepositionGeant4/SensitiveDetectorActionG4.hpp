@@ -12,7 +12,9 @@
 #ifndef ALLPIX_SIMPLE_DEPOSITION_MODULE_SENSITIVE_DETECTOR_ACTION_H
 #define ALLPIX_SIMPLE_DEPOSITION_MODULE_SENSITIVE_DETECTOR_ACTION_H
 
+#include <map>
 #include <memory>
+#include <vector>
 
 #include <G4VSensitiveDetector.hh>
 #include <G4WrapperProcess.hh>
@@ -34,6 +36,26 @@ namespace allpix {
      */
     class SensitiveDetectorActionG4 : public G4VSensitiveDetector {
     public:
+        /**
+         * @brief Tracks and deposits recorded in the sensitive device for the current event
+         */
+        struct EventInfo {
+            std::vector<ROOT::Math::XYZPoint> deposit_position;
+            std::vector<unsigned int> deposit_charge;
+            std::vector<double> deposit_energy;
+            std::vector<double> deposit_time;
+            std::vector<int> deposit_to_id;
+
+            std::map<int, ROOT::Math::XYZPoint> track_begin;
+            std::map<int, ROOT::Math::XYZPoint> track_end;
+            std::map<int, int> track_parents;
+            std::map<int, int> track_pdg;
+            std::map<int, double> track_time;
+            std::map<int, unsigned int> track_charge;
+            std::map<int, double> track_total_energy_start;
+            std::map<int, double> track_kinetic_energy_start;
+        };
+
         /**
          * @brief Constructs the action handling for every sensitive detector
          * @param detector Detector this sensitive device is bound to
@@ -84,11 +106,34 @@ namespace allpix {
          */
         void clearEventInfo();
 
+        /**
+         * @brief Take the tracks and deposits recorded for the current event, leaving this instance cleared
+         * @return Recorded tracks and deposits
+         */
+        EventInfo takeEventInfo();
+
+        /**
+         * @brief Append tracks and deposits recorded by another instance for a different part of the same event
+         * @param info Recorded tracks and deposits
+         * @param track_id_offset Offset to add to the track ids, as returned by \ref TrackInfoManager::mergeTrackInfo
+         */
+        void mergeEventInfo(EventInfo info, int track_id_offset);
+
         /**
          * @brief Get the name of the sensitive device bound to this action
          */
         std::string getName() const;
 
+        /**
+         * @brief Enable merging of deposits into voxels before dispatching them
+         * @param voxel_size Size of the spatial voxels in local coordinates
+         * @param time_window Width of the time bins
+         *
+         * Deposits from the same track which fall into the same voxel and time bin are combined into a single deposit at
+         * their charge-weighted mean position and time.
+         */
+        void setDepositMerging(const ROOT::Math::XYZVector& voxel_size, double time_window);
+
         /**
          * @brief Set the seed of the associated random number generator
          */
@@ -110,6 +155,11 @@ namespace allpix {
         void dispatchMessages(Module* module, Messenger* messenger, Event* event);
 
     private:
+        /**
+         * @brief Combine all stored deposits of the same track which are located in the same voxel and time bin
+         */
+        void merge_deposits();
+
         std::shared_ptr<Detector> detector_;
         // Pointer to track info manager to register tracks which pass through sensitive detectors
         TrackInfoManager* track_info_manager_;
@@ -118,6 +168,11 @@ namespace allpix {
         double fano_factor_;
         double cutoff_time_;
 
+        // Voxel size and time window for merging deposits, merging is disabled if unset
+        bool merge_deposits_{false};
+        ROOT::Math::XYZVector merging_voxel_size_;
+        double merging_time_window_{};
+
         /**
          * Random number generator for e/h pair creation fluctuation
          * @note It is okay to keep a separate random number generator here because instances of this class are thread_local
@@ -47,6 +47,17 @@ namespace allpix {
          */
         int getParentID() const { return parent_track_id_; }
 
+        /**
+         * @brief Shift the custom track id and the parent track id by a constant offset
+         * @param offset Offset to add to the ids, a parent id of zero for primary particles is kept
+         */
+        void shiftIDs(int offset) {
+            custom_track_id_ += offset;
+            if(parent_track_id_ != 0) {
+                parent_track_id_ += offset;
+            }
+        }
+
         /**
          * @brief Update track info from the G4Track
          * @param aTrack A pointer to a G4Track instance which represents this track's final state
@@ -59,6 +59,19 @@ void TrackInfoManager::resetTrackInfoManager() {
     id_to_track_.clear();
 }
 
+int TrackInfoManager::mergeTrackInfo(TrackInfoManager&& other) {
+    auto offset = counter_ - 1;
+    for(const auto& [track_id, parent_id] : other.track_id_to_parent_id_) {
+        track_id_to_parent_id_[track_id + offset] = (parent_id == 0 ? 0 : parent_id + offset);
+    }
+    for(auto& track_info : other.stored_track_infos_) {
+        track_info->shiftIDs(offset);
+        stored_track_infos_.push_back(std::move(track_info));
+    }
+    counter_ += other.counter_ - 1;
+    return offset;
+}
+
 void TrackInfoManager::dispatchMessage(Module* module, Messenger* messenger, Event* event) {
     set_all_track_parents();
     IFLOG(DEBUG) {
@@ -68,6 +68,16 @@ namespace allpix {
          */
         void resetTrackInfoManager();
 
+        /**
+         * @brief Append the tracks recorded by another instance for a different part of the same event
+         * @param other Track information manager to take the tracks from, left in an unspecified state
+         * @return Offset added to the track ids of the other instance
+         *
+         * Track ids of the other instance are shifted to follow the ids assigned by this instance. The same offset needs to
+         * be applied to all other references to these track ids.
+         */
+        int mergeTrackInfo(TrackInfoManager&& other);
+
         /**
          * @brief Dispatch the stored tracks as a MCTrackMessage
          * @param module The module which is responsible for dispatching the message
@@ -75,10 +75,36 @@ void DepositionGeneratorModule::run(Event* event) {
     // Pass current event number to the reader instance
     reader_->set_event_num(event->number);
 
+    // Read the primary particles before distributing them to the sub-events
+    if(number_of_subevents_ > 1) {
+        particles_ = reader_->getParticles();
+    }
+
     // Call upstream run method
     DepositionGeant4Module::run(event);
 }
 
+/**
+ * The primary particles of the event are divided into contiguous slices, which are simulated as separate Geant4 events.
+ * Without splitting, all primary particles of the event are simulated in a single Geant4 event read by the generator action.
+ */
+void DepositionGeneratorModule::run_subevent(unsigned int subevent, const std::vector<std::vector<uint64_t>>& seeds) {
+    if(number_of_subevents_ == 1) {
+        beam_on(seeds.front());
+        return;
+    }
+
+    auto first = particles_.size() * subevent / number_of_subevents_;
+    auto last = particles_.size() * (subevent + 1) / number_of_subevents_;
+    if(last == first) {
+        return;
+    }
+
+    PrimariesGeneratorAction::setParticles(std::vector<PrimariesReader::Particle>(
+        particles_.begin() + static_cast<std::ptrdiff_t>(first), particles_.begin() + static_cast<std::ptrdiff_t>(last)));
+    beam_on(seeds.front());
+}
+
 void DepositionGeneratorModule::initialize_g4_action() {
     auto* action_initialization = new ActionInitializationPrimaries<PrimariesGeneratorAction>(config_, reader_);
     run_manager_g4_->SetUserInitialization(action_initialization);
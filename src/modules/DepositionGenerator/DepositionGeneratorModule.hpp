@@ -12,6 +12,8 @@
 #ifndef ALLPIX_GENERATOR_DEPOSITION_MODULE_H
 #define ALLPIX_GENERATOR_DEPOSITION_MODULE_H
 
+#include <vector>
+
 #include "../DepositionGeant4/DepositionGeant4Module.hpp"
 #include "PrimariesReader.hpp"
 
@@ -47,6 +49,19 @@ namespace allpix {
          */
         void run(Event* event) override;
 
+    protected:
+        /**
+         * @brief One Geant4 event is simulated for every sub-event
+         */
+        unsigned int number_of_seed_sets() const override { return number_of_subevents_; }
+
+        /**
+         * @brief Simulates the slice of the primary particles of the current event belonging to the given sub-event
+         * @param subevent Index of the sub-event
+         * @param seeds Set of seeds of the Geant4 event of this sub-event
+         */
+        void run_subevent(unsigned int subevent, const std::vector<std::vector<uint64_t>>& seeds) override;
+
     private:
         /**
          * @brief Helper method to initialize the generator action for dispatching particles via a particle gun
@@ -56,6 +71,9 @@ namespace allpix {
         // The file reader for primary particles
         std::shared_ptr<PrimariesReader> reader_;
         PrimariesReader::FileModel file_model_;
+
+        // Primary particles of the current event, read upfront when splitting events into sub-events
+        std::vector<PrimariesReader::Particle> particles_;
     };
 
 } // namespace allpix
@@ -25,6 +25,8 @@
 
 using namespace allpix;
 
+thread_local std::optional<std::vector<PrimariesReader::Particle>> PrimariesGeneratorAction::particles_;
+
 PrimariesGeneratorAction::PrimariesGeneratorAction(const Configuration&, std::shared_ptr<PrimariesReader> reader)
     : particle_gun_(std::make_unique<G4ParticleGun>()), reader_(std::move(reader)) {
 
@@ -45,9 +47,15 @@ bool PrimariesGeneratorAction::check_vertex_inside_world(const G4ThreeVector& po
  */
 void PrimariesGeneratorAction::GeneratePrimaries(G4Event* event) {
 
-    // Read next set of primary particles from the data file
+    // Use the particles set for this event or read next set of primary particles from the data file
     using PrimaryParticle = PrimariesReader::Particle;
-    std::vector<PrimaryParticle> particles = reader_->getParticles();
+    std::vector<PrimaryParticle> particles;
+    if(particles_.has_value()) {
+        particles = std::move(particles_.value());
+        particles_.reset();
+    } else {
+        particles = reader_->getParticles();
+    }
 
     // Dispatch them to the Geant4 particle gun
     LOG(DEBUG) << "Primary particles generated:";
@@ -10,6 +10,8 @@
 #define ALLPIX_PRIMARIES_DEPOSITION_MODULE_GENERATOR_ACTION_H
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include <G4DataVector.hh>
 #include <G4ParticleGun.hh>
@@ -18,9 +20,9 @@
 
 #include "core/config/Configuration.hpp"
 
-namespace allpix {
-    class PrimariesReader;
+#include "PrimariesReader.hpp"
 
+namespace allpix {
     /**
      * @brief Generates the particles in every event
      */
@@ -38,6 +40,12 @@ namespace allpix {
          */
         void GeneratePrimaries(G4Event*) override;
 
+        /**
+         * @brief Set the primary particles for the next event generated on the calling thread instead of reading them
+         * @param particles Primary particles to generate
+         */
+        static void setParticles(std::vector<PrimariesReader::Particle> particles) { particles_ = std::move(particles); }
+
     private:
         /**
          * @brief helper method to check if particle is to be dispateched within the defined world volume
@@ -48,6 +56,9 @@ namespace allpix {
 
         std::unique_ptr<G4ParticleGun> particle_gun_;
         std::shared_ptr<PrimariesReader> reader_;
+
+        // Primary particles set for the next event of this thread
+        static thread_local std::optional<std::vector<PrimariesReader::Particle>> particles_;
     };
 } // namespace allpix
 
@@ -21,6 +21,7 @@
 #include <TMath.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <filesystem>
 #include <fstream>
@@ -147,6 +148,9 @@ DepositionLaserModule::DepositionLaserModule(Configuration& config, Messenger* m
         }
     }
 
+    config_.setDefault<bool>("use_random_pool", false);
+    use_random_pool_ = config_.get<bool>("use_random_pool");
+
     config_.setDefault<bool>("output_plots", false);
     output_plots_ = config.get<bool>("output_plots");
 }
@@ -274,8 +278,8 @@ void DepositionLaserModule::run(Event* event) {
     std::map<std::shared_ptr<Detector>, std::vector<DepositedCharge>> deposited_charges;
 
     // Lambda generator to yield pulse shape
+    int cut_sigmas = 4;
     auto yield_starting_time = [&]() {
-        int cut_sigmas = 4;
         double result = -1;
         while(result < 0) {
             result =
@@ -286,12 +290,24 @@ void DepositionLaserModule::run(Event* event) {
 
     // Containers for timestamps
     std::vector<double> starting_times(number_of_photons_);
-    std::for_each(begin(starting_times), end(starting_times), [&](auto& item) {
-        item = yield_starting_time();
-        if(output_plots_) {
+    if(use_random_pool_) {
+        // Draw the times of all photons as one batch from the pool, only redrawing the few before the start of the pulse
+        auto& random_pool = event->getRandomPool();
+        random_pool.normal(starting_times.data(), starting_times.size());
+        for(auto& item : starting_times) {
+            item = (cut_sigmas + item) * pulse_duration_;
+            while(item < 0) {
+                item = (cut_sigmas + random_pool.normal()) * pulse_duration_;
+            }
+        }
+    } else {
+        std::for_each(begin(starting_times), end(starting_times), [&](auto& item) { item = yield_starting_time(); });
+    }
+    if(output_plots_) {
+        for(const auto& item : starting_times) {
             h_pulse_shape_->Fill(item);
         }
-    });
+    }
 
     std::sort(begin(starting_times), end(starting_times));
 
@@ -314,7 +330,8 @@ void DepositionLaserModule::run(Event* event) {
 
         // Generate penetration depth
         double penetration_depth =
-            allpix::exponential_distribution<double>(1 / absorption_length_)(event->getRandomEngine());
+            (use_random_pool_ ? absorption_length_ * event->getRandomPool().exponential()
+                              : allpix::exponential_distribution<double>(1 / absorption_length_)(event->getRandomEngine()));
         LOG(DEBUG) << "    Penetration depth: " << Units::display(penetration_depth, "um");
 
         // Perform tracking
@@ -452,6 +469,11 @@ std::pair<ROOT::Math::XYZPoint, ROOT::Math::XYZVector> DepositionLaserModule::ge
         auto [v1, v2] = orthogonal_pair(beam_direction_);
 
         // Beam waist is equal to 2*sigma
+        if(use_random_pool_) {
+            std::array<double, 2> gauss{};
+            event->getRandomPool().normal(gauss.data(), gauss.size());
+            return v1 * gauss[0] * size / 2. + v2 * gauss[1] * size / 2.;
+        }
         double dx = allpix::normal_distribution<double>(0, size / 2.)(event->getRandomEngine());
         double dy = allpix::normal_distribution<double>(0, size / 2.)(event->getRandomEngine());
         return v1 * dx + v2 * dy;
@@ -474,9 +496,14 @@ std::pair<ROOT::Math::XYZPoint, ROOT::Math::XYZVector> DepositionLaserModule::ge
         auto focal_position = source_position_ + beam_direction_ * focal_distance_ + beam_pos_smearing(beam_waist_);
 
         // Generate angles
-        double phi = allpix::uniform_real_distribution<double>(0, 2 * TMath::Pi())(event->getRandomEngine());
-        double cos_theta =
-            allpix::uniform_real_distribution<double>(cos(beam_convergence_angle_), 1)(event->getRandomEngine());
+        double phi = 0, cos_theta = 0;
+        if(use_random_pool_) {
+            phi = 2 * TMath::Pi() * event->getRandomPool().uniform();
+            cos_theta = cos(beam_convergence_angle_) + (1 - cos(beam_convergence_angle_)) * event->getRandomPool().uniform();
+        } else {
+            phi = allpix::uniform_real_distribution<double>(0, 2 * TMath::Pi())(event->getRandomEngine());
+            cos_theta = allpix::uniform_real_distribution<double>(cos(beam_convergence_angle_), 1)(event->getRandomEngine());
+        }
 
         // Rotate direction by given angles
         // First, define and apply theta rotation
@@ -134,6 +134,7 @@ namespace allpix {
         double refractive_index_{0.};
         double pulse_duration_;
         bool is_user_optics_{false};
+        bool use_random_pool_{false};
 
         size_t group_photons_;
 
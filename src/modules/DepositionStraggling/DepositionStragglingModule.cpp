@@ -0,0 +1,511 @@
+/**
+ * @file
+ * @brief Implementation of a module for fast energy deposition of charged particles without Geant4 tracking
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "DepositionStragglingModule.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "core/module/Event.hpp"
+#include "core/utils/distributions.h"
+#include "core/utils/log.h"
+#include "objects/DepositedCharge.hpp"
+#include "objects/MCParticle.hpp"
+#include "physics/MaterialProperties.hpp"
+#include "tools/liang_barsky.h"
+
+using namespace allpix;
+
+namespace {
+    /**
+     * @brief Construct two unit vectors perpendicular to a direction and to each other
+     */
+    std::pair<ROOT::Math::XYZVector, ROOT::Math::XYZVector> perpendicular_axes(const ROOT::Math::XYZVector& direction) {
+        auto reference =
+            (std::fabs(direction.z()) < 0.9 ? ROOT::Math::XYZVector(0, 0, 1) : ROOT::Math::XYZVector(1, 0, 0));
+        auto u = direction.Cross(reference).Unit();
+        auto v = direction.Cross(u).Unit();
+        return {u, v};
+    }
+
+    /**
+     * @brief Relativistic kinematics of the primary particle
+     */
+    struct Kinematics {
+        double beta;
+        double momentum;
+        double max_energy_transfer;
+
+        Kinematics(double kinetic_energy, double mass, int pdg_code) {
+            auto electron_mass = Units::get(0.51099895, "MeV");
+            auto gamma = 1. + kinetic_energy / mass;
+            beta = std::sqrt(1. - 1. / (gamma * gamma));
+            momentum = std::sqrt(kinetic_energy * (kinetic_energy + 2. * mass));
+            if(std::abs(pdg_code) == 11) {
+                // Identical particles for electrons, the faster one is considered the primary
+                max_energy_transfer = (pdg_code == 11 ? kinetic_energy / 2. : kinetic_energy);
+            } else {
+                auto ratio = electron_mass / mass;
+                max_energy_transfer = 2. * electron_mass * beta * beta * gamma * gamma /
+                                      (1. + 2. * gamma * ratio + ratio * ratio);
+            }
+        }
+    };
+} // namespace
+
+DepositionStragglingModule::DepositionStragglingModule(Configuration& config,
+                                                       Messenger* messenger,
+                                                       GeometryManager* geo_manager)
+    : Module(config), messenger_(messenger), geo_manager_(geo_manager) {
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    // Beam parameters
+    config_.setDefault<int>("particle_code", 211);
+    config_.setDefault<double>("source_energy_spread", 0.);
+    config_.setDefault<ROOT::Math::XYZVector>("beam_direction", ROOT::Math::XYZVector(0, 0, 1));
+    config_.setDefault<double>("beam_size", 0.);
+    config_.setDefault<ROOT::Math::XYVector>("beam_divergence", ROOT::Math::XYVector(0, 0));
+    config_.setDefault<unsigned int>("number_of_particles", 1);
+
+    // Energy loss parameters, the defaults approximate the collision spectrum of minimum ionizing particles in silicon
+    config_.setDefault<double>("max_step_length", Units::get(1.0, "um"));
+    config_.setDefault<double>("collision_density", Units::get(3.8, "/um"));
+    config_.setDefault<double>("min_energy_transfer", Units::get(17., "eV"));
+    config_.setDefault<double>("close_collision_threshold", Units::get(100., "eV"));
+    config_.setDefault<bool>("multiple_scattering", true);
+    config_.setDefault<bool>("delta_rays", false);
+    config_.setDefault<double>("delta_ray_threshold", Units::get(10., "keV"));
+
+    config_.setDefault<bool>("output_plots", false);
+    config_.setDefault<int>("output_plots_scale", Units::get(100, "ke"));
+
+    particle_code_ = config_.get<int>("particle_code");
+    if(config_.has("particle_mass")) {
+        particle_mass_ = config_.get<double>("particle_mass");
+    } else {
+        std::map<int, double> masses = {{11, Units::get(0.51099895, "MeV")},
+                                        {13, Units::get(105.6583755, "MeV")},
+                                        {211, Units::get(139.57039, "MeV")},
+                                        {321, Units::get(493.677, "MeV")},
+                                        {2212, Units::get(938.27208816, "MeV")}};
+        auto mass = masses.find(std::abs(particle_code_));
+        if(mass == masses.end()) {
+            throw InvalidValueError(config_,
+                                    "particle_code",
+                                    "unknown singly-charged particle, the mass needs to be provided via particle_mass");
+        }
+        particle_mass_ = mass->second;
+    }
+
+    source_energy_ = config_.get<double>("source_energy");
+    source_energy_spread_ = config_.get<double>("source_energy_spread");
+    source_position_ = config_.get<ROOT::Math::XYZPoint>("source_position");
+    beam_direction_ = config_.get<ROOT::Math::XYZVector>("beam_direction").Unit();
+    std::tie(beam_axis_u_, beam_axis_v_) = perpendicular_axes(beam_direction_);
+    beam_size_ = config_.get<double>("beam_size");
+    beam_divergence_ = config_.get<ROOT::Math::XYVector>("beam_divergence");
+    number_of_particles_ = config_.get<unsigned int>("number_of_particles");
+
+    max_step_length_ = config_.get<double>("max_step_length");
+    collision_density_ = config_.get<double>("collision_density");
+    min_energy_transfer_ = config_.get<double>("min_energy_transfer");
+    close_collision_threshold_ = config_.get<double>("close_collision_threshold");
+    multiple_scattering_ = config_.get<bool>("multiple_scattering");
+    delta_rays_ = config_.get<bool>("delta_rays");
+    delta_ray_threshold_ = config_.get<double>("delta_ray_threshold");
+    output_plots_ = config_.get<bool>("output_plots");
+
+    if(max_step_length_ <= 0) {
+        throw InvalidValueError(config_, "max_step_length", "step length needs to be positive");
+    }
+    if(min_energy_transfer_ <= 0 || close_collision_threshold_ <= min_energy_transfer_) {
+        throw InvalidCombinationError(config_,
+                                      {"min_energy_transfer", "close_collision_threshold"},
+                                      "energy transfers need to be positive with the close collision threshold above the "
+                                      "minimum energy transfer");
+    }
+}
+
+void DepositionStragglingModule::initialize() {
+    for(const auto& detector : geo_manager_->getDetectors()) {
+        // The collision spectrum and radiation length are only parameterized for silicon
+        auto material = detector->getModel()->getSensorMaterial();
+        if(material != SensorMaterial::SILICON) {
+            throw ModuleError("Detector \"" + detector->getName() + "\" has sensor material " +
+                              allpix::to_string(material) + ", only silicon sensors are supported");
+        }
+
+        charge_creation_[detector] = {config_.get<double>("charge_creation_energy", ionization_energies[material]),
+                                      config_.get<double>("fano_factor", fano_factors[material])};
+        detectors_.push_back(detector);
+    }
+
+    // Order detectors along the beam, particles are tracked through them in this order
+    std::sort(detectors_.begin(), detectors_.end(), [&](const auto& a, const auto& b) {
+        return (a->getPosition() - source_position_).Dot(beam_direction_) <
+               (b->getPosition() - source_position_).Dot(beam_direction_);
+    });
+
+    Kinematics kinematics(source_energy_, particle_mass_, particle_code_);
+    LOG(INFO) << "Tracking particles with code " << particle_code_ << " and kinetic energy "
+              << Units::display(source_energy_, {"MeV", "GeV"}) << ", beta " << kinematics.beta
+              << ", maximum energy transfer " << Units::display(kinematics.max_energy_transfer, {"keV", "MeV", "GeV"});
+
+    if(output_plots_) {
+        LOG(TRACE) << "Creating output plots";
+        for(const auto& detector : detectors_) {
+            // Plot axis are in kilo electrons - convert from framework units!
+            int maximum = static_cast<int>(Units::convert(config_.get<int>("output_plots_scale"), "ke"));
+            int nbins = 5 * maximum;
+
+            std::string plot_name = "deposited_charge_" + detector->getName();
+            charge_per_event_[detector] = CreateHistogram<TH1D>(
+                plot_name.c_str(), "deposited charge per event;deposited charge [ke];events", nbins, 0, maximum);
+        }
+    }
+}
+
+void DepositionStragglingModule::run(Event* event) {
+    auto& random_generator = event->getRandomEngine();
+    std::map<std::shared_ptr<Detector>, DetectorRecord> records;
+
+    for(unsigned int n = 0; n < number_of_particles_; ++n) {
+        // Sample starting point, direction and energy of the particle
+        allpix::normal_distribution<double> spot(0, beam_size_);
+        allpix::normal_distribution<double> divergence_x(0, beam_divergence_.x());
+        allpix::normal_distribution<double> divergence_y(0, beam_divergence_.y());
+        auto position = source_position_ + beam_axis_u_ * spot(random_generator) + beam_axis_v_ * spot(random_generator);
+        auto direction = (beam_direction_ + beam_axis_u_ * divergence_x(random_generator) +
+                          beam_axis_v_ * divergence_y(random_generator))
+                             .Unit();
+        auto energy = source_energy_;
+        if(source_energy_spread_ > 0) {
+            allpix::normal_distribution<double> energy_distribution(source_energy_, source_energy_spread_);
+            energy = std::max(0., energy_distribution(random_generator));
+        }
+
+        LOG(DEBUG) << "Tracking particle " << n << " from " << Units::display(position, {"mm", "um"}) << " in direction "
+                   << direction << " with kinetic energy " << Units::display(energy, {"MeV", "GeV"});
+
+        double time = 0;
+        for(const auto& detector : detectors_) {
+            if(energy <= 0) {
+                LOG(DEBUG) << "Particle " << n << " stopped before reaching detector " << detector->getName();
+                break;
+            }
+            track(random_generator, detector, energy, position, direction, time, records[detector]);
+        }
+    }
+
+    // Dispatch the deposits for every detector that has been crossed
+    for(auto& [detector, record] : records) {
+        if(record.particles.empty()) {
+            continue;
+        }
+
+        // Local time is counted from the arrival of the first particle in the detector
+        double time_reference = std::numeric_limits<double>::max();
+        for(const auto& particle : record.particles) {
+            time_reference = std::min(time_reference, particle.time);
+        }
+
+        std::vector<MCParticle> mc_particles;
+        mc_particles.reserve(record.particles.size());
+        for(const auto& particle : record.particles) {
+            mc_particles.emplace_back(particle.start,
+                                      detector->getGlobalPosition(particle.start),
+                                      particle.end,
+                                      detector->getGlobalPosition(particle.end),
+                                      particle.pdg_code,
+                                      particle.time - time_reference,
+                                      particle.time);
+            // Count electrons and holes:
+            mc_particles.back().setTotalDepositedCharge(2 * particle.charge);
+        }
+        for(size_t i = 0; i < record.particles.size(); ++i) {
+            if(record.particles[i].parent >= 0) {
+                mc_particles[i].setParent(&mc_particles[static_cast<size_t>(record.particles[i].parent)]);
+            }
+        }
+        auto mc_particle_message = std::make_shared<MCParticleMessage>(std::move(mc_particles), detector);
+
+        std::vector<DepositedCharge> deposits;
+        deposits.reserve(2 * record.deposits.size());
+        unsigned long total_charge = 0;
+        for(const auto& deposit : record.deposits) {
+            auto global_position = detector->getGlobalPosition(deposit.position);
+            const auto* mc_particle = &mc_particle_message->getData().at(deposit.particle);
+            deposits.emplace_back(deposit.position,
+                                  global_position,
+                                  CarrierType::ELECTRON,
+                                  deposit.charge,
+                                  deposit.time - time_reference,
+                                  deposit.time,
+                                  mc_particle);
+            deposits.emplace_back(deposit.position,
+                                  global_position,
+                                  CarrierType::HOLE,
+                                  deposit.charge,
+                                  deposit.time - time_reference,
+                                  deposit.time,
+                                  mc_particle);
+            total_charge += deposit.charge;
+        }
+
+        LOG(DEBUG) << "Deposited " << total_charge << " e/h pairs in " << record.deposits.size() << " steps from "
+                   << record.particles.size() << " particles in detector " << detector->getName();
+
+        if(output_plots_) {
+            double charge = static_cast<double>(Units::convert(static_cast<double>(total_charge), "ke"));
+            charge_per_event_[detector]->Fill(charge);
+        }
+
+        messenger_->dispatchMessage(this, mc_particle_message, event);
+        messenger_->dispatchMessage(
+            this, std::make_shared<DepositedChargeMessage>(std::move(deposits), detector), event);
+    }
+}
+
+void DepositionStragglingModule::finalize() {
+    if(output_plots_) {
+        for(auto& plot : charge_per_event_) {
+            plot.second->Write();
+        }
+    }
+}
+
+/**
+ * The particle is moved to the sensor along a straight line and then tracked through the sensor in segments of at most
+ * the maximum step length. In every segment, the number of collisions with the electrons of the material is drawn from
+ * Poisson distributions for distant collisions with small energy transfers, sampled from a 1/E spectrum, and for close
+ * collisions with free electrons following the Rutherford 1/E^2 spectrum up to the kinematic limit. Multiple scattering is
+ * approximated by Gaussian deflections after every segment, with the total width given by the Highland formula for the
+ * path length in the sensor. The energy transferred in all collisions, including the energy of delta rays, is subtracted
+ * from the kinetic energy of the particle, which enters the following detector with the remaining energy. The collision
+ * rates are evaluated for the energy at the sensor entry.
+ */
+void DepositionStragglingModule::track(RandomNumberGenerator& random_generator,
+                                       const std::shared_ptr<Detector>& detector,
+                                       double& energy,
+                                       ROOT::Math::XYZPoint& position,
+                                       ROOT::Math::XYZVector& direction,
+                                       double& time,
+                                       DetectorRecord& record) const {
+    auto local_position = detector->getLocalPosition(position);
+    auto local_direction = (detector->getLocalPosition(position + direction) - local_position).Unit();
+
+    auto distances = sensor_distances(detector, local_position, local_direction);
+    if(!distances || distances->second <= 0) {
+        return;
+    }
+
+    Kinematics kinematics(energy, particle_mass_, particle_code_);
+    auto velocity = kinematics.beta * Units::get(299.792458, "mm/ns");
+
+    // Move to the sensor entry point
+    auto entry = std::max(distances->first, 0.);
+    local_position += entry * local_direction;
+    time += entry / velocity;
+    auto path_length = distances->second - entry;
+
+    auto index = record.particles.size();
+    record.particles.push_back({local_position, local_position, particle_code_, time, -1, 0});
+
+    // Mean collision rates per unit length, Rutherford term for silicon: K/2 * Z/A * rho / beta^2
+    auto rutherford = Units::get(0.17826, "MeV/cm") / (kinematics.beta * kinematics.beta);
+    auto close_rate = (kinematics.max_energy_transfer > close_collision_threshold_
+                           ? rutherford * (1. / close_collision_threshold_ - 1. / kinematics.max_energy_transfer)
+                           : 0.);
+    auto distant_rate = std::max(0., collision_density_ - close_rate);
+    auto max_close_energy = std::max(kinematics.max_energy_transfer, close_collision_threshold_);
+
+    // Multiple scattering width per unit length, using the Highland formula for the full path in silicon
+    double scattering_per_length = 0;
+    if(multiple_scattering_ && path_length > 0) {
+        auto radiation_length = Units::get(93.7, "mm");
+        auto thickness = path_length / radiation_length;
+        auto theta = Units::get(13.6, "MeV") / (kinematics.beta * kinematics.momentum) * std::sqrt(thickness) *
+                     (1. + 0.038 * std::log(thickness / (kinematics.beta * kinematics.beta)));
+        scattering_per_length = std::max(0., theta) / std::sqrt(path_length);
+    }
+
+    allpix::uniform_real_distribution<double> uniform(0, 1);
+    while(true) {
+        auto remaining = sensor_distances(detector, local_position, local_direction);
+        if(!remaining || remaining->second < Units::get(1., "nm")) {
+            break;
+        }
+        auto step = std::min(max_step_length_, remaining->second);
+        auto midpoint = local_position + 0.5 * step * local_direction;
+
+        // Sample the collisions in this segment
+        double deposited = 0;
+        std::vector<double> delta_energies;
+        if(distant_rate > 0) {
+            auto collisions = allpix::poisson_distribution<unsigned int>(distant_rate * step)(random_generator);
+            for(unsigned int i = 0; i < collisions; ++i) {
+                deposited += min_energy_transfer_ *
+                             std::pow(close_collision_threshold_ / min_energy_transfer_, uniform(random_generator));
+            }
+        }
+        if(close_rate > 0) {
+            auto collisions = allpix::poisson_distribution<unsigned int>(close_rate * step)(random_generator);
+            for(unsigned int i = 0; i < collisions; ++i) {
+                auto transfer =
+                    1. / (1. / close_collision_threshold_ -
+                          uniform(random_generator) * (1. / close_collision_threshold_ - 1. / max_close_energy));
+                if(delta_rays_ && transfer > delta_ray_threshold_) {
+                    delta_energies.push_back(transfer);
+                } else {
+                    deposited += transfer;
+                }
+            }
+        }
+
+        // Reduce the kinetic energy by the energy transferred in this segment. If the transfers exceed the remaining energy,
+        // the particle stops within the segment and the transfers are scaled down to the remaining energy
+        auto energy_loss = deposited;
+        for(const auto& delta_energy : delta_energies) {
+            energy_loss += delta_energy;
+        }
+        if(energy_loss >= energy) {
+            auto scale = energy / energy_loss;
+            deposited *= scale;
+            for(auto& delta_energy : delta_energies) {
+                delta_energy *= scale;
+            }
+            energy = 0;
+        } else {
+            energy -= energy_loss;
+        }
+
+        auto charge = create_charge(random_generator, detector, deposited);
+        if(charge > 0) {
+            record.deposits.push_back({midpoint, time + 0.5 * step / velocity, charge, index});
+            record.particles[index].charge += charge;
+        }
+
+        // Emit delta rays with the emission angle from two-body kinematics and uniform azimuth
+        for(const auto& delta_energy : delta_energies) {
+            auto electron_mass = Units::get(0.51099895, "MeV");
+            auto delta_momentum = std::sqrt(delta_energy * (delta_energy + 2. * electron_mass));
+            auto max_momentum =
+                std::sqrt(kinematics.max_energy_transfer * (kinematics.max_energy_transfer + 2. * electron_mass));
+            auto cos_theta =
+                std::min(1., delta_energy / delta_momentum * max_momentum / kinematics.max_energy_transfer);
+            auto sin_theta = std::sqrt(1. - cos_theta * cos_theta);
+            auto phi = 2. * M_PI * uniform(random_generator);
+            auto [u, v] = perpendicular_axes(local_direction);
+            auto delta_direction =
+                (cos_theta * local_direction + sin_theta * (std::cos(phi) * u + std::sin(phi) * v)).Unit();
+            deposit_delta_ray(random_generator,
+                              detector,
+                              midpoint,
+                              delta_direction,
+                              delta_energy,
+                              time + 0.5 * step / velocity,
+                              index,
+                              record);
+        }
+
+        local_position += step * local_direction;
+        time += step / velocity;
+
+        if(energy <= 0) {
+            LOG(TRACE) << "Particle stopped in detector " << detector->getName();
+            break;
+        }
+
+        if(scattering_per_length > 0) {
+            allpix::normal_distribution<double> scattering(0, scattering_per_length * std::sqrt(step));
+            auto [u, v] = perpendicular_axes(local_direction);
+            auto scattering_u = scattering(random_generator);
+            auto scattering_v = scattering(random_generator);
+            local_direction = (local_direction + scattering_u * u + scattering_v * v).Unit();
+        }
+    }
+    record.particles[index].end = local_position;
+
+    LOG(TRACE) << "Particle crossed detector " << detector->getName() << " from "
+               << Units::display(record.particles[index].start, {"mm", "um"}) << " to "
+               << Units::display(local_position, {"mm", "um"}) << ", deposited " << record.particles[index].charge
+               << " e/h pairs, remaining kinetic energy " << Units::display(energy, {"keV", "MeV", "GeV"});
+
+    // Continue with the particle state at the sensor exit
+    position = detector->getGlobalPosition(local_position);
+    direction = (detector->getGlobalPosition(local_position + local_direction) - position).Unit();
+}
+
+/**
+ * The delta ray is assumed to travel along a straight line and to deposit its energy uniformly over its practical range,
+ * estimated with the Kanaya-Okayama parameterization for silicon. Energy carried beyond the sensor surface is lost.
+ */
+void DepositionStragglingModule::deposit_delta_ray(RandomNumberGenerator& random_generator,
+                                                   const std::shared_ptr<Detector>& detector,
+                                                   const ROOT::Math::XYZPoint& origin,
+                                                   const ROOT::Math::XYZVector& direction,
+                                                   double energy,
+                                                   double time,
+                                                   size_t parent,
+                                                   DetectorRecord& record) const {
+    auto range = Units::get(0.0319, "um") * std::pow(static_cast<double>(Units::convert(energy, "keV")), 1.67);
+    auto distances = sensor_distances(detector, origin, direction);
+    auto path_length = std::min(range, (distances ? std::max(distances->second, 0.) : 0.));
+    auto energy_per_length = energy / range;
+
+    auto index = record.particles.size();
+    record.particles.push_back({origin, origin + path_length * direction, 11, time, static_cast<int>(parent), 0});
+
+    for(double travelled = 0; travelled < path_length; travelled += max_step_length_) {
+        auto step = std::min(max_step_length_, path_length - travelled);
+        auto charge = create_charge(random_generator, detector, energy_per_length * step);
+        if(charge > 0) {
+            record.deposits.push_back({origin + (travelled + 0.5 * step) * direction, time, charge, index});
+            record.particles[index].charge += charge;
+        }
+    }
+
+    LOG(TRACE) << "Delta ray with energy " << Units::display(energy, {"keV", "MeV"}) << " and range "
+               << Units::display(range, {"um", "mm"}) << " deposited " << record.particles[index].charge << " e/h pairs";
+}
+
+unsigned int DepositionStragglingModule::create_charge(RandomNumberGenerator& random_generator,
+                                                       const std::shared_ptr<Detector>& detector,
+                                                       double energy) const {
+    if(energy <= 0) {
+        return 0;
+    }
+
+    // Calculate number of electron hole pairs produced, taking into account fluctuations between ionization and lattice
+    // excitations via the Fano factor. We assume Gaussian statistics here.
+    const auto& [charge_creation_energy, fano_factor] = charge_creation_.at(detector);
+    auto mean_charge = energy / charge_creation_energy;
+    allpix::normal_distribution<double> charge_fluctuation(mean_charge, std::sqrt(mean_charge * fano_factor));
+    return static_cast<unsigned int>(std::max(charge_fluctuation(random_generator), 0.) + 0.5);
+}
+
+std::optional<std::pair<double, double>>
+DepositionStragglingModule::sensor_distances(const std::shared_ptr<Detector>& detector,
+                                             const ROOT::Math::XYZPoint& position,
+                                             const ROOT::Math::XYZVector& direction) {
+    auto model = detector->getModel();
+    auto center = model->getSensorCenter();
+    return LiangBarsky::intersectionDistances(
+        direction,
+        ROOT::Math::XYZPoint(position.x() - center.x(), position.y() - center.y(), position.z() - center.z()),
+        model->getSensorSize());
+}
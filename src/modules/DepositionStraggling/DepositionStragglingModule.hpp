@@ -0,0 +1,184 @@
+/**
+ * @file
+ * @brief Definition of a module for fast energy deposition of charged particles without Geant4 tracking
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Math/Point3D.h>
+#include <Math/Vector2D.h>
+#include <Math/Vector3D.h>
+#include <TH1D.h>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/GeometryManager.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Module.hpp"
+#include "core/utils/prng.h"
+
+namespace allpix {
+    /**
+     * @ingroup Modules
+     * @brief Module to deposit charge carriers along straight tracks of charged particles through all sensors
+     *
+     * Particles from a beam are tracked along straight lines through the sensors of all detectors. The energy loss is
+     * sampled in short segments from individual collisions with the electrons of the sensor material, reproducing the
+     * straggling of the energy loss in thin layers. Multiple scattering in the sensors and the emission of delta rays can be
+     * approximated. No material other than the sensors is simulated.
+     */
+    class DepositionStragglingModule : public Module {
+    public:
+        /**
+         * @brief Constructor for this unique module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param geo_manager Pointer to the geometry manager, containing the detectors
+         */
+        DepositionStragglingModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager);
+
+        /**
+         * @brief Check sensor materials, order detectors along the beam and create histograms
+         */
+        void initialize() override;
+
+        /**
+         * @brief Track particles through all sensors and dispatch the deposited charges
+         */
+        void run(Event* event) override;
+
+        /**
+         * @brief Write output plots
+         */
+        void finalize() override;
+
+    private:
+        /**
+         * @brief Particle crossing a sensor, with positions in local coordinates and global time
+         */
+        struct ParticleRecord {
+            ROOT::Math::XYZPoint start;
+            ROOT::Math::XYZPoint end;
+            int pdg_code{};
+            double time{};
+            int parent{-1};
+            unsigned int charge{};
+        };
+
+        /**
+         * @brief Charge deposit in a sensor, with position in local coordinates and global time
+         */
+        struct DepositRecord {
+            ROOT::Math::XYZPoint position;
+            double time{};
+            unsigned int charge{};
+            size_t particle{};
+        };
+
+        /**
+         * @brief All particles and deposits of one detector in the current event
+         */
+        struct DetectorRecord {
+            std::vector<ParticleRecord> particles;
+            std::vector<DepositRecord> deposits;
+        };
+
+        /**
+         * @brief Track a primary particle through the sensor of a single detector
+         * @param random_generator Reference to the random number generator to use
+         * @param detector Detector to track the particle through
+         * @param energy Kinetic energy of the particle, reduced by the energy lost in the sensor
+         * @param position Global position of the particle, updated to the exit point
+         * @param direction Global direction of the particle, updated with the scattering in the sensor
+         * @param time Global time of the particle, updated to the time at the exit point
+         * @param record Record of particles and deposits of this detector
+         */
+        void track(RandomNumberGenerator& random_generator,
+                   const std::shared_ptr<Detector>& detector,
+                   double& energy,
+                   ROOT::Math::XYZPoint& position,
+                   ROOT::Math::XYZVector& direction,
+                   double& time,
+                   DetectorRecord& record) const;
+
+        /**
+         * @brief Deposit the energy of a delta ray along its range
+         * @param random_generator Reference to the random number generator to use
+         * @param detector Detector the delta ray was emitted in
+         * @param origin Local position of the emission
+         * @param direction Local direction of the delta ray
+         * @param energy Kinetic energy of the delta ray
+         * @param time Global time of the emission
+         * @param parent Index of the parent particle in the record
+         * @param record Record of particles and deposits of this detector
+         */
+        void deposit_delta_ray(RandomNumberGenerator& random_generator,
+                               const std::shared_ptr<Detector>& detector,
+                               const ROOT::Math::XYZPoint& origin,
+                               const ROOT::Math::XYZVector& direction,
+                               double energy,
+                               double time,
+                               size_t parent,
+                               DetectorRecord& record) const;
+
+        /**
+         * @brief Convert an energy deposit to a number of charge carrier pairs including Fano fluctuations
+         * @param random_generator Reference to the random number generator to use
+         * @param detector Detector the energy is deposited in
+         * @param energy Deposited energy
+         * @return Number of electron-hole pairs
+         */
+        unsigned int create_charge(RandomNumberGenerator& random_generator,
+                                   const std::shared_ptr<Detector>& detector,
+                                   double energy) const;
+
+        /**
+         * @brief Distance to the sensor surface along a line
+         * @param detector Detector to check the sensor of
+         * @param position Local position on the line
+         * @param direction Local direction of the line
+         * @return Distances to the entry and exit points along the direction, if the line intersects the sensor
+         */
+        static std::optional<std::pair<double, double>> sensor_distances(const std::shared_ptr<Detector>& detector,
+                                                                         const ROOT::Math::XYZPoint& position,
+                                                                         const ROOT::Math::XYZVector& direction);
+
+        Messenger* messenger_;
+        GeometryManager* geo_manager_;
+
+        // Detectors ordered along the beam and their material properties
+        std::vector<std::shared_ptr<Detector>> detectors_;
+        std::map<std::shared_ptr<Detector>, std::pair<double, double>> charge_creation_;
+
+        // Beam parameters
+        int particle_code_{};
+        double particle_mass_{};
+        double source_energy_{}, source_energy_spread_{};
+        ROOT::Math::XYZPoint source_position_;
+        ROOT::Math::XYZVector beam_direction_, beam_axis_u_, beam_axis_v_;
+        double beam_size_{};
+        ROOT::Math::XYVector beam_divergence_;
+        unsigned int number_of_particles_{};
+
+        // Energy loss parameters
+        double max_step_length_{};
+        double collision_density_{}, min_energy_transfer_{}, close_collision_threshold_{};
+        bool multiple_scattering_{};
+        bool delta_rays_{};
+        double delta_ray_threshold_{};
+
+        // Output plots
+        bool output_plots_{};
+        std::map<std::shared_ptr<Detector>, Histogram<TH1D>> charge_per_event_;
+    };
+} // namespace allpix
@@ -12,15 +12,24 @@
 
 #include "GenericPropagationModule.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <limits>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cereal/archives/portable_binary.hpp>
 
 #include <Math/Point3D.h>
 #include <Math/Vector3D.h>
@@ -28,9 +37,11 @@
 #include "core/config/Configuration.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/utils/distributions.h"
+#include "core/utils/hash.h"
 #include "core/utils/log.h"
 #include "core/utils/unit.h"
 #include "tools/ROOT.h"
+#include "tools/capture_clock.h"
 #include "tools/runge_kutta.h"
 
 #include "objects/DepositedCharge.hpp"
@@ -73,6 +84,9 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
     config_.setDefault<bool>("output_linegraphs_recombined", false);
     config_.setDefault<bool>("output_linegraphs_trapped", false);
     config_.setDefault<bool>("output_animations", false);
+    config_.setDefault<bool>("output_trajectories", false);
+    config_.setDefault<TrajectoryWriter::Precision>("output_trajectories_precision", TrajectoryWriter::Precision::INT16);
+    config_.setDefault<unsigned int>("output_trajectories_decimation", 1);
     config_.setDefault<bool>("output_plots",
                              config_.get<bool>("output_linegraphs") || config_.get<bool>("output_animations"));
     config_.setDefault<bool>("output_animations_color_markers", false);
@@ -99,6 +113,24 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
     config_.setDefault<double>("multiplication_threshold", 1e-2);
     config_.setDefault<unsigned int>("max_multiplication_level", 5);
 
+    // Set defaults for the analytic drift
+    config_.setDefault<bool>("analytic_drift", false);
+    config_.setDefault<unsigned int>("analytic_drift_validation_points", 0);
+    config_.setDefault<unsigned int>("analytic_drift_validation_samples", 100);
+    config_.setDefault<double>("analytic_drift_tolerance", Units::get(0.1, "um"));
+
+    // Set defaults for the sampling of charge carrier lifetimes
+    config_.setDefault<bool>("sample_capture_times", false);
+    config_.setDefault<unsigned int>("capture_time_validation_samples", 0);
+
+    // Set defaults for the pixel response lookup table
+    config_.setDefault<bool>("use_response_table", false);
+    config_.setDefaultArray<unsigned int>("response_table_bins", {5, 5, 10});
+    config_.setDefault<unsigned int>("response_table_samples", 100);
+
+    // Draw random numbers from the random engine of the event by default
+    config_.setDefault<bool>("use_random_pool", false);
+
     // Copy some variables from configuration to avoid lookups:
     temperature_ = config_.get<double>("temperature");
     timestep_min_ = config_.get<double>("timestep_min");
@@ -112,12 +144,18 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
     output_linegraphs_recombined_ = config_.get<bool>("output_linegraphs_recombined");
     output_linegraphs_trapped_ = config_.get<bool>("output_linegraphs_trapped");
     output_animations_ = config_.get<bool>("output_animations");
+    output_trajectories_ = config_.get<bool>("output_trajectories");
+    record_plot_points_ = output_linegraphs_ || output_trajectories_;
     output_plots_step_ = config_.get<double>("output_plots_step");
     propagate_electrons_ = config_.get<bool>("propagate_electrons");
     propagate_holes_ = config_.get<bool>("propagate_holes");
     charge_per_step_ = config_.get<unsigned int>("charge_per_step");
     max_charge_groups_ = config_.get<unsigned int>("max_charge_groups");
     max_multiplication_level_ = config.get<unsigned int>("max_multiplication_level");
+    use_response_table_ = config_.get<bool>("use_response_table");
+    analytic_drift_ = config_.get<bool>("analytic_drift");
+    sample_capture_times_ = config_.get<bool>("sample_capture_times");
+    use_random_pool_ = config_.get<bool>("use_random_pool");
 
     // Enable multithreading of this module if multithreading is enabled and no per-event output plots are requested:
     // FIXME: Review if this is really the case or we can still use multithreading
@@ -171,6 +209,16 @@ void GenericPropagationModule::initialize() {
         }
     }
 
+    // Prepare the per-thread trajectory files
+    if(output_trajectories_) {
+        trajectory_writer_ =
+            std::make_unique<TrajectoryWriter>(this,
+                                               "trajectories",
+                                               config_.get<TrajectoryWriter::Precision>("output_trajectories_precision"),
+                                               config_.get<unsigned int>("output_trajectories_decimation"),
+                                               output_plots_step_);
+    }
+
     if(output_plots_) {
         step_length_histo_ =
             CreateHistogram<TH1D>("step_length_histo",
@@ -328,6 +376,55 @@ void GenericPropagationModule::initialize() {
 
     // Prepare trapping model
     detrapping_ = Detrapping(config_);
+
+    // The analytic drift neglects the deflection in magnetic fields and cannot resolve charge multiplication along the step
+    if(analytic_drift_) {
+        if(!multiplication_.is<NoImpactIonization>()) {
+            throw InvalidCombinationError(config_,
+                                          {"analytic_drift", "multiplication_model"},
+                                          "analytic drift cannot be used with charge multiplication");
+        }
+        if(has_magnetic_field_) {
+            throw InvalidValueError(
+                config_, "analytic_drift", "analytic drift cannot be used in the presence of a magnetic field");
+        }
+
+        auto validation_points = config_.get<unsigned int>("analytic_drift_validation_points");
+        if(validation_points > 0) {
+            validate_analytic_drift(validation_points, config_.get<unsigned int>("analytic_drift_validation_samples"));
+        }
+    }
+
+    // Compare the sampled capture times to the decisions per step
+    auto capture_validation_samples = config_.get<unsigned int>("capture_time_validation_samples");
+    if(sample_capture_times_ && capture_validation_samples > 0) {
+        validate_capture_times(capture_validation_samples);
+    }
+
+    // The response table stores single outcomes per set of charge carriers and cannot represent multiplication
+    if(use_response_table_) {
+        if(!multiplication_.is<NoImpactIonization>()) {
+            throw InvalidCombinationError(config_,
+                                          {"use_response_table", "multiplication_model"},
+                                          "pixel response table cannot be used with charge multiplication");
+        }
+        if(output_linegraphs_) {
+            throw InvalidCombinationError(config_,
+                                          {"use_response_table", "output_linegraphs"},
+                                          "line graphs are not available when using the pixel response table");
+        }
+        if(output_trajectories_) {
+            throw InvalidCombinationError(config_,
+                                          {"use_response_table", "output_trajectories"},
+                                          "trajectories are not available when using the pixel response table");
+        }
+        if(model_->getPixelType() != Pixel::Type::RECTANGLE) {
+            throw InvalidValueError(
+                config_, "use_response_table", "pixel response table is only supported for rectangular pixels");
+        }
+
+        build_response_table();
+    }
 }
 
 void GenericPropagationModule::run(Event* event) {
@@ -386,17 +483,20 @@ void GenericPropagationModule::run(Event* event) {
             }
             charges_remaining -= charge_per_step;
 
-            // Propagate a single charge deposit
-            auto [recombined, trapped, propagated, steps, time] = propagate(event,
-                                                                            deposit,
-                                                                            deposit.getLocalPosition(),
-                                                                            deposit.getType(),
-                                                                            charge_per_step,
-                                                                            deposit.getLocalTime(),
-                                                                            deposit.getGlobalTime(),
-                                                                            0,
-                                                                            propagated_charges,
-                                                                            output_plot_points);
+            // Propagate a single charge deposit or sample its outcome from the response table
+            auto [recombined, trapped, propagated, steps, time] =
+                use_response_table_ ? sample_response(event, deposit, charge_per_step, propagated_charges)
+                                    : propagate(event->getRandomEngine(),
+                                                (use_random_pool_ ? &event->getRandomPool() : nullptr),
+                                                deposit,
+                                                deposit.getLocalPosition(),
+                                                deposit.getType(),
+                                                charge_per_step,
+                                                deposit.getLocalTime(),
+                                                deposit.getGlobalTime(),
+                                                0,
+                                                propagated_charges,
+                                                output_plot_points);
 
             // Update statistical information
             recombined_charges_count += recombined;
@@ -423,6 +523,9 @@ void GenericPropagationModule::run(Event* event) {
             LineGraph::Animate(event->number, this, config_, output_plot_points);
         }
     }
+    if(output_trajectories_) {
+        trajectory_writer_->write(event->number, output_plot_points);
+    }
 
     // Write summary and update statistics
     long double average_time = total_time / std::max(1u, propagated_charges_count);
@@ -453,7 +556,8 @@ void GenericPropagationModule::run(Event* event) {
  * multiple steps, adding a random diffusion to the propagating charge every step.
  */
 std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
-GenericPropagationModule::propagate(Event* event,
+GenericPropagationModule::propagate(RandomNumberGenerator& random_generator,
+                                    RandomNumberPool* random_pool,
                                     const DepositedCharge& deposit,
                                     const ROOT::Math::XYZPoint& pos,
                                     const CarrierType& type,
@@ -480,7 +584,7 @@ GenericPropagationModule::propagate(Event* event,
     long double total_time = 0;
 
     // Add point of deposition to the output plots if requested
-    if(output_linegraphs_) {
+    if(record_plot_points_) {
         output_plot_points.emplace_back(
             std::make_tuple(deposit.getGlobalTime(), charge, deposit.getType(), CarrierState::MOTION),
             std::vector<ROOT::Math::XYZPoint>());
@@ -495,38 +599,47 @@ GenericPropagationModule::propagate(Event* event,
         double diffusion_constant = boltzmann_kT_ * mobility_(type, efield_mag, doping_concentration);
         double diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
 
-        // Compute the independent diffusion in three
+        // Compute the independent diffusion in three dimensions, drawn as one batch from the pool if available
+        if(random_pool != nullptr) {
+            std::array<double, 3> values{};
+            random_pool->normal(values.data(), values.size());
+            return diffusion_std_dev * Eigen::Vector3d(values[0], values[1], values[2]);
+        }
         allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
-        auto x = gauss_distribution(event->getRandomEngine());
-        auto y = gauss_distribution(event->getRandomEngine());
-        auto z = gauss_distribution(event->getRandomEngine());
+        auto x = gauss_distribution(random_generator);
+        auto y = gauss_distribution(random_generator);
+        auto z = gauss_distribution(random_generator);
         return {x, y, z};
     };
 
     // Survival or detrap probability of this charge carrier package, evaluated at every step
     allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+    auto uniform = [&]() {
+        return (random_pool != nullptr ? random_pool->uniform() : uniform_distribution(random_generator));
+    };
+
+    // Unit normal distribution for the diffusion along analytic drift steps
+    allpix::normal_distribution<double> gauss_distribution(0, 1);
+    auto gauss = [&]() { return (random_pool != nullptr ? random_pool->normal() : gauss_distribution(random_generator)); };
 
     // Define lambda functions to compute the charge carrier velocity with or without magnetic field
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
 
         return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
     };
 
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
 
         Eigen::Vector3d velocity;
         auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
         auto mob = mobility_(type, efield.norm(), doping);
         auto exb = efield.cross(bfield);
 
@@ -551,9 +664,51 @@ GenericPropagationModule::propagate(Event* event,
     double last_time = 0;
     size_t next_idx = 0;
     auto state = CarrierState::MOTION;
+
+    // Remaining lifetimes until recombination and trapping, drawn once for the set of charge carriers
+    CaptureClock recombination_clock, trapping_clock;
+    if(sample_capture_times_) {
+        recombination_clock.reset(uniform());
+        trapping_clock.reset(uniform());
+    }
+
+    // Trap the charge carrier, releasing it again if the de-trapping happens within the integration time
+    auto trap_carrier = [&]() {
+        if(output_plots_) {
+            trapping_time_histo_->Fill(static_cast<double>(Units::convert(runge_kutta.getTime(), "ns")), charge);
+        }
+
+        auto detrap_time = detrapping_(type, uniform(), std::sqrt(efield.Mag2()));
+        if((initial_time_local + runge_kutta.getTime() + detrap_time) < integration_time_) {
+            LOG(DEBUG) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
+            // De-trap and advance in time if still below integration time
+            runge_kutta.advanceTime(detrap_time);
+            if(sample_capture_times_) {
+                trapping_clock.reset(uniform());
+            }
+
+            if(output_plots_) {
+                detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
+            }
+        } else {
+            // Mark as trapped otherwise
+            state = CarrierState::TRAPPED;
+        }
+    };
+
+    // Find the time within a step at which a lifetime limit is reached. The decision of the models is monotonic in the
+    // elapsed time for a fixed random number, the time is therefore found by bisection
+    auto lifetime_end = [](const std::function<bool(double)>& decayed, double timestep) {
+        double lower = 0, upper = timestep;
+        for(unsigned int i = 0; i < 40; ++i) {
+            auto middle = (lower + upper) / 2;
+            (decayed(middle) ? upper : lower) = middle;
+        }
+        return upper;
+    };
     while(state == CarrierState::MOTION && (initial_time_local + runge_kutta.getTime()) < integration_time_) {
         // Update output plots if necessary (depending on the plot step)
-        if(output_linegraphs_) {
+        if(record_plot_points_) {
             auto time_idx = static_cast<size_t>(runge_kutta.getTime() / output_plots_step_);
             while(next_idx <= time_idx) {
                 output_plot_points.at(output_plot_index).second.push_back(static_cast<ROOT::Math::XYZPoint>(position));
@@ -566,9 +721,83 @@ GenericPropagationModule::propagate(Event* event,
         last_time = runge_kutta.getTime();
         last_efield = efield;
 
-        // Get electric field at current (pre-step) position
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        // Get electric field and doping concentration at current (pre-step) position
+        double doping = 0;
+        std::tie(efield, doping) = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(position));
+
+        // Take a single closed-form step where the velocity varies slowly enough, otherwise fall back to Runge-Kutta steps
+        if(analytic_drift_) {
+            auto max_time = integration_time_ - initial_time_local - runge_kutta.getTime();
+            if(record_plot_points_) {
+                max_time = std::min(max_time, output_plots_step_);
+            }
+
+            auto drift = analytic_drift_step(type, position, max_time);
+            if(drift.time > runge_kutta.getTimeStep()) {
+                auto timestep = drift.time;
+
+                // Sample the end of the lifetime within the step instead of testing it at the end of the step
+                bool recombined = false, trapped = false;
+                if(sample_capture_times_) {
+                    auto recombination_lifetime = recombination_.getLifetime(type, doping);
+                    auto trapping_lifetime = trapping_.getLifetime(type, std::sqrt(efield.Mag2()));
+                    auto recombination_time = recombination_clock.remaining(recombination_lifetime);
+                    auto trapping_time = trapping_clock.remaining(trapping_lifetime);
+                    recombined = (recombination_time <= timestep && recombination_time <= trapping_time);
+                    trapped = (!recombined && trapping_time <= timestep);
+                    timestep = std::min({timestep, recombination_time, trapping_time});
+                    recombination_clock.advance(timestep, recombination_lifetime);
+                    trapping_clock.advance(timestep, trapping_lifetime);
+                } else {
+                    auto recombination_probability = uniform();
+                    recombined = recombination_(type, doping, recombination_probability, timestep);
+                    if(recombined) {
+                        timestep = lifetime_end(
+                            [&](double t) { return recombination_(type, doping, recombination_probability, t); },
+                            timestep);
+                    }
+                    auto trapping_probability = uniform();
+                    trapped = trapping_(type, trapping_probability, timestep, std::sqrt(efield.Mag2()));
+                    if(trapped) {
+                        timestep = lifetime_end(
+                            [&](double t) { return trapping_(type, trapping_probability, t, std::sqrt(efield.Mag2())); },
+                            timestep);
+                        recombined = false;
+                    }
+                }
+
+                // Drift along the closed-form solution and apply the diffusion of the full step in one draw
+                Eigen::Vector3d perpendicular = drift.direction.unitOrthogonal();
+                auto gauss_parallel = gauss();
+                auto gauss_perpendicular = gauss();
+                auto gauss_cross = gauss();
+                position = drift.origin + drift.distance(timestep) * drift.direction +
+                           drift.sigma_parallel(timestep) * gauss_parallel * drift.direction +
+                           drift.sigma_perpendicular(timestep) * gauss_perpendicular * perpendicular +
+                           drift.sigma_perpendicular(timestep) * gauss_cross * drift.direction.cross(perpendicular);
+                runge_kutta.advanceTime(timestep);
+                runge_kutta.setValue(position);
+
+                LOG(TRACE) << "Analytic step from "
+                           << Units::display(static_cast<ROOT::Math::XYZPoint>(last_position), {"um"}) << " to "
+                           << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"um"}) << " in "
+                           << Units::display(timestep, {"ps", "ns"});
+
+                if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position)) ||
+                   model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+                    state = CarrierState::HALTED;
+                } else if(recombined) {
+                    state = CarrierState::RECOMBINED;
+                } else if(trapped) {
+                    trap_carrier();
+                }
+
+                if(output_plots_) {
+                    step_length_histo_->Fill(static_cast<double>(Units::convert((position - last_position).norm(), "um")));
+                }
+                continue;
+            }
+        }
 
         // Execute a Runge Kutta step
         auto step = runge_kutta.step();
@@ -592,34 +821,33 @@ GenericPropagationModule::propagate(Event* event,
 
         // Physics effects:
 
-        // Check if charge carrier is still alive:
-        if(state == CarrierState::MOTION &&
-           recombination_(type,
-                          detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position)),
-                          uniform_distribution(event->getRandomEngine()),
-                          timestep)) {
-            state = CarrierState::RECOMBINED;
-        }
-
-        // Check if the charge carrier has been trapped:
-        if(state == CarrierState::MOTION &&
-           trapping_(type, uniform_distribution(event->getRandomEngine()), timestep, std::sqrt(efield.Mag2()))) {
-            if(output_plots_) {
-                trapping_time_histo_->Fill(static_cast<double>(Units::convert(runge_kutta.getTime(), "ns")), charge);
+        if(sample_capture_times_) {
+            // Count down the remaining lifetimes of the charge carrier
+            if(state == CarrierState::MOTION &&
+               recombination_clock.advance(
+                   timestep,
+                   recombination_.getLifetime(
+                       type, detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position))))) {
+                state = CarrierState::RECOMBINED;
+            }
+            if(state == CarrierState::MOTION &&
+               trapping_clock.advance(timestep, trapping_.getLifetime(type, std::sqrt(efield.Mag2())))) {
+                trap_carrier();
+            }
+        } else {
+            // Check if charge carrier is still alive:
+            if(state == CarrierState::MOTION &&
+               recombination_(type,
+                              detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position)),
+                              uniform(),
+                              timestep)) {
+                state = CarrierState::RECOMBINED;
             }
 
-            auto detrap_time = detrapping_(type, uniform_distribution(event->getRandomEngine()), std::sqrt(efield.Mag2()));
-            if((initial_time_local + runge_kutta.getTime() + detrap_time) < integration_time_) {
-                LOG(DEBUG) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
-                // De-trap and advance in time if still below integration time
-                runge_kutta.advanceTime(detrap_time);
-
-                if(output_plots_) {
-                    detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
-                }
-            } else {
-                // Mark as trapped otherwise
-                state = CarrierState::TRAPPED;
+            // Check if the charge carrier has been trapped:
+            if(state == CarrierState::MOTION &&
+               trapping_(type, uniform(), timestep, std::sqrt(efield.Mag2()))) {
+                trap_carrier();
             }
         }
 
@@ -646,8 +874,7 @@ GenericPropagationModule::propagate(Event* event,
             // secondaries generated in this step
             double log_prob = 1. / std::log1p(-1. / local_gain);
             for(unsigned int i_carrier = 0; i_carrier < charge; ++i_carrier) {
-                n_secondaries +=
-                    static_cast<unsigned int>(std::log(uniform_distribution(event->getRandomEngine())) * log_prob);
+                n_secondaries += static_cast<unsigned int>(std::log(uniform()) * log_prob);
             }
 
             auto inverted_type = invertCarrierType(type);
@@ -668,7 +895,8 @@ GenericPropagationModule::propagate(Event* event,
                 }
 
                 auto [recombined, trapped, propagated, psteps, ptime] =
-                    propagate(event,
+                    propagate(random_generator,
+                              random_pool,
                               deposit,
                               carrier_pos,
                               inverted_type,
@@ -736,7 +964,7 @@ GenericPropagationModule::propagate(Event* event,
     }
 
     // Set final state of charge carrier for plotting:
-    if(output_linegraphs_) {
+    if(record_plot_points_) {
         // If drift time is larger than integration time or the charge carriers have been collected at the backside, reset:
         if(!model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position)) &&
            (time >= integration_time_ || last_position.z() < -model_->getSensorSize().z() * 0.45)) {
@@ -820,6 +1048,546 @@ GenericPropagationModule::propagate(Event* event,
     return std::make_tuple(recombined_charges_count, trapped_charges_count, propagated_charges_count, steps, total_time);
 }
 
+/**
+ * The velocity at the current position and its gradient along the drift direction define the linear approximation. The
+ * step is limited by the time at which the drift reaches the sensor surface, and is halved until the velocity at the drift
+ * end point and at three standard deviations of the diffusion around it agrees with the approximation. Steps that would
+ * let the carrier diffuse across a sensor surface are rejected, such that surface crossings are resolved by the regular
+ * integration.
+ */
+GenericPropagationModule::AnalyticDrift GenericPropagationModule::analytic_drift_step(const CarrierType& type,
+                                                                                      const Eigen::Vector3d& position,
+                                                                                      double max_time) const {
+    auto velocity = [&](const Eigen::Vector3d& pos) -> Eigen::Vector3d {
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(pos));
+        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
+    };
+
+    AnalyticDrift drift;
+    drift.origin = position;
+    Eigen::Vector3d initial_velocity = velocity(position);
+    drift.speed = initial_velocity.norm();
+    if(drift.speed > 0) {
+        drift.direction = initial_velocity / drift.speed;
+
+        // Velocity gradient along the drift direction, probed at the distance of the longest regular step
+        auto probe = drift.speed * timestep_max_;
+        drift.gradient = (velocity(position + probe * drift.direction).dot(drift.direction) - drift.speed) / probe;
+    }
+
+    auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(position));
+    drift.diffusion_constant = boltzmann_kT_ * mobility_(type, std::sqrt(raw_field.Mag2()), doping);
+
+    // Limit the step to the time at which the drift reaches the sensor surface
+    auto surface_low = model_->getSensorCenter().z() - model_->getSensorSize().z() / 2;
+    auto surface_high = model_->getSensorCenter().z() + model_->getSensorSize().z() / 2;
+    auto time = max_time;
+    if(drift.speed > 0 && drift.direction.z() != 0) {
+        auto distance = ((drift.direction.z() > 0 ? surface_high : surface_low) - position.z()) / drift.direction.z();
+        if(std::fabs(drift.gradient) * distance < 1e-6 * drift.speed) {
+            time = std::min(time, distance / drift.speed);
+        } else if(1 + drift.gradient * distance / drift.speed > 0) {
+            time = std::min(time, std::log1p(drift.gradient * distance / drift.speed) / drift.gradient);
+        }
+    }
+    auto surface_distance = std::min(position.z() - surface_low, surface_high - position.z());
+
+    while(time > timestep_min_) {
+        auto sigma = std::max(drift.sigma_parallel(time), drift.sigma_perpendicular(time));
+        if(3 * sigma < surface_distance) {
+            Eigen::Vector3d end = drift.origin + drift.distance(time) * drift.direction;
+
+            // Compare the velocity to the linear approximation at the end point and around it
+            double deviation = 0;
+            for(const auto& offset : {Eigen::Vector3d(0, 0, 0),
+                                      Eigen::Vector3d(3 * sigma, 0, 0),
+                                      Eigen::Vector3d(-3 * sigma, 0, 0),
+                                      Eigen::Vector3d(0, 3 * sigma, 0),
+                                      Eigen::Vector3d(0, -3 * sigma, 0),
+                                      Eigen::Vector3d(0, 0, 3 * sigma),
+                                      Eigen::Vector3d(0, 0, -3 * sigma)}) {
+                Eigen::Vector3d point = end + offset;
+                Eigen::Vector3d approximation =
+                    (drift.speed + drift.gradient * (point - drift.origin).dot(drift.direction)) * drift.direction;
+                deviation = std::max(deviation, (velocity(point) - approximation).norm());
+            }
+            if(deviation * time / 2 < target_spatial_precision_) {
+                drift.time = time;
+                break;
+            }
+        }
+        time /= 2;
+    }
+    return drift;
+}
+
+/**
+ * The step size control follows the propagation of charge carriers, without diffusion the result is deterministic and
+ * can be compared between the integration methods. With diffusion, it is applied after every step as in the propagation.
+ */
+std::tuple<double, Eigen::Vector3d, unsigned int>
+GenericPropagationModule::drift(const CarrierType& type,
+                                const Eigen::Vector3d& start,
+                                bool analytic,
+                                RandomNumberGenerator* random_generator) const {
+    allpix::normal_distribution<double> gauss_distribution(0, 1);
+    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity =
+        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
+    };
+    auto runge_kutta = make_runge_kutta(tableau::RK5, carrier_velocity, timestep_start_, start);
+
+    Eigen::Vector3d position = start;
+    Eigen::Vector3d last_position = start;
+    unsigned int steps = 0;
+    while(model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position)) &&
+          !model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position)) &&
+          runge_kutta.getTime() < integration_time_) {
+        last_position = position;
+        ++steps;
+
+        if(analytic) {
+            auto drift = analytic_drift_step(type, position, integration_time_ - runge_kutta.getTime());
+            if(drift.time > runge_kutta.getTimeStep()) {
+                position = drift.origin + drift.distance(drift.time) * drift.direction;
+                if(random_generator != nullptr) {
+                    Eigen::Vector3d perpendicular = drift.direction.unitOrthogonal();
+                    auto gauss_parallel = gauss_distribution(*random_generator);
+                    auto gauss_perpendicular = gauss_distribution(*random_generator);
+                    auto gauss_cross = gauss_distribution(*random_generator);
+                    position += drift.sigma_parallel(drift.time) * gauss_parallel * drift.direction +
+                                drift.sigma_perpendicular(drift.time) * gauss_perpendicular * perpendicular +
+                                drift.sigma_perpendicular(drift.time) * gauss_cross * drift.direction.cross(perpendicular);
+                }
+                runge_kutta.advanceTime(drift.time);
+                runge_kutta.setValue(position);
+                continue;
+            }
+        }
+
+        auto step = runge_kutta.step();
+        position = runge_kutta.getValue();
+
+        // Adapt step size to match target precision
+        auto timestep = runge_kutta.getTimeStep();
+        double uncertainty = step.error.norm();
+
+        if(random_generator != nullptr) {
+            auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(position));
+            auto diffusion_constant = boltzmann_kT_ * mobility_(type, std::sqrt(raw_field.Mag2()), doping);
+            auto diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
+            auto x = gauss_distribution(*random_generator);
+            auto y = gauss_distribution(*random_generator);
+            auto z = gauss_distribution(*random_generator);
+            position += diffusion_std_dev * Eigen::Vector3d(x, y, z);
+            runge_kutta.setValue(position);
+        }
+        if(std::fabs(model_->getSensorSize().z() / 2.0 - position.z()) < 2 * step.value.z() ||
+           uncertainty > target_spatial_precision_) {
+            timestep *= 0.75;
+        } else if(2 * uncertainty < target_spatial_precision_) {
+            timestep *= 1.5;
+        }
+        runge_kutta.setTimeStep(std::clamp(timestep, timestep_min_, timestep_max_));
+    }
+
+    // Find proper final position in the sensor
+    if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+        auto intercept = model_->getSensorIntercept(static_cast<ROOT::Math::XYZPoint>(last_position),
+                                                    static_cast<ROOT::Math::XYZPoint>(position));
+        position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
+    }
+    return {runge_kutta.getTime(), position, steps};
+}
+
+/**
+ * Charge carriers are drifted from random positions in the sensor with both integration methods, without diffusion and
+ * finite lifetime. The deviation is quantified by the difference in drift time and end position. In addition, sets of
+ * charge carriers are drifted with diffusion from every position, and the mean and the spread of their lateral end
+ * positions are compared between both methods in units of their statistical uncertainty.
+ */
+void GenericPropagationModule::validate_analytic_drift(unsigned int points, unsigned int samples) const {
+    // Fixed seed, the validation should not depend on the event seeds
+    RandomNumberGenerator random_generator(0);
+    allpix::uniform_real_distribution<double> uniform_distribution(-0.5, 0.5);
+
+    // Mean and standard deviation of the lateral end positions of carriers drifted with diffusion
+    auto spread = [&](const CarrierType& type, const Eigen::Vector3d& start, bool analytic) {
+        std::array<double, 2> sum{}, sum_squares{};
+        for(unsigned int sample = 0; sample < samples; ++sample) {
+            auto position = std::get<1>(drift(type, start, analytic, &random_generator));
+            for(size_t axis = 0; axis < 2; ++axis) {
+                sum[axis] += position[static_cast<Eigen::Index>(axis)];
+                sum_squares[axis] += position[static_cast<Eigen::Index>(axis)] * position[static_cast<Eigen::Index>(axis)];
+            }
+        }
+        std::array<std::pair<double, double>, 2> result{};
+        for(size_t axis = 0; axis < 2; ++axis) {
+            auto mean = sum[axis] / samples;
+            auto variance = std::max(0., (sum_squares[axis] - samples * mean * mean) / (samples - 1));
+            result[axis] = {mean, std::sqrt(variance)};
+        }
+        return result;
+    };
+
+    double max_time_deviation = 0, sum_time_deviation = 0, max_position_deviation = 0, max_spread_deviation = 0;
+    unsigned long runge_kutta_steps = 0, analytic_steps = 0;
+    size_t comparisons = 0;
+    for(unsigned int point = 0; point < points; ++point) {
+        auto size = model_->getSensorSize();
+        auto center = model_->getSensorCenter();
+        Eigen::Vector3d start(center.x() + size.x() * uniform_distribution(random_generator),
+                              center.y() + size.y() * uniform_distribution(random_generator),
+                              center.z() + size.z() * uniform_distribution(random_generator));
+
+        for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+            if((type == CarrierType::ELECTRON && !propagate_electrons_) ||
+               (type == CarrierType::HOLE && !propagate_holes_)) {
+                continue;
+            }
+
+            auto [reference_time, reference_position, reference_steps] = drift(type, start, false);
+            auto [time, position, steps] = drift(type, start, true);
+
+            auto time_deviation = std::fabs(time - reference_time);
+            max_time_deviation = std::max(max_time_deviation, time_deviation);
+            sum_time_deviation += time_deviation;
+            max_position_deviation = std::max(max_position_deviation, (position - reference_position).norm());
+            runge_kutta_steps += reference_steps;
+            analytic_steps += steps;
+            comparisons++;
+
+            // The standard errors of mean and standard deviation of a normal distribution
+            if(samples > 1) {
+                auto reference_spread = spread(type, start, false);
+                auto analytic_spread = spread(type, start, true);
+                for(size_t axis = 0; axis < 2; ++axis) {
+                    const auto& [reference_mean, reference_sigma] = reference_spread[axis];
+                    const auto& [mean, sigma] = analytic_spread[axis];
+                    auto variance_sum = reference_sigma * reference_sigma + sigma * sigma;
+                    auto mean_error = std::sqrt(variance_sum / samples);
+                    auto sigma_error = std::sqrt(variance_sum / (2. * (samples - 1)));
+                    if(mean_error > 0) {
+                        max_spread_deviation = std::max(max_spread_deviation, std::fabs(mean - reference_mean) / mean_error);
+                    }
+                    if(sigma_error > 0) {
+                        max_spread_deviation =
+                            std::max(max_spread_deviation, std::fabs(sigma - reference_sigma) / sigma_error);
+                    }
+                }
+            }
+        }
+    }
+
+    auto mean_time_deviation = sum_time_deviation / static_cast<double>(std::max<size_t>(1, comparisons));
+    LOG(STATUS) << "Validated analytic drift against Runge-Kutta integration at " << points << " positions:" << std::endl
+                << "mean deviation of drift time " << Units::display(mean_time_deviation, {"ps", "ns"})
+                << ", maximum " << Units::display(max_time_deviation, {"ps", "ns"}) << std::endl
+                << "maximum deviation of end position " << Units::display(max_position_deviation, {"nm", "um"}) << std::endl
+                << "maximum deviation of mean and spread of lateral end positions with diffusion for " << samples
+                << " charge carriers " << max_spread_deviation << " standard errors" << std::endl
+                << "steps taken: " << analytic_steps << " analytic, " << runge_kutta_steps << " Runge-Kutta";
+
+    auto tolerance = config_.get<double>("analytic_drift_tolerance");
+    if(max_position_deviation > tolerance) {
+        LOG(WARNING) << "Analytic drift deviates from Runge-Kutta integration by "
+                     << Units::display(max_position_deviation, {"nm", "um"})
+                     << " in end position, exceeding the tolerance of " << Units::display(tolerance, {"nm", "um"});
+    }
+    if(max_spread_deviation > 5) {
+        LOG(WARNING) << "Analytic drift deviates from Runge-Kutta integration in the diffusion of charge carriers by "
+                     << max_spread_deviation << " standard errors";
+    }
+}
+
+/**
+ * The lifetimes at the sensor center are combined into the capture rate, and the fractions of charge carriers captured
+ * within the integration time are compared for decisions in steps of the maximum time step and for capture clocks.
+ */
+void GenericPropagationModule::validate_capture_times(unsigned int samples) const {
+    // Fixed seed, the validation should not depend on the event seeds
+    RandomNumberGenerator random_generator(0);
+
+    auto center = model_->getSensorCenter();
+    auto [efield, doping] = detector_->getElectricFieldAndDoping(center);
+    for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+        if((type == CarrierType::ELECTRON && !propagate_electrons_) || (type == CarrierType::HOLE && !propagate_holes_)) {
+            continue;
+        }
+
+        auto lifetime = 1. / (1. / recombination_.getLifetime(type, doping) +
+                              1. / trapping_.getLifetime(type, std::sqrt(efield.Mag2())));
+        auto [per_step, clock] =
+            compare_capture_sampling(random_generator, lifetime, timestep_max_, integration_time_, samples);
+
+        auto expected = -std::expm1(-std::ceil(integration_time_ / timestep_max_) * timestep_max_ / lifetime);
+        auto sigma = std::sqrt(2 * expected * (1 - expected) / samples);
+        LOG(STATUS) << "Compared capture time sampling with per-step sampling for " << samples << " charge carriers ("
+                    << type << "):" << std::endl
+                    << "captured fraction " << clock << " with capture times, " << per_step << " per step, expected "
+                    << expected;
+        if(std::fabs(clock - per_step) > 5 * sigma) {
+            LOG(WARNING) << "Capture time sampling deviates from per-step sampling by "
+                         << std::fabs(clock - per_step) / sigma << " standard deviations";
+        }
+    }
+}
+
+/**
+ * Sets of a single charge carrier are propagated with the full drift-diffusion model from random positions within each
+ * voxel of the pixel cell in the center of the pixel matrix, and the outcomes are stored. This assumes that fields and
+ * doping are identical for all pixels. The table is keyed by all non-output parameters of the module and a hash of the
+ * fields at the voxel centers, and is read from the configured file instead if it matches.
+ */
+void GenericPropagationModule::build_response_table() {
+    auto bins = config_.getArray<unsigned int>("response_table_bins");
+    if(bins.size() != 3 || bins[0] == 0 || bins[1] == 0 || bins[2] == 0) {
+        throw InvalidValueError(config_, "response_table_bins", "three non-zero numbers of voxels required");
+    }
+    auto samples = config_.get<unsigned int>("response_table_samples");
+    if(samples == 0) {
+        throw InvalidValueError(config_, "response_table_samples", "at least one sample per voxel required");
+    }
+
+    response_table_.bins = {bins[0], bins[1], bins[2]};
+    response_table_.size = {model_->getPixelSize().x(), model_->getPixelSize().y(), model_->getSensorSize().z()};
+    response_table_.samples = samples;
+
+    // Reference pixel in the center of the matrix and corner of its cell
+    auto reference = Pixel::Index(static_cast<int>(model_->getNPixels().x() / 2),
+                                  static_cast<int>(model_->getNPixels().y() / 2));
+    auto center = model_->getPixelCenter(reference.x(), reference.y());
+    auto origin = ROOT::Math::XYZPoint(center.x() - response_table_.size[0] / 2,
+                                       center.y() - response_table_.size[1] / 2,
+                                       model_->getSensorCenter().z() - response_table_.size[2] / 2);
+    std::array<double, 3> voxel_size{};
+    for(size_t i = 0; i < 3; ++i) {
+        voxel_size[i] = response_table_.size[i] / static_cast<double>(bins[i]);
+    }
+
+    // Identify the configuration the table is valid for
+    FNV1aHash field_hash;
+    for(size_t x = 0; x < bins[0]; ++x) {
+        for(size_t y = 0; y < bins[1]; ++y) {
+            for(size_t z = 0; z < bins[2]; ++z) {
+                auto position = ROOT::Math::XYZPoint(origin.x() + (static_cast<double>(x) + 0.5) * voxel_size[0],
+                                                     origin.y() + (static_cast<double>(y) + 0.5) * voxel_size[1],
+                                                     origin.z() + (static_cast<double>(z) + 0.5) * voxel_size[2]);
+                auto efield = detector_->getElectricField(position);
+                field_hash.add(efield.x());
+                field_hash.add(efield.y());
+                field_hash.add(efield.z());
+                field_hash.add(detector_->getDopingConcentration(position));
+                if(has_magnetic_field_) {
+                    auto bfield = detector_->getMagneticField(position);
+                    field_hash.add(bfield.x());
+                    field_hash.add(bfield.y());
+                    field_hash.add(bfield.z());
+                }
+            }
+        }
+    }
+    std::stringstream key;
+    key << std::setprecision(12) << model_->getType() << ";" << response_table_.size[0] << ";" << response_table_.size[1]
+        << ";" << response_table_.size[2] << ";" << has_magnetic_field_ << ";" << std::hex << field_hash.value()
+        << std::dec;
+    for(const auto& [name, value] : config_.getAll()) {
+        if(name.front() != '_' && name.rfind("output_", 0) != 0 && name.rfind("log_", 0) != 0 &&
+           name != "response_table_file") {
+            key << ";" << name << "=" << value;
+        }
+    }
+    response_table_.key = key.str();
+
+    // Read table from file if available
+    std::filesystem::path table_file;
+    if(config_.has("response_table_file")) {
+        table_file = config_.getPath("response_table_file");
+        if(std::filesystem::exists(table_file)) {
+            PixelResponseTable cached;
+            try {
+                std::ifstream file(table_file, std::ios::binary);
+                cereal::PortableBinaryInputArchive archive(file);
+                archive(cached);
+            } catch(cereal::Exception& e) {
+                throw InvalidValueError(
+                    config_, "response_table_file", "could not read response table: " + std::string(e.what()));
+            }
+
+            if(cached.key == response_table_.key) {
+                response_table_ = std::move(cached);
+                LOG(STATUS) << "Read pixel response table from " << table_file;
+                return;
+            }
+            LOG(WARNING) << "Pixel response table in " << table_file
+                         << " was generated for a different configuration, regenerating";
+        }
+    }
+
+    LOG(STATUS) << "Building pixel response table with " << bins[0] << "x" << bins[1] << "x" << bins[2] << " voxels and "
+                << samples << " samples per voxel, this may take a while";
+
+    // Calibration propagations should not enter the monitoring histograms
+    auto output_plots = output_plots_;
+    output_plots_ = false;
+
+    // Fixed seed, the table should only depend on the configuration
+    RandomNumberGenerator random_generator(0);
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+    LineGraph::OutputPlotPoints output_plot_points;
+
+    response_table_.outcomes.assign(2 * bins[0] * bins[1] * bins[2] * samples, {});
+    std::map<CarrierState, unsigned long> states;
+    for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+        if((type == CarrierType::ELECTRON && !propagate_electrons_) || (type == CarrierType::HOLE && !propagate_holes_)) {
+            continue;
+        }
+        size_t type_index = (type == CarrierType::ELECTRON ? 0 : 1);
+
+        for(size_t x = 0; x < bins[0]; ++x) {
+            for(size_t y = 0; y < bins[1]; ++y) {
+                for(size_t z = 0; z < bins[2]; ++z) {
+                    auto index = response_table_.index(type_index, x, y, z);
+                    for(unsigned int sample = 0; sample < samples; ++sample) {
+                        auto start = ROOT::Math::XYZPoint(
+                            origin.x() + (static_cast<double>(x) + uniform_distribution(random_generator)) * voxel_size[0],
+                            origin.y() + (static_cast<double>(y) + uniform_distribution(random_generator)) * voxel_size[1],
+                            origin.z() + (static_cast<double>(z) + uniform_distribution(random_generator)) * voxel_size[2]);
+                        DepositedCharge deposit(start, detector_->getGlobalPosition(start), type, 1, 0., 0.);
+
+                        std::vector<PropagatedCharge> propagated_charges;
+                        propagate(random_generator,
+                                  nullptr,
+                                  deposit,
+                                  start,
+                                  type,
+                                  1,
+                                  0.,
+                                  0.,
+                                  0,
+                                  propagated_charges,
+                                  output_plot_points);
+                        const auto& propagated_charge = propagated_charges.front();
+
+                        // Store final position relative to the pixel the carriers ended up in
+                        auto end = propagated_charge.getLocalPosition();
+                        auto [xpixel, ypixel] = model_->getPixelIndex(end);
+                        auto pixel_center = model_->getPixelCenter(xpixel, ypixel);
+
+                        auto& outcome = response_table_.outcomes[index + sample];
+                        outcome.dx = xpixel - reference.x();
+                        outcome.dy = ypixel - reference.y();
+                        outcome.x = static_cast<float>(end.x() - pixel_center.x());
+                        outcome.y = static_cast<float>(end.y() - pixel_center.y());
+                        outcome.z = static_cast<float>(end.z());
+                        outcome.time = static_cast<float>(propagated_charge.getLocalTime());
+                        outcome.state = static_cast<std::uint8_t>(propagated_charge.getState());
+                        states[propagated_charge.getState()]++;
+                    }
+                }
+            }
+        }
+    }
+    output_plots_ = output_plots;
+
+    unsigned long total = 0;
+    for(const auto& [state, count] : states) {
+        total += count;
+    }
+    LOG(INFO) << "Built pixel response table with " << bins[0] << "x" << bins[1] << "x" << bins[2] << " voxels"
+              << std::endl
+              << "Fraction of samples recombined: "
+              << static_cast<double>(states[CarrierState::RECOMBINED]) / static_cast<double>(std::max(1ul, total))
+              << ", trapped: "
+              << static_cast<double>(states[CarrierState::TRAPPED]) / static_cast<double>(std::max(1ul, total));
+
+    if(!table_file.empty()) {
+        std::ofstream file(table_file, std::ios::binary);
+        if(!file) {
+            throw InvalidValueError(config_, "response_table_file", "file cannot be created");
+        }
+        cereal::PortableBinaryOutputArchive archive(file);
+        archive(response_table_);
+        LOG(STATUS) << "Wrote pixel response table to " << table_file;
+    }
+}
+
+/**
+ * One of the outcomes stored for the voxel the deposit is located in is drawn at random and translated to the pixel of the
+ * deposit. The full set of charge carriers shares this outcome, as it would when propagated together.
+ */
+std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
+GenericPropagationModule::sample_response(Event* event,
+                                          const DepositedCharge& deposit,
+                                          unsigned int charge,
+                                          std::vector<PropagatedCharge>& propagated_charges) const {
+    auto position = deposit.getLocalPosition();
+    auto [xpixel, ypixel] = model_->getPixelIndex(position);
+    auto center = model_->getPixelCenter(xpixel, ypixel);
+
+    // Find voxel of the deposit within its pixel cell
+    const auto& bins = response_table_.bins;
+    std::array<double, 3> relative{position.x() - center.x() + response_table_.size[0] / 2,
+                                   position.y() - center.y() + response_table_.size[1] / 2,
+                                   position.z() - model_->getSensorCenter().z() + response_table_.size[2] / 2};
+    std::array<size_t, 3> voxel{};
+    for(size_t i = 0; i < 3; ++i) {
+        auto coordinate = std::floor(relative[i] / response_table_.size[i] * static_cast<double>(bins[i]));
+        voxel[i] = static_cast<size_t>(std::clamp(coordinate, 0., static_cast<double>(bins[i] - 1)));
+    }
+
+    // Draw one of the stored outcomes
+    auto type = deposit.getType();
+    auto first = response_table_.index(type == CarrierType::ELECTRON ? 0 : 1, voxel[0], voxel[1], voxel[2]);
+    allpix::uniform_real_distribution<double> uniform_distribution(0, response_table_.samples);
+    auto random = (use_random_pool_ ? event->getRandomPool().uniform() * response_table_.samples
+                                    : uniform_distribution(event->getRandomEngine()));
+    auto sample = std::min(static_cast<size_t>(random), static_cast<size_t>(response_table_.samples - 1));
+    const auto& outcome = response_table_.outcomes[first + sample];
+
+    auto final_pixel = model_->getPixelCenter(xpixel + outcome.dx, ypixel + outcome.dy);
+    auto local_position = ROOT::Math::XYZPoint(final_pixel.x() + outcome.x, final_pixel.y() + outcome.y, outcome.z);
+    auto state = static_cast<CarrierState>(outcome.state);
+
+    // The table is generated for carriers starting at zero, cut at the remaining integration time of this deposit
+    double time = outcome.time;
+    if(deposit.getLocalTime() + time > integration_time_) {
+        time = integration_time_ - deposit.getLocalTime();
+        state = CarrierState::MOTION;
+    }
+
+    unsigned int recombined_charges_count = 0;
+    unsigned int trapped_charges_count = 0;
+    if(state == CarrierState::RECOMBINED) {
+        recombined_charges_count += charge;
+    } else if(state == CarrierState::TRAPPED) {
+        trapped_charges_count += charge;
+    }
+
+    LOG(DEBUG) << " Sampled " << charge << " to " << Units::display(local_position, {"mm", "um"}) << " in "
+               << Units::display(time, "ns") << " time, final state: " << allpix::to_string(state);
+
+    auto global_position = detector_->getGlobalPosition(local_position);
+    propagated_charges.emplace_back(local_position,
+                                    global_position,
+                                    type,
+                                    charge,
+                                    deposit.getLocalTime() + time,
+                                    deposit.getGlobalTime() + time,
+                                    state,
+                                    &deposit);
+
+    if(output_plots_) {
+        drift_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
+        group_size_histo_->Fill(charge);
+    }
+
+    return std::make_tuple(recombined_charges_count, trapped_charges_count, charge, 1u, time * charge);
+}
+
 void GenericPropagationModule::finalize() {
     if(output_plots_) {
         group_size_histo_->Get()->GetXaxis()->SetRange(1, group_size_histo_->Get()->GetNbinsX() + 1);
@@ -10,10 +10,13 @@
  */
 
 #include <atomic>
+#include <cmath>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include <Eigen/Core>
 #include <Math/Point3D.h>
 #include <TFile.h>
 #include <TH1D.h>
@@ -24,6 +27,8 @@
 #include "core/messenger/Messenger.hpp"
 #include "core/module/Event.hpp"
 #include "core/module/Module.hpp"
+#include "core/utils/prng.h"
+#include "core/utils/random_pool.h"
 
 #include "objects/DepositedCharge.hpp"
 #include "objects/PropagatedCharge.hpp"
@@ -36,6 +41,9 @@
 
 #include "tools/ROOT.h"
 #include "tools/line_graphs.h"
+#include "tools/trajectory_writer.h"
+
+#include "PixelResponseTable.hpp"
 
 namespace allpix {
 
@@ -81,7 +89,8 @@ namespace allpix {
 
         /**
          * @brief Propagate a single set of charges through the sensor
-         * @param event               Pointer to current event
+         * @param random_generator    Reference to the random number generator to use
+         * @param random_pool         Pool of random numbers used instead of the generator, nullptr to use the generator
          * @param deposit             Reference to the original deposited charge object
          * @param pos                 Position of the deposit in the sensor
          * @param type                Type of the carrier to propagate
@@ -95,7 +104,8 @@ namespace allpix {
          * @return Total recombined, trapped and propagated charge for statistics purposes
          */
         std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
-        propagate(Event* event,
+        propagate(RandomNumberGenerator& random_generator,
+                  RandomNumberPool* random_pool,
                   const DepositedCharge& deposit,
                   const ROOT::Math::XYZPoint& pos,
                   const CarrierType& type,
@@ -106,16 +116,126 @@ namespace allpix {
                   std::vector<PropagatedCharge>& propagated_charges,
                   LineGraph::OutputPlotPoints& output_plot_points) const;
 
+        /**
+         * @brief Drift of a charge carrier through a region in which its velocity varies linearly along the drift direction
+         *
+         * The drift distance follows from the closed-form solution of \f$ds/dt = v + k s\f$ with the speed \f$v\f$ at the
+         * origin and the velocity gradient \f$k\f$ along the drift direction. The diffusion along the drift direction is
+         * described by the corresponding Ornstein-Uhlenbeck process, perpendicular to it by free diffusion.
+         */
+        struct AnalyticDrift {
+            // Longest accepted duration of the step, zero if the drift cannot be described analytically
+            double time{};
+            Eigen::Vector3d origin{Eigen::Vector3d::Zero()};
+            Eigen::Vector3d direction{Eigen::Vector3d::UnitZ()};
+            double speed{};
+            double gradient{};
+            double diffusion_constant{};
+
+            /**
+             * @brief Drift distance along the drift direction
+             * @param t Time since the start of the step
+             */
+            double distance(double t) const {
+                return (std::fabs(gradient * t) < 1e-6 ? speed * t * (1 + gradient * t / 2)
+                                                        : speed * std::expm1(gradient * t) / gradient);
+            }
+
+            /**
+             * @brief Width of the diffusion along the drift direction
+             * @param t Time since the start of the step
+             */
+            double sigma_parallel(double t) const {
+                return std::sqrt(2 * diffusion_constant *
+                                 (std::fabs(gradient * t) < 1e-6 ? t * (1 + gradient * t)
+                                                                 : std::expm1(2 * gradient * t) / (2 * gradient)));
+            }
+
+            /**
+             * @brief Width of the diffusion perpendicular to the drift direction
+             * @param t Time since the start of the step
+             */
+            double sigma_perpendicular(double t) const { return std::sqrt(2 * diffusion_constant * t); }
+        };
+
+        /**
+         * @brief Determine the longest step for which the drift of a charge carrier can be described analytically
+         * @param type     Type of the charge carrier
+         * @param position Position of the charge carrier
+         * @param max_time Maximum duration of the step
+         * @return Analytic drift, with zero duration if the velocity varies too strongly over the reachable region
+         *
+         * The step is accepted if the deviation of the velocity from the linear approximation at the drift end point and
+         * within three standard deviations of the diffusion around it keeps the position error below the spatial precision.
+         */
+        AnalyticDrift analytic_drift_step(const CarrierType& type, const Eigen::Vector3d& position, double max_time) const;
+
+        /**
+         * @brief Drift a single charge carrier without diffusion and lifetime until it leaves the sensor
+         * @param type     Type of the charge carrier
+         * @param start    Start position of the charge carrier
+         * @param analytic Use the analytic drift where possible instead of only Runge-Kutta integration
+         * @param random_generator Random number generator to apply diffusion with, no diffusion if not provided
+         * @return Drift time, end position and number of steps
+         */
+        std::tuple<double, Eigen::Vector3d, unsigned int> drift(const CarrierType& type,
+                                                                const Eigen::Vector3d& start,
+                                                                bool analytic,
+                                                                RandomNumberGenerator* random_generator = nullptr) const;
+
+        /**
+         * @brief Compare the analytic drift to the Runge-Kutta integration at random positions and report the deviation
+         * @param points Number of random start positions
+         * @param samples Number of charge carriers drifted with diffusion from every position to compare the spread
+         */
+        void validate_analytic_drift(unsigned int points, unsigned int samples) const;
+
+        /**
+         * @brief Compare the fraction of captured charge carriers between capture clocks and decisions per step
+         * @param samples Number of charge carriers to sample with each method
+         */
+        void validate_capture_times(unsigned int samples) const;
+
+        /**
+         * @brief Fill the pixel response table from propagations with the full drift-diffusion model or read it from file
+         */
+        void build_response_table();
+
+        /**
+         * @brief Obtain the final state of a single set of charges by sampling the pixel response table
+         * @param event              Pointer to current event
+         * @param deposit            Reference to the original deposited charge object
+         * @param charge             Total charge of the observed charge carrier set
+         * @param propagated_charges Reference to vector with all produced final PropagatedCharge objects
+         *
+         * @return Total recombined, trapped and propagated charge for statistics purposes
+         */
+        std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
+        sample_response(Event* event,
+                        const DepositedCharge& deposit,
+                        unsigned int charge,
+                        std::vector<PropagatedCharge>& propagated_charges) const;
+
         // Local copies of configuration parameters to avoid costly lookup:
         double temperature_{}, timestep_min_{}, timestep_max_{}, timestep_start_{}, integration_time_{},
             target_spatial_precision_{}, output_plots_step_{};
         bool output_plots_{}, output_linegraphs_{}, output_linegraphs_collected_{}, output_linegraphs_recombined_{},
-            output_linegraphs_trapped_{}, output_animations_{};
+            output_linegraphs_trapped_{}, output_animations_{}, output_trajectories_{}, record_plot_points_{};
         bool propagate_electrons_{}, propagate_holes_{};
+        bool analytic_drift_{};
+        bool sample_capture_times_{};
+        bool use_random_pool_{};
         unsigned int charge_per_step_{};
         unsigned int max_charge_groups_{};
         unsigned int max_multiplication_level_{};
 
+        // Writer for the sampled trajectories of the charge carriers
+        std::unique_ptr<TrajectoryWriter> trajectory_writer_;
+
+        // Lookup table of the pixel response
+        bool use_response_table_{};
+        PixelResponseTable response_table_;
+
         // Models for electron and hole mobility and lifetime
         Mobility mobility_;
         Recombination recombination_;
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief Definition of a lookup table of the pixel response for the generic propagation
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_GENERIC_PROPAGATION_RESPONSE_TABLE_H
+#define ALLPIX_GENERIC_PROPAGATION_RESPONSE_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cereal/types/array.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+namespace allpix {
+    /**
+     * @brief Lookup table of propagation outcomes for charge carriers starting in voxels of a pixel cell
+     *
+     * For every carrier type and every voxel of a regular grid spanning the pixel cell and the full sensor thickness, a
+     * fixed number of outcomes of the full drift-diffusion propagation is stored. Together, the outcomes of a voxel
+     * represent the joint distribution of the pixel the carriers end up in, their arrival time and final state, including
+     * losses from recombination and trapping.
+     */
+    struct PixelResponseTable {
+        /**
+         * @brief Outcome of a single propagation from within a voxel
+         */
+        struct Outcome {
+            /**
+             * @brief Offset of the final pixel from the pixel the carriers started in
+             */
+            std::int32_t dx{}, dy{};
+
+            /**
+             * @brief Final position relative to the center of the final pixel in x and y, and local z position
+             */
+            float x{}, y{}, z{};
+
+            /**
+             * @brief Propagation time
+             */
+            float time{};
+
+            /**
+             * @brief Final state of the carriers, stored as value of \ref CarrierState
+             */
+            std::uint8_t state{};
+
+            template <class Archive> void serialize(Archive& archive) { archive(dx, dy, x, y, z, time, state); }
+        };
+
+        /**
+         * @brief Description of the configuration the table has been generated for
+         */
+        std::string key;
+
+        /**
+         * @brief Number of voxels in x, y and z
+         */
+        std::array<size_t, 3> bins{};
+
+        /**
+         * @brief Extent of the table in x, y and z
+         */
+        std::array<double, 3> size{};
+
+        /**
+         * @brief Number of stored outcomes per voxel
+         */
+        unsigned int samples{};
+
+        /**
+         * @brief Outcomes for all voxels, the outcomes of a voxel are stored contiguously starting at \ref index
+         */
+        std::vector<Outcome> outcomes;
+
+        /**
+         * @brief Index of the first outcome of a voxel for a given carrier type
+         * @param type Carrier type index, zero for electrons and one for holes
+         * @param x Voxel index in x
+         * @param y Voxel index in y
+         * @param z Voxel index in z
+         */
+        size_t index(size_t type, size_t x, size_t y, size_t z) const {
+            return (((type * bins[0] + x) * bins[1] + y) * bins[2] + z) * samples;
+        }
+
+        /**
+         * @brief Serialization of the response table
+         */
+        template <class Archive> void serialize(Archive& archive) { archive(key, bins, size, samples, outcomes); }
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_GENERIC_PROPAGATION_RESPONSE_TABLE_H */
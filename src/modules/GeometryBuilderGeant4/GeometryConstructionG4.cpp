@@ -13,7 +13,13 @@
 #include "GeometryConstructionG4.hpp"
 #include "MaterialManager.hpp"
 
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 
@@ -32,9 +38,15 @@
 #include <G4UnionSolid.hh>
 #include <G4UserLimits.hh>
 #include <G4VSolid.hh>
+#include <G4Version.hh>
 #include <G4VisAttributes.hh>
 
+#ifdef Geant4_GDML
+#include <G4GDMLParser.hh>
+#endif
+
 #include "core/module/exceptions.h"
+#include "core/utils/hash.h"
 #include "core/utils/log.h"
 #include "tools/ROOT.h"
 #include "tools/geant4/G4LoggingDestination.hpp"
@@ -119,16 +131,149 @@ G4VPhysicalVolume* GeometryConstructionG4::Construct() {
     passive_builder_->buildVolumes(world_log_);
     detector_builder_->build(world_log_);
 
-    // Check for overlaps:
-    check_overlaps();
+    // Look up the geometry in the record of geometries which passed the overlap check before
+    std::string key;
+    bool checked = false;
+    if(config_.has("overlap_check_directory")) {
+        key = geometry_key();
+        checked = read_overlap_check(key);
+    }
+
+    // Check for overlaps unless the identical geometry has been checked before:
+    bool overlaps = false;
+    if(checked) {
+        LOG(INFO) << "Geometry passed the overlap check in a previous run, skipping overlap check";
+    } else {
+        overlaps = check_overlaps();
+    }
 
     // Verify transformations:
     verify_transforms();
 
+    // Only record geometries without overlaps, such that problems are reported in every run until they are fixed
+    if(!key.empty() && !checked && !overlaps) {
+        record_overlap_check(key);
+    }
+
     return world_phys_.get();
 }
 
-void GeometryConstructionG4::check_overlaps() const {
+std::string GeometryConstructionG4::geometry_key() const {
+    std::stringstream key;
+    key << std::setprecision(17) << "Geant4 " << G4VERSION_NUMBER;
+
+    // World volume
+    for(const auto& name : {"world_material", "world_margin_percentage", "world_minimum_margin"}) {
+        key << "\n" << name << "=" << config_.getText(name, "");
+    }
+    auto min_coord = geo_manager_->getMinimumCoordinate();
+    auto max_coord = geo_manager_->getMaximumCoordinate();
+    key << "\nworld=" << min_coord.x() << "," << min_coord.y() << "," << min_coord.z() << "," << max_coord.x() << ","
+        << max_coord.y() << "," << max_coord.z();
+
+    // Detectors with their placement and the full model configuration
+    for(const auto& detector : geo_manager_->getDetectors()) {
+        auto position = detector->getPosition();
+        std::vector<double> rotation(9);
+        detector->getOrientation().GetComponents(rotation.begin(), rotation.end());
+        key << "\n[" << detector->getName() << "]\nposition=" << position.x() << "," << position.y() << ","
+            << position.z() << "\norientation=";
+        for(const auto& component : rotation) {
+            key << component << ",";
+        }
+        for(const auto& model_config : detector->getModel()->getConfigurations()) {
+            key << "\n[" << detector->getName() << ":" << model_config.getName() << "]";
+            for(const auto& [name, value] : model_config.getAll()) {
+                key << "\n" << name << "=" << value;
+            }
+        }
+    }
+
+    // Passive materials, including the content of GDML files
+    for(const auto& passive_config : geo_manager_->getPassiveElements()) {
+        key << "\n[" << passive_config.getName() << "]";
+        for(const auto& [name, value] : passive_config.getAll()) {
+            key << "\n" << name << "=" << value;
+        }
+        if(passive_config.has("file_name")) {
+            std::ifstream file(passive_config.getPath("file_name"), std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            FNV1aHash file_hash;
+            file_hash.add(content.data(), content.size());
+            key << "\nfile_hash=" << std::hex << file_hash.value() << std::dec;
+        }
+    }
+
+    return key.str();
+}
+
+std::filesystem::path GeometryConstructionG4::overlap_check_file(const std::string& key,
+                                                                const std::string& extension) const {
+    FNV1aHash hash;
+    hash.add(key.data(), key.size());
+    std::stringstream name;
+    name << "geometry_" << std::hex << hash.value() << "." << extension;
+    return config_.getPath("overlap_check_directory") / name.str();
+}
+
+bool GeometryConstructionG4::read_overlap_check(const std::string& key) const {
+    std::ifstream file(overlap_check_file(key, "key"));
+    if(!file.good()) {
+        LOG(DEBUG) << "No record of an overlap check for the current geometry";
+        return false;
+    }
+
+    // Compare the full description to exclude hash collisions
+    std::string recorded_key((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if(recorded_key != key) {
+        LOG(DEBUG) << "Overlap check record " << overlap_check_file(key, "key") << " belongs to a different geometry";
+        return false;
+    }
+
+    LOG(DEBUG) << "Found overlap check record " << overlap_check_file(key, "key");
+    return true;
+}
+
+void GeometryConstructionG4::record_overlap_check(const std::string& key) const {
+    auto directory = config_.getPath("overlap_check_directory");
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if(error) {
+        LOG(WARNING) << "Cannot create overlap check directory " << directory << ": " << error.message();
+        return;
+    }
+
+#ifdef Geant4_GDML
+    // Export the constructed world for inspection and use in other applications. Not all volumes can be represented in
+    // GDML, e.g. parameterized bump bonds of arbitrary shape, so a failed export does not invalidate the record. The GDML
+    // writer reports problems via G4Exception, which the exception handler of the framework converts to exceptions.
+    auto gdml_file = overlap_check_file(key, "gdml");
+    try {
+        std::filesystem::remove(gdml_file);
+        G4GDMLParser parser;
+        parser.Write(gdml_file.string(), world_log_.get(), false);
+    } catch(const Exception& e) {
+        LOG(WARNING) << "Could not export geometry to GDML file " << gdml_file << ":" << std::endl << e.what();
+        std::filesystem::remove(gdml_file, error);
+    }
+#endif
+
+    // Write the key last to only mark complete records as valid
+    auto key_file = overlap_check_file(key, "key");
+    auto temporary_file = key_file;
+    temporary_file += ".tmp";
+    std::ofstream file(temporary_file);
+    file << key;
+    file.close();
+    std::filesystem::rename(temporary_file, key_file, error);
+    if(error) {
+        LOG(WARNING) << "Cannot write overlap check record " << key_file << ": " << error.message();
+        return;
+    }
+    LOG(INFO) << "Recorded passed overlap check of the geometry in " << key_file;
+}
+
+bool GeometryConstructionG4::check_overlaps() const {
     G4PhysicalVolumeStore* phys_volume_store = G4PhysicalVolumeStore::GetInstance();
     LOG(TRACE) << "Checking overlaps";
     bool overlapFlag = false;
@@ -145,6 +290,7 @@ void GeometryConstructionG4::check_overlaps() const {
     } else {
         LOG(INFO) << "No overlapping volumes detected.";
     }
+    return overlapFlag;
 }
 
 // Verify that coordinate transformations are performed properly
@@ -12,7 +12,9 @@
 #ifndef ALLPIX_MODULE_GEOMETRY_CONSTRUCTION_H
 #define ALLPIX_MODULE_GEOMETRY_CONSTRUCTION_H
 
+#include <filesystem>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include <G4Material.hh>
@@ -49,8 +51,35 @@ namespace allpix {
 
         /**
          * @brief Check all placed volumes for overlaps
+         * @return True if overlapping volumes have been found, false otherwise
          */
-        void check_overlaps() const;
+        bool check_overlaps() const;
+
+        /**
+         * @brief Describe the full geometry, including world, detector models, placements and passive materials
+         * @return Description of the geometry, identical for identical geometries
+         */
+        std::string geometry_key() const;
+
+        /**
+         * @brief Check if the current geometry has passed the overlap check in a previous run
+         * @param key Description of the current geometry
+         * @return True if a matching record of a passed overlap check has been found, false otherwise
+         */
+        bool read_overlap_check(const std::string& key) const;
+
+        /**
+         * @brief Record the description of a geometry which passed the overlap check and export the constructed world
+         * @param key Description of the current geometry
+         */
+        void record_overlap_check(const std::string& key) const;
+
+        /**
+         * @brief Path of a file in the overlap check directory belonging to the given geometry
+         * @param key Description of the geometry
+         * @param extension File extension
+         */
+        std::filesystem::path overlap_check_file(const std::string& key, const std::string& extension) const;
 
         /**
          * @brief Verify that framework coordinate transformations match with the transformations built from Geant4 volumes
@@ -95,6 +95,11 @@ namespace allpix {
                 LOG(DEBUG) << "Volume " << name_list.size() << ": " << gdml_daughter_name;
                 name_list.push_back(gdml_daughter_name);
 
+                // Register the logical volume to allow other modules to refer to the volumes of this passive element
+                geo_manager_->setExternalObject(getName(),
+                                                "passive_material_log_" + gdml_daughter_name,
+                                                std::shared_ptr<G4LogicalVolume>(gdml_daughter_log, [](G4LogicalVolume*) {}));
+
                 // Add offset and rotation to current daughter location
                 G4ThreeVector position_vector = toG4Vector(position_);
                 auto* daughter_rotation = gdml_daughter->GetRotation();
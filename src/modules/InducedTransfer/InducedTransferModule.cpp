@@ -11,6 +11,7 @@
 
 #include "InducedTransferModule.hpp"
 
+#include <memory_resource>
 #include <string>
 #include <utility>
 
@@ -52,7 +53,9 @@ void InducedTransferModule::run(Event* event) {
     LOG(TRACE) << "Calculating induced charge on pixels";
     bool found_electrons = false, found_holes = false;
 
-    std::map<Pixel::Index, std::vector<std::pair<double, const PropagatedCharge*>>> pixel_map;
+    // Temporary map allocated from the event memory arena
+    std::pmr::map<Pixel::Index, std::pmr::vector<std::pair<double, const PropagatedCharge*>>> pixel_map(
+        event->getMemoryResource());
     for(const auto& propagated_charge : propagated_message->getData()) {
 
         // Make sure we're not double-counting by adding induced current information to an existing pulse:
@@ -109,9 +112,11 @@ void InducedTransferModule::run(Event* event) {
     // Create pixel charges
     LOG(TRACE) << "Combining charges at same pixel";
     std::vector<PixelCharge> pixel_charges;
+    pixel_charges.reserve(pixel_map.size());
     for(auto& pixel_index_charge : pixel_map) {
         double charge = 0;
         std::vector<const PropagatedCharge*> prop_charges;
+        prop_charges.reserve(pixel_index_charge.second.size());
         for(auto& prop_pair : pixel_index_charge.second) {
             charge += prop_pair.first;
             prop_charges.push_back(prop_pair.second);
@@ -120,11 +125,11 @@ void InducedTransferModule::run(Event* event) {
         // Get pixel object from detector
         auto pixel = detector_->getPixel(pixel_index_charge.first.x(), pixel_index_charge.first.y());
 
-        pixel_charges.emplace_back(pixel, std::round(charge), prop_charges);
+        pixel_charges.emplace_back(pixel, std::round(charge), std::move(prop_charges));
         LOG(DEBUG) << "Set of " << charge << " charges combined at " << pixel.getIndex();
     }
 
     // Dispatch message of pixel charges
-    auto pixel_message = std::make_shared<PixelChargeMessage>(pixel_charges, detector_);
+    auto pixel_message = std::make_shared<PixelChargeMessage>(std::move(pixel_charges), detector_);
     messenger_->dispatchMessage(this, pixel_message, event);
 }
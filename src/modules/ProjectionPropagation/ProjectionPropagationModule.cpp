@@ -43,6 +43,9 @@ ProjectionPropagationModule::ProjectionPropagationModule(Configuration& config,
     config_.setDefault<double>("integration_time", Units::get(25, "ns"));
     config_.setDefault<bool>("diffuse_deposit", false);
     config_.setDefault<std::string>("recombination_model", "none");
+    config_.setDefault<bool>("use_lookup_table", false);
+    config_.setDefault<unsigned int>("lookup_table_bins", 1000);
+    config_.setDefault<bool>("use_random_pool", false);
 
     config_.setDefault<bool>("output_linegraphs", false);
     config_.setDefault<bool>("output_animations", false);
@@ -58,6 +61,8 @@ ProjectionPropagationModule::ProjectionPropagationModule(Configuration& config,
     diffuse_deposit_ = config_.get<bool>("diffuse_deposit");
     charge_per_step_ = config_.get<unsigned int>("charge_per_step");
     max_charge_groups_ = config_.get<unsigned int>("max_charge_groups");
+    use_lookup_table_ = config_.get<bool>("use_lookup_table");
+    use_random_pool_ = config_.get<bool>("use_random_pool");
 
     output_plots_ = config_.get<bool>("output_plots");
     output_linegraphs_ = config_.get<bool>("output_linegraphs");
@@ -126,6 +131,34 @@ void ProjectionPropagationModule::initialize() {
                "field is wrong!";
     }
 
+    // The field at the implant side is the same for all charge carriers
+    efield_mag_top_ = std::sqrt(detector_->getElectricField(ROOT::Math::XYZPoint(0., 0., top_z_)).Mag2());
+
+    // Tabulate drift time and diffusion width as a function of the depth, possible because field and doping only depend on z
+    if(use_lookup_table_) {
+        auto bins = config_.get<unsigned int>("lookup_table_bins");
+        if(bins < 2) {
+            throw InvalidValueError(config_, "lookup_table_bins", "at least two bins are required for the lookup table");
+        }
+
+        auto thickness = model_->getSensorSize().z();
+        auto center = model_->getSensorCenter();
+        lookup_table_bin_width_ = thickness / (bins - 1);
+        lookup_table_.reserve(bins);
+        for(unsigned int i = 0; i < bins; i++) {
+            auto position = ROOT::Math::XYZPoint(center.x(), center.y(), -thickness / 2 + i * lookup_table_bin_width_);
+            auto efield_mag = std::sqrt(detector_->getElectricField(position).Mag2());
+            if(efield_mag < std::numeric_limits<double>::epsilon()) {
+                // Mark undepleted regions, lookups touching these bins fall back to the analytic calculation
+                lookup_table_.push_back({-1., 0.});
+                continue;
+            }
+            lookup_table_.push_back(calculate_drift(position, efield_mag, detector_->getDopingConcentration(position)));
+        }
+        LOG(DEBUG) << "Tabulated drift time and diffusion width (" << propagate_type_ << ") in " << bins
+                   << " bins of " << Units::display(lookup_table_bin_width_, {"nm", "um"});
+    }
+
     if(output_plots_) {
         // Initialize output plots
         propagation_time_histo_ =
@@ -170,6 +203,52 @@ void ProjectionPropagationModule::initialize() {
     }
 }
 
+ProjectionPropagationModule::DriftParameters
+ProjectionPropagationModule::calculate_drift(const ROOT::Math::XYZPoint& position, double efield_mag, double doping) const {
+    auto type = propagate_type_;
+    auto slope_efield = (efield_mag_top_ - efield_mag) / (std::abs(top_z_ - position.z()));
+
+    // Calculate the drift time
+    auto calc_drift_time = [&]() {
+        if(position.z() == top_z_) {
+            return 0.;
+        }
+
+        double Ec = (type == CarrierType::ELECTRON ? electron_Ec_ : hole_Ec_);
+
+        return ((log(efield_mag_top_) - log(efield_mag)) / slope_efield + std::abs(top_z_ - position.z()) / Ec) /
+               (*mobility_)(type, 0, doping);
+    };
+
+    // Assume linear electric field over the depleted part of the sensor
+    double diffusion_constant =
+        boltzmann_kT_ * ((*mobility_)(type, efield_mag, doping) + (*mobility_)(type, efield_mag_top_, doping)) / 2.;
+
+    double drift_time = calc_drift_time();
+    return {drift_time, std::sqrt(2. * diffusion_constant * drift_time)};
+}
+
+ProjectionPropagationModule::DriftParameters
+ProjectionPropagationModule::lookup_drift(const ROOT::Math::XYZPoint& position, double efield_mag, double doping) {
+    auto offset = (position.z() + model_->getSensorSize().z() / 2) / lookup_table_bin_width_;
+    auto bin = static_cast<long>(std::floor(offset));
+
+    // Fall back to the analytic calculation outside the table and at the border of the depleted region
+    if(bin < 0 || static_cast<size_t>(bin + 1) >= lookup_table_.size() || lookup_table_[bin].drift_time < 0 ||
+       lookup_table_[bin + 1].drift_time < 0) {
+        analytic_fallbacks_++;
+        return calculate_drift(position, efield_mag, doping);
+    }
+    table_lookups_++;
+
+    // Linear interpolation between neighboring bins
+    auto fraction = offset - static_cast<double>(bin);
+    const auto& low = lookup_table_[bin];
+    const auto& high = lookup_table_[bin + 1];
+    return {low.drift_time + fraction * (high.drift_time - low.drift_time),
+            low.diffusion_std_dev + fraction * (high.diffusion_std_dev - low.diffusion_std_dev)};
+}
+
 void ProjectionPropagationModule::run(Event* event) {
     auto deposits_message = messenger_->fetchMessage<DepositedChargeMessage>(this, event);
 
@@ -184,6 +263,15 @@ void ProjectionPropagationModule::run(Event* event) {
     // List of points to plot to plot for output plots
     LineGraph::OutputPlotPoints output_plot_points;
 
+    // Distributions used for all charge groups, the diffusion is scaled by the respective width
+    allpix::normal_distribution<double> unit_gauss(0, 1);
+    allpix::uniform_real_distribution<double> survival(0, 1);
+
+    // Draw from the random number pool of the event if requested, or from its random engine otherwise
+    auto* random_pool = (use_random_pool_ ? &event->getRandomPool() : nullptr);
+    auto gauss = [&]() { return (random_pool != nullptr ? random_pool->normal() : unit_gauss(event->getRandomEngine())); };
+    auto uniform = [&]() { return (random_pool != nullptr ? random_pool->uniform() : survival(event->getRandomEngine())); };
+
     // Loop over all deposits for propagation
     for(const auto& deposit : deposits_message->getData()) {
 
@@ -213,6 +301,11 @@ void ProjectionPropagationModule::run(Event* event) {
                       << ", which exceeds the maximum number of charge groups allowed. Increasing charge_per_step to "
                       << charge_per_step << " for this deposit.";
         }
+
+        // Field and doping at the deposit position are identical for all charge groups of this deposit
+        auto efield_mag_deposit = std::sqrt(detector_->getElectricField(initial_position).Mag2());
+        auto doping_deposit = detector_->getDopingConcentration(initial_position);
+
         while(charges_remaining > 0) {
             if(charge_per_step > charges_remaining) {
                 charge_per_step = charges_remaining;
@@ -230,12 +323,11 @@ void ProjectionPropagationModule::run(Event* event) {
                 output_plot_points.back().second.push_back(initial_position);
             }
 
-            // Get the electric field at the position of the deposited charge and the top of the sensor:
-            auto efield = detector_->getElectricField(position);
-            double efield_mag = std::sqrt(efield.Mag2());
-            auto efield_top = detector_->getElectricField(ROOT::Math::XYZPoint(0., 0., top_z_));
-            double efield_mag_top = std::sqrt(efield_top.Mag2());
-            double doping = detector_->getDopingConcentration(position);
+            // Get the electric field at the position of the deposited charge:
+            double efield_mag = efield_mag_deposit;
+            double doping = doping_deposit;
+            // Doping at the current position, only differs from the deposit after diffusion into the depleted region
+            double doping_position = doping_deposit;
             double diffusion_time = 0;
 
             // Only project if within the depleted region (i.e. efield not zero)
@@ -248,10 +340,9 @@ void ProjectionPropagationModule::run(Event* event) {
                 double diffusion_std_dev = std::sqrt(2. * diffusion_constant * integration_time_);
                 LOG(TRACE) << "Diffusion width of this charge carrier is " << Units::display(diffusion_std_dev, "um");
 
-                allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
-                double diffusion_x = gauss_distribution(event->getRandomEngine());
-                double diffusion_y = gauss_distribution(event->getRandomEngine());
-                double diffusion_z = gauss_distribution(event->getRandomEngine());
+                double diffusion_x = diffusion_std_dev * gauss();
+                double diffusion_y = diffusion_std_dev * gauss();
+                double diffusion_z = diffusion_std_dev * gauss();
                 auto diffusion_vec = ROOT::Math::XYZVector(diffusion_x, diffusion_y, diffusion_z);
 
                 auto local_position_diffusion = position + diffusion_vec;
@@ -288,8 +379,8 @@ void ProjectionPropagationModule::run(Event* event) {
                 };
 
                 position = interval(position, local_position_diffusion);
-                efield = detector_->getElectricField(position);
-                efield_mag = std::sqrt(efield.Mag2());
+                efield_mag = std::sqrt(detector_->getElectricField(position).Mag2());
+                doping_position = detector_->getDopingConcentration(position);
                 diffusion_time = integration_time_ * std::sqrt((position - initial_position).Mag2() /
                                                                (local_position_diffusion - initial_position).Mag2());
 
@@ -316,28 +407,11 @@ void ProjectionPropagationModule::run(Event* event) {
             }
 
             LOG(TRACE) << "Electric field at carrier position / top of the sensor: "
-                       << Units::display(efield_mag_top, "V/cm") << " , " << Units::display(efield_mag, "V/cm");
-
-            auto slope_efield = (efield_mag_top - efield_mag) / (std::abs(top_z_ - position.z()));
-
-            // Calculate the drift time
-            auto calc_drift_time = [&]() {
-                if(position.z() == top_z_) {
-                    return 0.;
-                }
+                       << Units::display(efield_mag_top_, "V/cm") << " , " << Units::display(efield_mag, "V/cm");
 
-                double Ec = (type == CarrierType::ELECTRON ? electron_Ec_ : hole_Ec_);
-
-                return ((log(efield_mag_top) - log(efield_mag)) / slope_efield + std::abs(top_z_ - position.z()) / Ec) /
-                       (*mobility_)(type, 0, doping);
-            };
-            LOG(TRACE) << "Electric field is " << Units::display(efield_mag, "V/cm");
-
-            // Assume linear electric field over the depleted part of the sensor
-            double diffusion_constant =
-                boltzmann_kT_ * ((*mobility_)(type, efield_mag, doping) + (*mobility_)(type, efield_mag_top, doping)) / 2.;
-
-            double drift_time = calc_drift_time();
+            // Obtain drift time and diffusion width, either from the lookup table or calculated analytically
+            auto [drift_time, diffusion_std_dev] = (use_lookup_table_ ? lookup_drift(position, efield_mag, doping)
+                                                                      : calculate_drift(position, efield_mag, doping));
             double propagation_time = drift_time + diffusion_time;
             LOG(TRACE) << "Drift time is " << Units::display(drift_time, "ns");
 
@@ -349,22 +423,18 @@ void ProjectionPropagationModule::run(Event* event) {
                 }
             }
 
-            double diffusion_std_dev = std::sqrt(2. * diffusion_constant * drift_time);
             LOG(TRACE) << "Diffusion width is " << Units::display(diffusion_std_dev, "um");
 
             // Check if charge carrier is still alive via its survival probability, evaluated once
-            allpix::uniform_real_distribution<double> survival(0, 1);
-            if(recombination_(
-                   type, detector_->getDopingConcentration(position), survival(event->getRandomEngine()), drift_time)) {
+            if(recombination_(type, doping_position, uniform(), drift_time)) {
                 LOG(DEBUG) << "Recombined " << charge_per_step << " charge carriers (" << type << ") at "
                            << Units::display(position, {"mm", "um"});
                 recombined_charges_count += charge_per_step;
                 continue;
             }
 
-            allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
-            double diffusion_x = gauss_distribution(event->getRandomEngine());
-            double diffusion_y = gauss_distribution(event->getRandomEngine());
+            double diffusion_x = diffusion_std_dev * gauss();
+            double diffusion_y = diffusion_std_dev * gauss();
 
             // Find projected position
             auto local_position = ROOT::Math::XYZPoint(position.x() + diffusion_x, position.y() + diffusion_y, top_z_);
@@ -455,6 +525,10 @@ void ProjectionPropagationModule::finalize() {
             diffusion_time_histo_->Write();
         }
     }
+    if(use_lookup_table_) {
+        LOG(INFO) << "Obtained drift time and diffusion width from the lookup table for " << table_lookups_ << " of "
+                  << (table_lookups_ + analytic_fallbacks_) << " charge groups";
+    }
     LOG(INFO) << deposits_exceeding_max_groups_ * 100.0 / total_deposits_ << "% of deposits have charge exceeding the "
               << max_charge_groups_ << " charge groups allowed, with a charge_per_step value of " << charge_per_step_ << ".";
 }
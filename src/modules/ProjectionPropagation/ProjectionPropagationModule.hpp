@@ -14,6 +14,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include <TH1D.h>
 
@@ -67,6 +68,32 @@ namespace allpix {
         void finalize() override;
 
     private:
+        /**
+         * @brief Drift time and lateral diffusion width of a charge carrier group projected to the implant side
+         */
+        struct DriftParameters {
+            double drift_time;
+            double diffusion_std_dev;
+        };
+
+        /**
+         * @brief Analytically calculate drift time and diffusion width for a carrier starting at the given position
+         * @param position Start position of the drift
+         * @param efield_mag Magnitude of the electric field at the start position
+         * @param doping Doping concentration at the start position
+         * @return Drift time and diffusion width
+         */
+        DriftParameters calculate_drift(const ROOT::Math::XYZPoint& position, double efield_mag, double doping) const;
+
+        /**
+         * @brief Obtain drift time and diffusion width from the lookup table by interpolating in depth
+         * @param position Start position of the drift
+         * @param efield_mag Magnitude of the electric field at the start position, used for the analytic fallback
+         * @param doping Doping concentration at the start position, used for the analytic fallback
+         * @return Drift time and diffusion width
+         */
+        DriftParameters lookup_drift(const ROOT::Math::XYZPoint& position, double efield_mag, double doping);
+
         Messenger* messenger_;
         std::shared_ptr<const Detector> detector_;
         std::shared_ptr<DetectorModel> model_;
@@ -77,11 +104,19 @@ namespace allpix {
         bool diffuse_deposit_;
         unsigned int charge_per_step_{};
         unsigned int max_charge_groups_{};
+        bool use_lookup_table_{};
+        bool use_random_pool_{};
 
         // Carrier type to be propagated
         CarrierType propagate_type_;
         // Side to propagate too
         double top_z_;
+        // Magnitude of the electric field at the implant side
+        double efield_mag_top_{};
+
+        // Drift time and diffusion width tabulated in depth, negative drift time marks undepleted bins
+        std::vector<DriftParameters> lookup_table_;
+        double lookup_table_bin_width_{};
 
         // Precalculated values for electron and hole critical fields
         double hole_Ec_;
@@ -96,6 +131,7 @@ namespace allpix {
 
         // Statistical information
         std::atomic<unsigned int> total_deposits_{}, deposits_exceeding_max_groups_{};
+        std::atomic<unsigned long> table_lookups_{}, analytic_fallbacks_{};
         Histogram<TH1D> drift_time_histo_;
         Histogram<TH1D> diffusion_time_histo_;
         Histogram<TH1D> propagation_time_histo_;
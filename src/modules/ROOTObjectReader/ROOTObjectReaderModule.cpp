@@ -22,6 +22,7 @@
 #include <TTree.h>
 
 #include "core/messenger/Messenger.hpp"
+#include "core/module/ThreadPool.hpp"
 #include "core/utils/log.h"
 #include "core/utils/text.h"
 #include "core/utils/type.h"
@@ -106,6 +107,102 @@ template <typename T> static ROOTObjectReaderModule::MessageCreatorMap gen_creat
     return ret_map;
 }
 
+#ifdef ALLPIX_RNTUPLE
+namespace {
+    // Detector and message name of every branch
+    using Branches = std::vector<std::pair<std::shared_ptr<Detector>, std::string>>;
+
+    /**
+     * @brief Reader for the RNTuple of objects of a specific type
+     */
+    template <typename T> class NTupleReader : public BaseNTupleReader {
+    public:
+        NTupleReader(const std::string& ntuple_name, const std::string& file_name, Branches branches)
+            : branches_(std::move(branches)) {
+            auto model = ROOT::RNTupleModel::Create();
+            columns_ = std::make_unique<ObjectColumns<T>>(*model);
+            reader_ = ROOT::RNTupleReader::Open(std::move(model), ntuple_name, file_name);
+        }
+
+        uint64_t getEntries() const override { return reader_->GetNEntries(); }
+        size_t getBranchCount() const override { return branches_.size(); }
+
+        size_t read(uint64_t entry, ObjectTable& table) override {
+            reader_->LoadEntry(entry);
+
+            // Reserve the storage of every branch, such that the objects are not relocated after registering them
+            std::vector<size_t> counts(branches_.size());
+            for(size_t i = 0; i < columns_->size(); ++i) {
+                if(columns_->branch(i) >= branches_.size()) {
+                    throw ModuleError("RNTuple of " + allpix::demangle(typeid(T).name()) +
+                                      " objects refers to unknown branch");
+                }
+                ++counts[columns_->branch(i)];
+            }
+            data_.clear();
+            data_.resize(branches_.size());
+            for(size_t branch = 0; branch < branches_.size(); ++branch) {
+                data_[branch].reserve(counts[branch]);
+            }
+
+            // Construct the objects in the order of their index
+            auto& objects = table[typeid(T)];
+            objects.clear();
+            for(size_t i = 0; i < columns_->size(); ++i) {
+                objects.push_back(&data_[columns_->branch(i)].emplace_back(columns_->get(i)));
+            }
+            return columns_->size();
+        }
+
+        std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> link(const ObjectTable& table) override {
+            std::vector<size_t> next(branches_.size());
+            for(size_t i = 0; i < columns_->size(); ++i) {
+                auto branch = columns_->branch(i);
+                columns_->link(data_[branch][next[branch]++], i, table);
+            }
+
+            // The objects are moved into the messages without relocating them
+            std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> messages;
+            for(size_t branch = 0; branch < branches_.size(); ++branch) {
+                if(data_[branch].empty()) {
+                    continue;
+                }
+                const auto& [detector, name] = branches_[branch];
+                if(detector == nullptr) {
+                    messages.emplace_back(std::make_shared<Message<T>>(std::move(data_[branch])), name);
+                } else {
+                    messages.emplace_back(std::make_shared<Message<T>>(std::move(data_[branch]), detector), name);
+                }
+            }
+            return messages;
+        }
+
+    private:
+        Branches branches_;
+        std::unique_ptr<ObjectColumns<T>> columns_;
+        std::unique_ptr<ROOT::RNTupleReader> reader_;
+        std::vector<std::vector<T>> data_;
+    };
+
+    using NTupleReaderCreatorMap =
+        std::map<std::string,
+                 std::function<std::unique_ptr<BaseNTupleReader>(const std::string&, const std::string&, Branches)>>;
+
+    /**
+     * @brief Generate the functions to create a reader for every object type from the name of the type
+     */
+    template <typename... Ts> NTupleReaderCreatorMap gen_ntuple_reader_map(std::tuple<Ts...>*) {
+        NTupleReaderCreatorMap map;
+        ((map[allpix::demangle(typeid(Ts).name())] =
+              [](const std::string& ntuple_name, const std::string& file_name, Branches branches) {
+                  return std::make_unique<NTupleReader<Ts>>(ntuple_name, file_name, std::move(branches));
+              }),
+         ...);
+        return map;
+    }
+} // namespace
+#endif
+
 void ROOTObjectReaderModule::initialize() {
     // Read include and exclude list
     if(config_.has("include") && config_.has("exclude")) {
@@ -129,6 +226,7 @@ void ROOTObjectReaderModule::initialize() {
     // Read all the trees in the file
     TList* keys = input_file_->GetListOfKeys();
     std::set<std::string> tree_names;
+    std::vector<std::string> ntuple_names;
 
     for(auto&& object : *keys) {
         auto& key = dynamic_cast<TKey&>(*object);
@@ -159,10 +257,27 @@ void ROOTObjectReaderModule::initialize() {
             }
 
             trees_.push_back(tree);
+        } else if(std::string(key.GetClassName()).find("RNTuple") != std::string::npos) {
+            std::string ntuple_name = key.GetName();
+
+            // Exclude the Event RNTuple and skip copies of already processed RNTuples
+            if(ntuple_name == "Event" || !tree_names.insert(ntuple_name).second) {
+                continue;
+            }
+
+            // Check if this RNTuple should be used
+            if((!include_.empty() && include_.find(ntuple_name) == include_.end()) ||
+               (!exclude_.empty() && exclude_.find(ntuple_name) != exclude_.end())) {
+                LOG(TRACE) << "Ignoring RNTuple with " << ntuple_name
+                           << " objects because it has been excluded or not explicitly included";
+                continue;
+            }
+
+            ntuple_names.push_back(ntuple_name);
         }
     }
 
-    if(trees_.empty()) {
+    if(trees_.empty() && ntuple_names.empty()) {
         LOG(ERROR) << "Provided ROOT file does not contain any trees, module will not read any data";
     }
 
@@ -206,6 +321,43 @@ void ROOTObjectReaderModule::initialize() {
                      << " - this might lead to unexpected behavior.";
     }
 
+    if(!ntuple_names.empty()) {
+#ifdef ALLPIX_RNTUPLE
+        auto creator_map = gen_ntuple_reader_map(static_cast<OBJECTS*>(nullptr));
+        ntuple_readers_.resize(ThreadPool::threadCount());
+        for(auto& ntuple_name : ntuple_names) {
+            auto creator = creator_map.find(ntuple_name);
+            if(creator == creator_map.end()) {
+                LOG(WARNING) << "Cannot read RNTuple " << ntuple_name << " because the object type is not known";
+                continue;
+            }
+
+            // Fetch the detector and message name of every branch the objects have been dispatched with
+            std::vector<std::string>* stored_branches = nullptr;
+            input_file_->GetObject(("branches/" + ntuple_name).c_str(), stored_branches);
+            std::unique_ptr<std::vector<std::string>> branch_names(stored_branches);
+            if(branch_names == nullptr) {
+                throw ModuleError("Branch names of RNTuple " + ntuple_name + " are missing in the input file");
+            }
+            Branches branches;
+            for(const auto& branch_name : *branch_names) {
+                auto separator = branch_name.find('_');
+                auto detector_name = branch_name.substr(0, separator);
+                branches.emplace_back(detector_name == "global" ? nullptr : geo_mgr_->getDetector(detector_name),
+                                      separator == std::string::npos ? "" : branch_name.substr(separator + 1));
+            }
+
+            // Every thread reads the events it processes with a separate reader
+            for(auto& readers : ntuple_readers_) {
+                readers.push_back(creator->second(ntuple_name, input_file_name.string(), branches));
+            }
+        }
+#else
+        throw InvalidValueError(
+            config_, "file_name", "file contains RNTuples but Allpix Squared has been built without RNTuple support");
+#endif
+    }
+
     // Loop over all found trees
     for(auto& tree : trees_) {
         // Loop over the list of branches and create the set of receiver objects
@@ -266,6 +418,33 @@ void ROOTObjectReaderModule::initialize() {
 }
 
 void ROOTObjectReaderModule::run(Event* event) {
+#ifdef ALLPIX_RNTUPLE
+    if(!ntuple_readers_.empty()) {
+        auto& readers = ntuple_readers_.at(ThreadPool::threadNum());
+
+        // Construct all objects first, such that relations between objects of all types can be resolved
+        ObjectTable table;
+        for(auto& reader : readers) {
+            if(event->number > reader->getEntries()) {
+                throw EndOfRunException("Requesting end of run because RNTuple only contains data for " +
+                                        std::to_string(reader->getEntries()) + " events");
+            }
+            read_cnt_ += reader->read(event->number - 1, table);
+        }
+        LOG(TRACE) << "Building messages from stored objects";
+
+        std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> messages;
+        for(auto& reader : readers) {
+            auto reader_messages = reader->link(table);
+            messages.insert(messages.end(), reader_messages.begin(), reader_messages.end());
+        }
+        for(auto& [message, name] : messages) {
+            messenger_->dispatchMessage(this, message, event, name);
+        }
+        return;
+    }
+#endif
+
     auto root_lock = root_process_lock();
 
     // Beware: ROOT uses signed entry counters for its trees
@@ -329,6 +508,13 @@ void ROOTObjectReaderModule::finalize() {
     for(auto& tree : trees_) {
         branch_count += tree->GetListOfBranches()->GetEntries();
     }
+#ifdef ALLPIX_RNTUPLE
+    if(!ntuple_readers_.empty()) {
+        for(auto& reader : ntuple_readers_.front()) {
+            branch_count += static_cast<int>(reader->getBranchCount());
+        }
+    }
+#endif
 
     // Print statistics
     LOG(INFO) << "Read " << read_cnt_ << " objects from " << branch_count << " branches";
@@ -25,13 +25,51 @@
 // Contains tuple of all defined objects
 #include "objects/objects.h"
 
+#ifdef ALLPIX_RNTUPLE
+#include "tools/rntuple_objects.h"
+#endif
+
 namespace allpix {
+#ifdef ALLPIX_RNTUPLE
+    /**
+     * @brief Reader for the RNTuple of a single object type
+     */
+    class BaseNTupleReader {
+    public:
+        virtual ~BaseNTupleReader() = default;
+
+        /**
+         * @brief Get the number of events stored in the RNTuple
+         */
+        virtual uint64_t getEntries() const = 0;
+        /**
+         * @brief Get the number of branches the objects are stored for
+         */
+        virtual size_t getBranchCount() const = 0;
+
+        /**
+         * @brief Construct the objects stored for an event, without their relations
+         * @param entry Index of the event in the RNTuple
+         * @param table Table to register the constructed objects in
+         * @return Number of objects read
+         */
+        virtual size_t read(uint64_t entry, ObjectTable& table) = 0;
+        /**
+         * @brief Resolve the relations of the objects read and create one message per branch
+         * @param table Objects of all types read for the event
+         * @return List of messages with their message names
+         */
+        virtual std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> link(const ObjectTable& table) = 0;
+    };
+#endif
+
     /**
      * @ingroup Modules
      * @brief Module to read data stored in ROOT file back to allpix messages
      *
      * Reads the tree of objects in the data format of the \ref ROOTObjectWriterModule. Converts all the stored objects that
-     * are supported back to messages containing those objects and dispatches those messages.
+     * are supported back to messages containing those objects and dispatches those messages. Files written in the RNTuple
+     * format are read with an independent reader per thread, such that events can be read in parallel.
      */
     class ROOTObjectReaderModule : public Module {
     public:
@@ -98,5 +136,10 @@ namespace allpix {
 
         // Internal map to construct an object from it's type index
         MessageCreatorMap message_creator_map_;
+
+#ifdef ALLPIX_RNTUPLE
+        // Readers of the RNTuples in the file, one set per thread
+        std::vector<std::vector<std::unique_ptr<BaseNTupleReader>>> ntuple_readers_;
+#endif
     };
 } // namespace allpix
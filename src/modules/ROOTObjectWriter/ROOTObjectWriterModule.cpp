@@ -11,6 +11,7 @@
 
 #include "ROOTObjectWriterModule.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <utility>
@@ -54,10 +55,24 @@ void ROOTObjectWriterModule::initialize() {
     output_file_ = std::make_unique<TFile>(output_file_name_.c_str(), "RECREATE");
     output_file_->cd();
 
-    // Create tree to hold Event information
-    trees_.emplace("Event", std::make_unique<TTree>("Event", "Tree of event info"));
-    trees_["Event"]->Branch("ID", &current_event_);
-    trees_["Event"]->Branch("seed", &current_seed_);
+    // Select the output format
+    auto format = allpix::transform(config_.get<std::string>("format", "ttree"), ::tolower);
+    if(format == "rntuple") {
+#ifdef ALLPIX_RNTUPLE
+        rntuple_ = true;
+#else
+        throw InvalidValueError(config_, "format", "Allpix Squared has been built without RNTuple support");
+#endif
+    } else if(format != "ttree") {
+        throw InvalidValueError(config_, "format", "unknown output format, supported formats are 'ttree' and 'rntuple'");
+    }
+
+    if(!rntuple_) {
+        // Create tree to hold Event information
+        trees_.emplace("Event", std::make_unique<TTree>("Event", "Tree of event info"));
+        trees_["Event"]->Branch("ID", &current_event_);
+        trees_["Event"]->Branch("seed", &current_seed_);
+    }
 
     // Check if the given type of object is contained in the inclusion or exclusion filter rules:
     auto check_object_filter = [](const std::string& object, const std::set<std::string>& arr, bool inclusive) {
@@ -92,7 +107,42 @@ void ROOTObjectWriterModule::initialize() {
                      << std::endl
                      << "It is advised to use the include and exclude parameters to select object types specifically.";
     }
+
+#ifdef ALLPIX_RNTUPLE
+    if(rntuple_) {
+        // Create the RNTuples of all object types to be written, and of the event information
+        create_ntuples(static_cast<OBJECTS*>(nullptr));
+
+        auto model = ROOT::RNTupleModel::Create();
+        event_id_ = model->MakeField<uint64_t>("ID");
+        event_seed_ = model->MakeField<uint64_t>("seed");
+        ROOT::RNTupleWriteOptions options;
+        options.SetCompression(config_.get<int>("compression", 505));
+        event_writer_ = ROOT::RNTupleWriter::Append(std::move(model), "Event", *output_file_, options);
+    }
+#endif
+}
+
+#ifdef ALLPIX_RNTUPLE
+template <typename T> void ROOTObjectWriterModule::create_ntuple() {
+    auto class_name = allpix::demangle(typeid(T).name());
+    if((!include_.empty() && include_.find(class_name) == include_.cend()) ||
+       (!exclude_.empty() && exclude_.find(class_name) != exclude_.cend())) {
+        return;
+    }
+
+    // Compression settings can be chosen per object type, the same settings apply to all columns of the RNTuple
+    ROOT::RNTupleWriteOptions options;
+    options.SetCompression(config_.get<int>("compression_" + class_name, config_.get<int>("compression", 505)));
+
+    auto model = ROOT::RNTupleModel::Create();
+    auto& ntuple = ntuples_[typeid(T)];
+    ntuple.name = class_name;
+    ntuple.columns = std::make_unique<ObjectColumns<T>>(*model);
+    ntuple.writer = ROOT::RNTupleWriter::Append(std::move(model), class_name, *output_file_, options);
+    LOG(DEBUG) << "Created RNTuple " << class_name << " with compression setting " << options.GetCompression();
 }
+#endif
 
 bool ROOTObjectWriterModule::filter(const std::shared_ptr<BaseMessage>& message,
                                     const std::string& message_name) const { // NOLINT
@@ -132,6 +182,13 @@ bool ROOTObjectWriterModule::filter(const std::shared_ptr<BaseMessage>& message,
 void ROOTObjectWriterModule::run(Event* event) {
     auto root_lock = root_process_lock();
 
+#ifdef ALLPIX_RNTUPLE
+    if(rntuple_) {
+        write_ntuples(event);
+        return;
+    }
+#endif
+
     // Retrieve current object count:
     auto object_count = TProcessID::GetObjectCount();
 
@@ -242,6 +299,67 @@ void ROOTObjectWriterModule::run(Event* event) {
     TProcessID::SetObjectCount(object_count);
 }
 
+#ifdef ALLPIX_RNTUPLE
+void ROOTObjectWriterModule::write_ntuples(Event* event) {
+    // Fetch filtered messages
+    auto messages = messenger_->fetchFilteredMessages(this, event);
+
+    // Assign every object its index within the entry of its type, in the order the objects are filled
+    ObjectIndices indices;
+    std::map<std::type_index, int32_t> counts;
+    std::map<std::type_index, std::vector<std::pair<std::shared_ptr<BaseMessage>, uint32_t>>> type_messages;
+    for(auto& [message, message_name] : messages) {
+        auto object_array = message->getObjectArray();
+        // object_array emptiness is checked in the filter
+        const Object& first_object = object_array[0];
+        std::type_index type_idx = typeid(first_object);
+
+        auto ntuple_it = ntuples_.find(type_idx);
+        if(ntuple_it == ntuples_.end()) {
+            LOG_ONCE(WARNING) << "Cannot write objects of type " << allpix::demangle(typeid(first_object).name())
+                              << " to RNTuple, ignoring";
+            continue;
+        }
+
+        // Look up the branch index of this combination of detector and message name
+        auto branch_name = (message->getDetector() != nullptr ? message->getDetector()->getName() : "global");
+        if(!message_name.empty()) {
+            branch_name += "_";
+            branch_name += message_name;
+        }
+        auto& branches = ntuple_it->second.branches;
+        auto branch = static_cast<uint32_t>(
+            std::distance(branches.begin(), std::find(branches.begin(), branches.end(), branch_name)));
+        if(branch == branches.size()) {
+            LOG(DEBUG) << "Adding branch " << branch_name << " to RNTuple " << ntuple_it->second.name;
+            branches.push_back(branch_name);
+        }
+
+        for(Object& object : object_array) {
+            indices[&object] = counts[type_idx]++;
+        }
+        type_messages[type_idx].emplace_back(message, branch);
+    }
+
+    // Fill one entry per event in every RNTuple, also if no objects of that type have been received
+    LOG(TRACE) << "Writing new objects to RNTuples";
+    for(auto& [type_idx, ntuple] : ntuples_) {
+        ntuple.columns->clear();
+        for(auto& [message, branch] : type_messages[type_idx]) {
+            for(Object& object : message->getObjectArray()) {
+                ntuple.columns->fill(object, branch, indices);
+                ++write_cnt_;
+            }
+        }
+        ntuple.writer->Fill();
+    }
+
+    *event_id_ = event->number;
+    *event_seed_ = event->getSeed();
+    event_writer_->Fill();
+}
+#endif
+
 void ROOTObjectWriterModule::finalize() {
     LOG(TRACE) << "Writing objects to file";
     output_file_->cd();
@@ -252,6 +370,20 @@ void ROOTObjectWriterModule::finalize() {
         branch_count += tree.second->GetListOfBranches()->GetEntries();
     }
 
+#ifdef ALLPIX_RNTUPLE
+    if(rntuple_) {
+        // Store the branch names referenced by the objects and commit the RNTuples to the file
+        auto* branches_dir = output_file_->mkdir("branches");
+        for(auto& [type_idx, ntuple] : ntuples_) {
+            branch_count += static_cast<int>(ntuple.branches.size());
+            branches_dir->WriteObject(&ntuple.branches, ntuple.name.c_str());
+            ntuple.writer.reset();
+        }
+        event_writer_.reset();
+        output_file_->cd();
+    }
+#endif
+
     // Create main config directory
     TDirectory* config_dir = output_file_->mkdir("config");
     config_dir->cd();
@@ -22,6 +22,10 @@
 #include "core/module/Event.hpp"
 #include "core/module/Module.hpp"
 
+#ifdef ALLPIX_RNTUPLE
+#include "tools/rntuple_objects.h"
+#endif
+
 namespace allpix {
     /**
      * @ingroup Modules
@@ -30,6 +34,10 @@ namespace allpix {
      * Listens to all objects dispatched in the framework. Creates a tree as soon as a new type of object is encountered and
      * saves the data in those objects to tree for every event. The tree name is the class name of the object. A separate
      * branch is created for every combination of detector name and message name that outputs this object.
+     *
+     * Alternatively, the objects can be written to RNTuples with one entry per event for every object type. Relations
+     * between objects are then stored as indices of the related objects within the same event instead of persistent
+     * references.
      */
     class ROOTObjectWriterModule : public SequentialModule {
     public:
@@ -80,6 +88,9 @@ namespace allpix {
         std::unique_ptr<TFile> output_file_;
         std::string output_file_name_{};
 
+        // Format of the stored objects
+        bool rntuple_{false};
+
         // Current event
         uint64_t current_event_{0};
 
@@ -94,5 +105,33 @@ namespace allpix {
 
         // Statistical information about number of objects
         std::atomic<unsigned long> write_cnt_{};
+
+#ifdef ALLPIX_RNTUPLE
+        /**
+         * @brief Create the RNTuple of an object type if it passes the include and exclude filters
+         */
+        template <typename T> void create_ntuple();
+        template <typename... Ts> void create_ntuples(std::tuple<Ts...>*) { (create_ntuple<Ts>(), ...); }
+
+        /**
+         * @brief Write the objects of an event to the RNTuples
+         * @param event Event to write
+         */
+        void write_ntuples(Event* event);
+
+        // Columns, writer and list of branch names of the RNTuple of a single object type
+        struct NTuple {
+            std::string name;
+            std::unique_ptr<BaseObjectColumns> columns;
+            std::unique_ptr<ROOT::RNTupleWriter> writer;
+            std::vector<std::string> branches;
+        };
+        std::map<std::type_index, NTuple> ntuples_;
+
+        // Event information
+        std::unique_ptr<ROOT::RNTupleWriter> event_writer_;
+        std::shared_ptr<uint64_t> event_id_;
+        std::shared_ptr<uint64_t> event_seed_;
+#endif
     };
 } // namespace allpix
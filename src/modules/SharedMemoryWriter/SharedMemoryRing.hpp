@@ -0,0 +1,567 @@
+/**
+ * @file
+ * @brief Binary layout, producer and consumer of the shared memory ring buffer for pixel hits
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ *
+ * This header does not depend on the framework and can be included by external consumers of the ring buffer.
+ */
+
+#ifndef ALLPIX_SHARED_MEMORY_RING_H
+#define ALLPIX_SHARED_MEMORY_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace allpix::shm {
+    /// Magic string at the start of the segment, changes with every incompatible change of the layout
+    constexpr char ring_magic[8] = {'A', 'P', 'S', 'H', 'M', 'R', '0', '1'};
+    /// Maximum number of consumers attached at the same time
+    constexpr uint32_t max_consumers = 16;
+    /// Length of the detector name field, including the terminating null character
+    constexpr size_t detector_name_length = 56;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory ring requires lock-free 64 bit atomics");
+
+    /**
+     * @brief Policy of the producer if the ring buffer is full
+     */
+    enum class FullPolicy : uint32_t {
+        BLOCK = 0, ///< Wait until all consumers have released enough space
+        DROP = 1,  ///< Drop the event
+    };
+
+    /**
+     * @brief State of a consumer slot
+     */
+    enum class SlotState : uint32_t {
+        FREE = 0,     ///< Slot can be claimed by a new consumer
+        CLAIMING = 1, ///< Slot is being claimed and not yet considered by the producer
+        ACTIVE = 2,   ///< Consumer is attached, the producer does not overwrite data it has not released
+    };
+
+    /**
+     * @brief Position of a single consumer in the ring buffer
+     */
+    struct alignas(64) ConsumerSlot {
+        std::atomic<uint32_t> state;
+        std::atomic<uint64_t> read_position;
+    };
+
+    /**
+     * @brief Header at the start of the shared memory segment
+     *
+     * The header is followed by the data area. Positions are given as total number of bytes written since the creation of
+     * the ring buffer, the offset in the data area is the position modulo the capacity.
+     */
+    struct alignas(64) RingHeader {
+        char magic[8];
+        uint32_t header_size;
+        uint32_t policy;
+        uint64_t capacity;
+
+        alignas(64) std::atomic<uint64_t> write_position;
+        std::atomic<uint64_t> published_events;
+        std::atomic<uint64_t> dropped_events;
+        std::atomic<uint32_t> closed;
+
+        ConsumerSlot consumers[max_consumers];
+    };
+
+    /**
+     * @brief Type of the records in the data area
+     */
+    enum class RecordType : uint32_t {
+        PADDING = 0, ///< Unused space until the end of the data area
+        EVENT = 1,   ///< Event record
+    };
+
+    /**
+     * @brief Header of every record, the size includes the header and is a multiple of eight bytes
+     */
+    struct RecordHeader {
+        uint32_t size;
+        uint32_t type;
+    };
+
+    /**
+     * @brief Start of an event record, followed by the blocks of all detectors
+     */
+    struct EventRecord {
+        uint64_t event;
+        uint64_t seed;
+        uint32_t detectors;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief Start of the block of a detector, followed by the hits, the particles and the links of the hits to particles
+     *
+     * The links are padded to a multiple of eight bytes.
+     */
+    struct DetectorRecord {
+        char name[detector_name_length];
+        uint32_t hits;
+        uint32_t particles;
+        uint32_t links;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief Pixel hit, the links of the hit are the entries [first_link, first_link + links) of the detector
+     */
+    struct HitRecord {
+        int32_t x;
+        int32_t y;
+        double signal;
+        double local_time;
+        double global_time;
+        uint32_t first_link;
+        uint32_t links;
+    };
+
+    /**
+     * @brief Monte Carlo particle which created at least one pixel hit of the detector, in local coordinates
+     */
+    struct ParticleRecord {
+        int32_t particle_id;
+        uint32_t reserved;
+        double local_start_point[3];
+        double local_end_point[3];
+        double local_time;
+        double global_time;
+    };
+
+    static_assert(sizeof(RecordHeader) == 8 && sizeof(EventRecord) == 24 && sizeof(DetectorRecord) == 72 &&
+                      sizeof(HitRecord) == 40 && sizeof(ParticleRecord) == 72,
+                  "unexpected layout of shared memory records");
+
+    /**
+     * @brief Round a size up to a multiple of eight bytes
+     */
+    constexpr size_t align8(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+    /**
+     * @brief Size of the mapped segment, shared by producer and consumers
+     */
+    inline size_t segment_size(uint64_t capacity) { return sizeof(RingHeader) + capacity; }
+
+    /**
+     * @brief Producer writing records to the ring buffer
+     *
+     * Only a single producer may write to a ring buffer. The segment is created, or reinitialized if it already exists, on
+     * construction.
+     */
+    class RingProducer {
+    public:
+        /**
+         * @brief Create the shared memory segment
+         * @param name Name of the segment, as passed to shm_open
+         * @param capacity Minimum size of the data area in bytes, rounded up to the next power of two
+         * @param policy Policy if the buffer is full
+         * @param timeout Time after which consumers blocking the producer are detached, only used for the block policy
+         */
+        RingProducer(std::string name, uint64_t capacity, FullPolicy policy, std::chrono::nanoseconds timeout)
+            : name_(std::move(name)), policy_(policy), timeout_(timeout) {
+            capacity_ = 64;
+            while(capacity_ < capacity) {
+                capacity_ <<= 1;
+            }
+
+            // Only the owner may attach, the permissions of an existing segment are not changed by shm_open
+            auto fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0600);
+            if(fd < 0) {
+                throw std::runtime_error("could not create shared memory segment " + name_);
+            }
+            auto size = segment_size(capacity_);
+            if(ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                close(fd);
+                throw std::runtime_error("could not resize shared memory segment " + name_);
+            }
+            memory_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if(memory_ == MAP_FAILED) { // NOLINT
+                throw std::runtime_error("could not map shared memory segment " + name_);
+            }
+
+            // Initialize the header, the magic string is written last such that consumers only attach to a valid layout
+            std::memset(memory_, 0, sizeof(RingHeader));
+            header_ = new(memory_) RingHeader();
+            header_->header_size = sizeof(RingHeader);
+            header_->policy = static_cast<uint32_t>(policy_);
+            header_->capacity = capacity_;
+            data_ = static_cast<char*>(memory_) + sizeof(RingHeader);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(header_->magic, ring_magic, sizeof(ring_magic));
+        }
+
+        /**
+         * @brief Mark the ring buffer as closed and unmap the segment
+         */
+        ~RingProducer() {
+            header_->closed.store(1, std::memory_order_release);
+            munmap(memory_, segment_size(capacity_));
+        }
+
+        /// @{
+        /**
+         * @brief Disable copying and moving of the producer
+         */
+        RingProducer(const RingProducer&) = delete;
+        RingProducer& operator=(const RingProducer&) = delete;
+        RingProducer(RingProducer&&) = delete;
+        RingProducer& operator=(RingProducer&&) = delete;
+        /// @}
+
+        /**
+         * @brief Remove the name of the segment, attached consumers keep their mapping
+         */
+        void unlink() const { shm_unlink(name_.c_str()); }
+
+        /**
+         * @brief Write a record to the ring buffer
+         * @param payload Content of the record
+         * @param size Size of the content in bytes
+         * @return Number of consumers detached because they blocked the producer, or -1 if the record has been dropped
+         */
+        int publish(const void* payload, size_t size) {
+            auto record_size = align8(sizeof(RecordHeader) + size);
+            auto write = header_->write_position.load(std::memory_order_relaxed);
+            auto offset = write & (capacity_ - 1);
+            auto contiguous = capacity_ - offset;
+
+            // Records are never split, the remainder of the data area is skipped if the record does not fit
+            auto needed = record_size + (contiguous < record_size ? contiguous : 0);
+            int detached = 0;
+            if(needed > capacity_ || !wait_for_space(write, needed, detached)) {
+                header_->dropped_events.fetch_add(1, std::memory_order_relaxed);
+                return -1;
+            }
+
+            if(contiguous < record_size) {
+                write_record_header(offset, static_cast<uint32_t>(contiguous), RecordType::PADDING);
+                write += contiguous;
+                offset = 0;
+            }
+            write_record_header(offset, static_cast<uint32_t>(record_size), RecordType::EVENT);
+            std::memcpy(data_ + offset + sizeof(RecordHeader), payload, size);
+
+            header_->write_position.store(write + record_size, std::memory_order_release);
+            header_->published_events.fetch_add(1, std::memory_order_relaxed);
+            return detached;
+        }
+
+        /**
+         * @brief Number of consumers currently attached
+         */
+        unsigned int getConsumerCount() const {
+            unsigned int count = 0;
+            for(const auto& slot : header_->consumers) {
+                count += (slot.state.load(std::memory_order_acquire) == static_cast<uint32_t>(SlotState::ACTIVE) ? 1 : 0);
+            }
+            return count;
+        }
+
+        /**
+         * @brief Size of the data area in bytes
+         */
+        uint64_t getCapacity() const { return capacity_; }
+
+    private:
+        void write_record_header(uint64_t offset, uint32_t size, RecordType type) {
+            RecordHeader record{size, static_cast<uint32_t>(type)};
+            std::memcpy(data_ + offset, &record, sizeof(record));
+        }
+
+        /**
+         * @brief Wait until all active consumers have released enough space for a record
+         * @param write Current write position
+         * @param needed Space required
+         * @param detached Number of consumers detached after the timeout
+         * @return True if the record can be written, false if it should be dropped
+         */
+        bool wait_for_space(uint64_t write, uint64_t needed, int& detached) {
+            auto start = std::chrono::steady_clock::now();
+            while(true) {
+                bool blocked = false;
+                for(auto& slot : header_->consumers) {
+                    if(slot.state.load(std::memory_order_acquire) != static_cast<uint32_t>(SlotState::ACTIVE)) {
+                        continue;
+                    }
+                    // Positions behind the write position by more than the capacity belong to consumers still attaching
+                    auto used = write - slot.read_position.load(std::memory_order_acquire);
+                    if(used <= capacity_ && used + needed > capacity_) {
+                        blocked = true;
+                    }
+                }
+                if(!blocked) {
+                    return true;
+                }
+                if(policy_ == FullPolicy::DROP) {
+                    return false;
+                }
+
+                // Detach consumers which have not released enough space within the timeout
+                if(std::chrono::steady_clock::now() - start > timeout_) {
+                    for(auto& slot : header_->consumers) {
+                        auto used = write - slot.read_position.load(std::memory_order_acquire);
+                        auto active = static_cast<uint32_t>(SlotState::ACTIVE);
+                        if(used <= capacity_ && used + needed > capacity_ &&
+                           slot.state.compare_exchange_strong(active, static_cast<uint32_t>(SlotState::FREE))) {
+                            ++detached;
+                        }
+                    }
+                    return true;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        }
+
+        std::string name_;
+        FullPolicy policy_;
+        std::chrono::nanoseconds timeout_;
+        uint64_t capacity_{};
+
+        void* memory_{};
+        RingHeader* header_{};
+        char* data_{};
+    };
+
+    /**
+     * @brief Pixel hits and particles of a single detector in an event record
+     */
+    struct DetectorView {
+        std::string name;
+        const HitRecord* hits;
+        size_t hit_count;
+        const ParticleRecord* particles;
+        size_t particle_count;
+        const uint32_t* links;
+        size_t link_count;
+
+        /**
+         * @brief Get the particles which created a pixel hit
+         * @param hit Pixel hit of this detector
+         * @return List of pointers to the particles
+         */
+        std::vector<const ParticleRecord*> getParticles(const HitRecord& hit) const {
+            std::vector<const ParticleRecord*> particles_of_hit;
+            for(auto i = hit.first_link; i < hit.first_link + hit.links && i < link_count; ++i) {
+                if(links[i] < particle_count) {
+                    particles_of_hit.push_back(&particles[links[i]]);
+                }
+            }
+            return particles_of_hit;
+        }
+    };
+
+    /**
+     * @brief Event record as seen by a consumer, pointing directly into the shared memory segment
+     */
+    struct EventView {
+        uint64_t event;
+        uint64_t seed;
+        std::vector<DetectorView> detectors;
+    };
+
+    /**
+     * @brief Consumer reading all records from the ring buffer
+     *
+     * Every consumer receives all events published after it attached. The data of an event remains valid until the next
+     * call to \ref release, after which the producer can overwrite it. Consumers which do not release an event within the
+     * timeout of the producer are detached and have to reconnect.
+     */
+    class RingConsumer {
+    public:
+        /**
+         * @brief Attach to an existing ring buffer
+         * @param name Name of the segment, as passed to shm_open by the producer
+         */
+        explicit RingConsumer(const std::string& name) {
+            auto fd = shm_open(name.c_str(), O_RDWR, 0);
+            if(fd < 0) {
+                throw std::runtime_error("could not open shared memory segment " + name);
+            }
+            struct stat info {};
+            if(fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RingHeader)) {
+                close(fd);
+                throw std::runtime_error("shared memory segment " + name + " is not a ring buffer");
+            }
+            size_ = static_cast<size_t>(info.st_size);
+            memory_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if(memory_ == MAP_FAILED) { // NOLINT
+                throw std::runtime_error("could not map shared memory segment " + name);
+            }
+
+            header_ = static_cast<RingHeader*>(memory_);
+            if(std::memcmp(header_->magic, ring_magic, sizeof(ring_magic)) != 0 ||
+               header_->header_size != sizeof(RingHeader) || segment_size(header_->capacity) != size_) {
+                munmap(memory_, size_);
+                throw std::runtime_error("shared memory segment " + name + " has an incompatible layout");
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            capacity_ = header_->capacity;
+            data_ = static_cast<const char*>(memory_) + sizeof(RingHeader);
+
+            // Claim a free slot and start reading at the current write position
+            for(auto& slot : header_->consumers) {
+                auto free = static_cast<uint32_t>(SlotState::FREE);
+                if(slot.state.compare_exchange_strong(free, static_cast<uint32_t>(SlotState::CLAIMING))) {
+                    slot_ = &slot;
+                    break;
+                }
+            }
+            if(slot_ == nullptr) {
+                munmap(memory_, size_);
+                throw std::runtime_error("maximum number of consumers attached to shared memory segment " + name);
+            }
+            slot_->read_position.store(header_->write_position.load(std::memory_order_acquire), std::memory_order_release);
+            slot_->state.store(static_cast<uint32_t>(SlotState::ACTIVE), std::memory_order_release);
+            // The producer may have advanced while claiming the slot, it only respects the position from now on
+            read_position_ = header_->write_position.load(std::memory_order_acquire);
+            slot_->read_position.store(read_position_, std::memory_order_release);
+        }
+
+        /**
+         * @brief Detach from the ring buffer
+         */
+        ~RingConsumer() {
+            auto active = static_cast<uint32_t>(SlotState::ACTIVE);
+            slot_->state.compare_exchange_strong(active, static_cast<uint32_t>(SlotState::FREE));
+            munmap(memory_, size_);
+        }
+
+        /// @{
+        /**
+         * @brief Disable copying and moving of the consumer
+         */
+        RingConsumer(const RingConsumer&) = delete;
+        RingConsumer& operator=(const RingConsumer&) = delete;
+        RingConsumer(RingConsumer&&) = delete;
+        RingConsumer& operator=(RingConsumer&&) = delete;
+        /// @}
+
+        /**
+         * @brief Wait for the next event
+         * @param event View of the event, pointing into the shared memory segment
+         * @param timeout Maximum time to wait
+         * @return True if an event has been read, false if the timeout expired or the producer closed the buffer
+         */
+        bool next(EventView& event, std::chrono::nanoseconds timeout) {
+            if(pending_ != 0) {
+                release();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            while(true) {
+                if(!isAttached()) {
+                    throw std::runtime_error("consumer has been detached from shared memory ring buffer");
+                }
+
+                auto write = header_->write_position.load(std::memory_order_acquire);
+                if(read_position_ == write) {
+                    if(header_->closed.load(std::memory_order_acquire) != 0 ||
+                       std::chrono::steady_clock::now() - start > timeout) {
+                        return false;
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    continue;
+                }
+
+                RecordHeader record{};
+                std::memcpy(&record, data_ + (read_position_ & (capacity_ - 1)), sizeof(record));
+                if(record.type == static_cast<uint32_t>(RecordType::PADDING)) {
+                    read_position_ += record.size;
+                    continue;
+                }
+
+                pending_ = record.size;
+                parse(data_ + (read_position_ & (capacity_ - 1)) + sizeof(RecordHeader), event);
+                return true;
+            }
+        }
+
+        /**
+         * @brief Release the current event, allowing the producer to overwrite its data
+         * @return False if the consumer has been detached before releasing, in which case the data might have been
+         * overwritten while reading
+         */
+        bool release() {
+            read_position_ += pending_;
+            pending_ = 0;
+            slot_->read_position.store(read_position_, std::memory_order_release);
+            return isAttached();
+        }
+
+        /**
+         * @brief Check if the consumer is still attached to the ring buffer
+         */
+        bool isAttached() const {
+            return slot_->state.load(std::memory_order_acquire) == static_cast<uint32_t>(SlotState::ACTIVE);
+        }
+
+        /**
+         * @brief Number of events published and dropped by the producer in total
+         */
+        uint64_t getPublishedEvents() const { return header_->published_events.load(std::memory_order_relaxed); }
+        uint64_t getDroppedEvents() const { return header_->dropped_events.load(std::memory_order_relaxed); }
+
+    private:
+        static void parse(const char* payload, EventView& event) {
+            EventRecord record{};
+            std::memcpy(&record, payload, sizeof(record));
+            event.event = record.event;
+            event.seed = record.seed;
+            event.detectors.resize(record.detectors);
+
+            const char* block = payload + sizeof(record);
+            for(auto& view : event.detectors) {
+                DetectorRecord detector{};
+                std::memcpy(&detector, block, sizeof(detector));
+                view.name.assign(detector.name, strnlen(detector.name, detector_name_length));
+                block += sizeof(detector);
+
+                // Records are eight byte aligned within the segment
+                view.hits = reinterpret_cast<const HitRecord*>(block); // NOLINT
+                view.hit_count = detector.hits;
+                block += detector.hits * sizeof(HitRecord);
+                view.particles = reinterpret_cast<const ParticleRecord*>(block); // NOLINT
+                view.particle_count = detector.particles;
+                block += detector.particles * sizeof(ParticleRecord);
+                view.links = reinterpret_cast<const uint32_t*>(block); // NOLINT
+                view.link_count = detector.links;
+                block += align8(detector.links * sizeof(uint32_t));
+            }
+        }
+
+        void* memory_{};
+        size_t size_{};
+        RingHeader* header_{};
+        const char* data_{};
+        uint64_t capacity_{};
+
+        ConsumerSlot* slot_{};
+        uint64_t read_position_{};
+        uint64_t pending_{};
+    };
+} // namespace allpix::shm
+
+#endif /* ALLPIX_SHARED_MEMORY_RING_H */
@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @brief Implementation of shared memory writer module
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "SharedMemoryWriterModule.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "core/utils/log.h"
+#include "core/utils/text.h"
+#include "objects/exceptions.h"
+
+using namespace allpix;
+
+namespace {
+    // Append a record to the serialization buffer
+    template <typename T> void append(std::vector<char>& buffer, const T& record) {
+        auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &record, sizeof(T));
+    }
+} // namespace
+
+SharedMemoryWriterModule::SharedMemoryWriterModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager)
+    : SequentialModule(config), messenger_(messenger), geo_manager_(geo_manager) {
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    // Publish an event record for every event, also if no pixel hits have been dispatched
+    messenger_->bindMulti<PixelHitMessage>(this);
+
+    config_.setDefault("segment_name", "allpix");
+    config_.setDefault<unsigned long>("buffer_size", 64ul << 20);
+    config_.setDefault("full_policy", "block");
+    config_.setDefault<unsigned long>("block_timeout", Units::get(1000ul, "ms"));
+    config_.setDefault("output_mctruth", true);
+    config_.setDefault("remove_segment", true);
+}
+
+void SharedMemoryWriterModule::initialize() {
+    output_mc_truth_ = config_.get<bool>("output_mctruth");
+
+    segment_name_ = config_.get<std::string>("segment_name");
+    if(segment_name_.empty() || segment_name_.find('/') != std::string::npos) {
+        throw InvalidValueError(config_, "segment_name", "name has to be non-empty and must not contain slashes");
+    }
+    segment_name_.insert(0, "/");
+
+    auto policy_name = allpix::transform(config_.get<std::string>("full_policy"), ::tolower);
+    shm::FullPolicy policy{};
+    if(policy_name == "block") {
+        policy = shm::FullPolicy::BLOCK;
+    } else if(policy_name == "drop") {
+        policy = shm::FullPolicy::DROP;
+    } else {
+        throw InvalidValueError(config_, "full_policy", "policy has to be 'block' or 'drop'");
+    }
+
+    for(const auto& detector : geo_manager_->getDetectors()) {
+        if(detector->getName().size() >= shm::detector_name_length) {
+            LOG(WARNING) << "Name of detector " << detector->getName() << " will be truncated to "
+                         << (shm::detector_name_length - 1) << " characters in the shared memory records";
+        }
+    }
+
+    try {
+        producer_ = std::make_unique<shm::RingProducer>(
+            segment_name_,
+            config_.get<unsigned long>("buffer_size"),
+            policy,
+            std::chrono::nanoseconds(config_.get<unsigned long>("block_timeout")));
+    } catch(const std::runtime_error& e) {
+        throw ModuleError(e.what());
+    }
+    LOG(STATUS) << "Publishing pixel hits to shared memory segment " << segment_name_ << " with "
+                << producer_->getCapacity() << " bytes";
+}
+
+void SharedMemoryWriterModule::run(Event* event) {
+    auto messages = messenger_->fetchMultiMessage<PixelHitMessage>(this, event);
+
+    record_.clear();
+    append(record_,
+           shm::EventRecord{event->number, event->getSeed(), static_cast<uint32_t>(messages.size()), 0});
+
+    for(const auto& message : messages) {
+        const auto& hits = message->getData();
+
+        // Collect the particles which created the hits, every particle is only stored once per detector
+        std::vector<shm::HitRecord> hit_records;
+        std::vector<shm::ParticleRecord> particle_records;
+        std::vector<uint32_t> links;
+        std::map<const MCParticle*, uint32_t> particle_indices;
+        hit_records.reserve(hits.size());
+        for(const auto& hit : hits) {
+            auto index = hit.getPixel().getIndex();
+            shm::HitRecord hit_record{index.x(),
+                                      index.y(),
+                                      hit.getSignal(),
+                                      hit.getLocalTime(),
+                                      hit.getGlobalTime(),
+                                      static_cast<uint32_t>(links.size()),
+                                      0};
+
+            if(output_mc_truth_) {
+                std::vector<const MCParticle*> particles;
+                try {
+                    particles = hit.getMCParticles();
+                } catch(const MissingReferenceException& e) {
+                    LOG_ONCE(WARNING) << "Monte Carlo particles of pixel hits are not available: " << e.what();
+                }
+                for(const auto* particle : particles) {
+                    auto [iter, inserted] =
+                        particle_indices.emplace(particle, static_cast<uint32_t>(particle_records.size()));
+                    if(inserted) {
+                        auto start = particle->getLocalStartPoint();
+                        auto end = particle->getLocalEndPoint();
+                        particle_records.push_back({particle->getParticleID(),
+                                                    0,
+                                                    {start.x(), start.y(), start.z()},
+                                                    {end.x(), end.y(), end.z()},
+                                                    particle->getLocalTime(),
+                                                    particle->getGlobalTime()});
+                    }
+                    links.push_back(iter->second);
+                }
+                hit_record.links = static_cast<uint32_t>(links.size()) - hit_record.first_link;
+            }
+            hit_records.push_back(hit_record);
+        }
+
+        shm::DetectorRecord detector_record{};
+        auto name = (message->getDetector() != nullptr ? message->getDetector()->getName() : std::string("global"));
+        std::memcpy(detector_record.name, name.data(), std::min(name.size(), shm::detector_name_length - 1));
+        detector_record.hits = static_cast<uint32_t>(hit_records.size());
+        detector_record.particles = static_cast<uint32_t>(particle_records.size());
+        detector_record.links = static_cast<uint32_t>(links.size());
+        append(record_, detector_record);
+        for(const auto& hit_record : hit_records) {
+            append(record_, hit_record);
+        }
+        for(const auto& particle_record : particle_records) {
+            append(record_, particle_record);
+        }
+        for(const auto& link : links) {
+            append(record_, link);
+        }
+        record_.resize(shm::align8(record_.size()));
+    }
+
+    auto detached = producer_->publish(record_.data(), record_.size());
+    if(detached < 0) {
+        LOG(DEBUG) << "Dropped event " << event->number << " because the ring buffer is full";
+        ++dropped_events_;
+        return;
+    }
+    if(detached > 0) {
+        LOG(WARNING) << "Detached " << detached << " consumers which did not release space in the ring buffer in time";
+        detached_consumers_ += static_cast<unsigned long>(detached);
+    }
+    LOG(TRACE) << "Published event " << event->number << " with " << record_.size() << " bytes to "
+               << producer_->getConsumerCount() << " consumers";
+    ++published_events_;
+}
+
+void SharedMemoryWriterModule::finalize() {
+    if(config_.get<bool>("remove_segment")) {
+        producer_->unlink();
+    }
+    producer_.reset();
+
+    LOG(STATUS) << "Published " << published_events_ << " events to shared memory segment " << segment_name_ << ", dropped "
+                << dropped_events_ << " events and detached " << detached_consumers_ << " consumers";
+}
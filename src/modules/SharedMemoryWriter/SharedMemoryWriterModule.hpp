@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief Definition of shared memory writer module
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/GeometryManager.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
+#include "core/module/Module.hpp"
+
+#include "objects/PixelHit.hpp"
+
+#include "SharedMemoryRing.hpp"
+
+namespace allpix {
+    /**
+     * @ingroup Modules
+     * @brief Module to publish pixel hits to a shared memory ring buffer for online consumers
+     *
+     * Serializes the pixel hits of all detectors and the Monte Carlo particles which created them into one record per event
+     * and publishes it to a POSIX shared memory ring buffer. Local consumers attach to the ring buffer with the consumer
+     * provided in \ref SharedMemoryRing.hpp and read the records without copying them.
+     */
+    class SharedMemoryWriterModule : public SequentialModule {
+    public:
+        /**
+         * @brief Constructor for this unique module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param geo_manager Pointer to the geometry manager, containing the detectors
+         */
+        SharedMemoryWriterModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager);
+
+        /**
+         * @brief Create the shared memory segment
+         */
+        void initialize() override;
+
+        /**
+         * @brief Serialize the pixel hits of the event and publish them to the ring buffer
+         */
+        void run(Event* event) override;
+
+        /**
+         * @brief Close the ring buffer and print statistics
+         */
+        void finalize() override;
+
+    private:
+        Messenger* messenger_;
+        GeometryManager* geo_manager_;
+
+        bool output_mc_truth_{};
+        std::string segment_name_;
+
+        std::unique_ptr<shm::RingProducer> producer_;
+
+        // Buffer to serialize the event records into
+        std::vector<char> record_;
+
+        // Statistics
+        std::atomic<unsigned long> published_events_{};
+        std::atomic<unsigned long> dropped_events_{};
+        std::atomic<unsigned long> detached_consumers_{};
+    };
+} // namespace allpix
@@ -14,6 +14,7 @@
 #include <fstream>
 #include <limits>
 #include <memory>
+#include <memory_resource>
 #include <new>
 #include <stdexcept>
 #include <string>
@@ -93,7 +94,8 @@ void SimpleTransferModule::run(Event* event) {
     // Find corresponding pixels for all propagated charges
     LOG(TRACE) << "Transferring charges to pixels";
     unsigned int transferred_charges_count = 0;
-    std::map<Pixel::Index, std::vector<const PropagatedCharge*>> pixel_map;
+    // Temporary map allocated from the event memory arena
+    std::pmr::map<Pixel::Index, std::pmr::vector<const PropagatedCharge*>> pixel_map(event->getMemoryResource());
     for(const auto& propagated_charge : propagated_message->getData()) {
         auto position = propagated_charge.getLocalPosition();
 
@@ -152,6 +154,7 @@ void SimpleTransferModule::run(Event* event) {
     // Create pixel charges
     LOG(TRACE) << "Combining charges at same pixel";
     std::vector<PixelCharge> pixel_charges;
+    pixel_charges.reserve(pixel_map.size());
     for(auto& pixel_index_charge : pixel_map) {
         long charge = 0;
         for(auto& propagated_charge : pixel_index_charge.second) {
@@ -161,7 +164,10 @@ void SimpleTransferModule::run(Event* event) {
         // Get pixel object from detector
         auto pixel = detector_->getPixel(pixel_index_charge.first.x(), pixel_index_charge.first.y());
 
-        pixel_charges.emplace_back(pixel, charge, pixel_index_charge.second);
+        pixel_charges.emplace_back(
+            pixel,
+            charge,
+            std::vector<const PropagatedCharge*>(pixel_index_charge.second.begin(), pixel_index_charge.second.end()));
         LOG(DEBUG) << "Set of " << charge << " charges combined at " << pixel.getIndex();
     }
 
@@ -170,7 +176,7 @@ void SimpleTransferModule::run(Event* event) {
     total_transferred_charges_ += transferred_charges_count;
 
     // Dispatch message of pixel charges
-    auto pixel_message = std::make_shared<PixelChargeMessage>(pixel_charges, detector_);
+    auto pixel_message = std::make_shared<PixelChargeMessage>(std::move(pixel_charges), detector_);
     messenger_->dispatchMessage(this, pixel_message, event);
 }
 
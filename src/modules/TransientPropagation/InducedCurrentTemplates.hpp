@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief Definition of a library of induced current templates for the transient propagation
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_TRANSIENT_PROPAGATION_TEMPLATES_H
+#define ALLPIX_TRANSIENT_PROPAGATION_TEMPLATES_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <cereal/types/array.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+namespace allpix {
+    /**
+     * @brief Library of mean induced current pulses for charge carriers starting on a regular grid within a pixel cell
+     *
+     * For every carrier type and every node of the in-pixel grid, the induced charge per time bin is stored for each pixel
+     * of the induction matrix around the pixel the carrier started in, together with the final position relative to the
+     * starting point and the drift time. The grid nodes span the full pixel cell in x and y and the full sensor thickness
+     * in z, including the boundaries.
+     */
+    struct InducedCurrentTemplates {
+        /**
+         * @brief Description of the configuration the templates have been generated for
+         */
+        std::string key;
+
+        /**
+         * @brief Number of grid nodes in x, y and z
+         */
+        std::array<size_t, 3> bins{};
+
+        /**
+         * @brief Extent of the grid in x, y and z
+         */
+        std::array<double, 3> size{};
+
+        /**
+         * @brief Time binning of the stored pulses
+         */
+        double timestep{};
+
+        /**
+         * @brief Size of the induction matrix in pixels from the central pixel
+         */
+        unsigned int distance{};
+
+        /**
+         * @brief Induced charge per unit charge and time bin, indexed via \ref index
+         */
+        std::vector<std::vector<double>> pulses;
+
+        /**
+         * @brief Final displacement in x, y, z and drift time per carrier type and node, indexed via \ref node_index
+         */
+        std::vector<std::array<double, 4>> endpoints;
+
+        /**
+         * @brief Number of pixels in the induction matrix
+         */
+        size_t matrix() const { return (2 * distance + 1) * (2 * distance + 1); }
+
+        /**
+         * @brief Index of a grid node for a given carrier type
+         * @param type Carrier type index, zero for electrons and one for holes
+         * @param x Node index in x
+         * @param y Node index in y
+         * @param z Node index in z
+         */
+        size_t node_index(size_t type, size_t x, size_t y, size_t z) const {
+            return ((type * bins[0] + x) * bins[1] + y) * bins[2] + z;
+        }
+
+        /**
+         * @brief Index of a pulse for a given grid node and pixel offset within the induction matrix
+         * @param node Index of the grid node as returned by \ref node_index
+         * @param dx Pixel offset in x from the central pixel
+         * @param dy Pixel offset in y from the central pixel
+         */
+        size_t index(size_t node, int dx, int dy) const {
+            auto width = static_cast<int>(2 * distance + 1);
+            return node * matrix() + static_cast<size_t>((dx + static_cast<int>(distance)) * width + dy +
+                                                         static_cast<int>(distance));
+        }
+
+        /**
+         * @brief Serialization of the template library
+         */
+        template <class Archive> void serialize(Archive& archive) {
+            archive(key, bins, size, timestep, distance, pulses, endpoints);
+        }
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_TRANSIENT_PROPAGATION_TEMPLATES_H */
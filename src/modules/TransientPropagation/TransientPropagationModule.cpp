@@ -11,16 +11,26 @@
 
 #include "TransientPropagationModule.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include <Eigen/Core>
+#include <cereal/archives/portable_binary.hpp>
 
 #include "core/utils/distributions.h"
+#include "core/utils/hash.h"
 #include "core/utils/log.h"
 #include "objects/exceptions.h"
+#include "tools/capture_clock.h"
 #include "tools/runge_kutta.h"
 
 using namespace allpix;
@@ -58,11 +68,23 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
     config_.setDefault<unsigned int>("max_multiplication_level", 5);
     config_.setDefault<std::string>("multiplication_model", "none");
 
+    // Set defaults for induced current templates
+    config_.setDefault<bool>("sample_capture_times", false);
+    config_.setDefault<unsigned int>("capture_time_validation_samples", 0);
+
+    config_.setDefault<bool>("use_templates", false);
+    config_.setDefaultArray<unsigned int>("template_bins", {5, 5, 20});
+    config_.setDefault<bool>("template_smearing", true);
+    config_.setDefault<unsigned int>("template_validation_points", 0);
+
     config_.setDefault<bool>("output_linegraphs", false);
     config_.setDefault<bool>("output_linegraphs_collected", false);
     config_.setDefault<bool>("output_linegraphs_recombined", false);
     config_.setDefault<bool>("output_linegraphs_trapped", false);
     config_.setDefault<bool>("output_animations", false);
+    config_.setDefault<bool>("output_trajectories", false);
+    config_.setDefault<TrajectoryWriter::Precision>("output_trajectories_precision", TrajectoryWriter::Precision::INT16);
+    config_.setDefault<unsigned int>("output_trajectories_decimation", 1);
     config_.setDefault<bool>("output_plots",
                              config_.get<bool>("output_linegraphs") || config_.get<bool>("output_animations"));
     config_.setDefault<bool>("output_animations_color_markers", false);
@@ -83,11 +105,17 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
 
     max_multiplication_level_ = config.get<unsigned int>("max_multiplication_level");
 
+    sample_capture_times_ = config_.get<bool>("sample_capture_times");
+    use_templates_ = config_.get<bool>("use_templates");
+    template_smearing_ = config_.get<bool>("template_smearing");
+
     output_plots_ = config_.get<bool>("output_plots");
     output_linegraphs_ = config_.get<bool>("output_linegraphs");
     output_linegraphs_collected_ = config_.get<bool>("output_linegraphs_collected");
     output_linegraphs_recombined_ = config_.get<bool>("output_linegraphs_recombined");
     output_linegraphs_trapped_ = config_.get<bool>("output_linegraphs_trapped");
+    output_trajectories_ = config_.get<bool>("output_trajectories");
+    record_plot_points_ = output_linegraphs_ || output_trajectories_;
     output_plots_step_ = config_.get<double>("output_plots_step");
 
     // Enable multithreading of this module if multithreading is enabled and no per-event output plots are requested:
@@ -151,6 +179,63 @@ void TransientPropagationModule::initialize() {
         }
     }
 
+    // Prepare the per-thread trajectory files
+    if(output_trajectories_) {
+        trajectory_writer_ =
+            std::make_unique<TrajectoryWriter>(this,
+                                               "trajectories",
+                                               config_.get<TrajectoryWriter::Precision>("output_trajectories_precision"),
+                                               config_.get<unsigned int>("output_trajectories_decimation"),
+                                               output_plots_step_);
+    }
+
+    // Induced current templates only describe the mean drift along the field lines
+    if(use_templates_) {
+        for(const auto& key : {"recombination_model", "trapping_model", "detrapping_model"}) {
+            if(config_.get<std::string>(key) != "none") {
+                throw InvalidCombinationError(config_,
+                                              {"use_templates", key},
+                                              "induced current templates cannot be used with finite carrier lifetime");
+            }
+        }
+        if(!multiplication_.is<NoImpactIonization>()) {
+            throw InvalidCombinationError(config_,
+                                          {"use_templates", "multiplication_model"},
+                                          "induced current templates cannot be used with charge multiplication");
+        }
+        if(has_magnetic_field_) {
+            throw InvalidValueError(
+                config_, "use_templates", "induced current templates cannot be used in the presence of a magnetic field");
+        }
+        if(output_linegraphs_) {
+            throw InvalidCombinationError(config_,
+                                          {"use_templates", "output_linegraphs"},
+                                          "line graphs are not available when using induced current templates");
+        }
+        if(output_trajectories_) {
+            throw InvalidCombinationError(config_,
+                                          {"use_templates", "output_trajectories"},
+                                          "trajectories are not available when using induced current templates");
+        }
+        if(model_->getPixelType() != Pixel::Type::RECTANGLE) {
+            throw InvalidValueError(
+                config_, "use_templates", "induced current templates are only supported for rectangular pixels");
+        }
+
+        build_templates();
+
+        auto validation_points = config_.get<unsigned int>("template_validation_points");
+        if(validation_points > 0) {
+            validate_templates(validation_points);
+        }
+    }
+
+    // Compare the sampled capture times to the decisions per step
+    auto capture_validation_samples = config_.get<unsigned int>("capture_time_validation_samples");
+    if(sample_capture_times_ && capture_validation_samples > 0) {
+        validate_capture_times(capture_validation_samples);
+    }
+
     if(output_plots_) {
 
         auto pitch_x = static_cast<double>(Units::convert(model_->getPixelSize().x(), "um"));
@@ -437,6 +522,13 @@ void TransientPropagationModule::run(Event* event) {
             }
             charges_remaining -= charge_per_step;
 
+            // Form pulses from the induced current templates instead of propagating
+            if(use_templates_) {
+                propagate_with_templates(event, deposit, charge_per_step, propagated_charges);
+                propagated_charges_count += charge_per_step;
+                continue;
+            }
+
             // Get position and propagate through sensor
             auto [recombined, trapped, propagated] = propagate(event,
                                                                deposit,
@@ -472,6 +564,9 @@ void TransientPropagationModule::run(Event* event) {
             LineGraph::Animate(event->number, this, config_, output_plot_points);
         }
     }
+    if(output_trajectories_) {
+        trajectory_writer_->write(event->number, output_plot_points);
+    }
 
     LOG(INFO) << "Propagated " << propagated_charges_count << " charges" << std::endl
               << "Recombined " << recombined_charges_count << " charges during transport" << std::endl
@@ -521,7 +616,7 @@ TransientPropagationModule::propagate(Event* event,
     unsigned int trapped_charges_count = 0;
 
     // Add point of deposition to the output plots if requested
-    if(output_linegraphs_) {
+    if(record_plot_points_) {
         output_plot_points.emplace_back(std::make_tuple(deposit.getGlobalTime(), charge, type, CarrierState::MOTION),
                                         std::vector<ROOT::Math::XYZPoint>());
     }
@@ -549,25 +644,21 @@ TransientPropagationModule::propagate(Event* event,
     // Define lambda functions to compute the charge carrier velocity with or without magnetic field
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
         return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
     };
 
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
 
         Eigen::Vector3d velocity;
         auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
         auto mob = mobility_(type, efield.norm(), doping);
         auto exb = efield.cross(bfield);
 
@@ -590,9 +681,16 @@ TransientPropagationModule::propagate(Event* event,
     ROOT::Math::XYZVector efield{}, last_efield{};
     size_t next_idx = 0;
     auto state = CarrierState::MOTION;
+
+    // Remaining lifetimes until recombination and trapping, drawn once for the set of charge carriers
+    CaptureClock recombination_clock, trapping_clock;
+    if(sample_capture_times_) {
+        recombination_clock.reset(uniform_distribution(event->getRandomEngine()));
+        trapping_clock.reset(uniform_distribution(event->getRandomEngine()));
+    }
     while(state == CarrierState::MOTION && (initial_time_local + runge_kutta.getTime()) < integration_time_) {
         // Update output plots if necessary (depending on the plot step)
-        if(output_linegraphs_) { // Set final state of charge carrier for plotting:
+        if(record_plot_points_) { // Set final state of charge carrier for plotting:
             auto time_idx = static_cast<size_t>(runge_kutta.getTime() / output_plots_step_);
             while(next_idx <= time_idx) {
                 output_plot_points.at(output_plot_index).second.push_back(static_cast<ROOT::Math::XYZPoint>(position));
@@ -604,9 +702,9 @@ TransientPropagationModule::propagate(Event* event,
         last_position = position;
         last_efield = efield;
 
-        // Get electric field at current (pre-step) position
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        // Get electric field and doping concentration at current (pre-step) position
+        double doping = 0;
+        std::tie(efield, doping) = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(position));
 
         // Execute a Runge Kutta step
         auto step = runge_kutta.step();
@@ -647,15 +745,19 @@ TransientPropagationModule::propagate(Event* event,
 
         // Physics effects:
 
-        // Check if charge carrier is still alive:
+        // Check if charge carrier is still alive, either from the remaining lifetime or from a decision for this step:
         if(state == CarrierState::MOTION &&
-           recombination_(type, doping, uniform_distribution(event->getRandomEngine()), timestep_)) {
+           (sample_capture_times_
+                ? recombination_clock.advance(timestep_, recombination_.getLifetime(type, doping))
+                : recombination_(type, doping, uniform_distribution(event->getRandomEngine()), timestep_))) {
             state = CarrierState::RECOMBINED;
         }
 
         // Check if the charge carrier has been trapped:
         if(state == CarrierState::MOTION &&
-           trapping_(type, uniform_distribution(event->getRandomEngine()), timestep_, std::sqrt(efield.Mag2()))) {
+           (sample_capture_times_
+                ? trapping_clock.advance(timestep_, trapping_.getLifetime(type, std::sqrt(efield.Mag2())))
+                : trapping_(type, uniform_distribution(event->getRandomEngine()), timestep_, std::sqrt(efield.Mag2())))) {
             if(output_plots_) {
                 trapping_time_histo_->Fill(runge_kutta.getTime(), charge);
             }
@@ -665,6 +767,9 @@ TransientPropagationModule::propagate(Event* event,
                 // De-trap and advance in time if still below integration time
                 LOG(TRACE) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
                 runge_kutta.advanceTime(detrap_time);
+                if(sample_capture_times_) {
+                    trapping_clock.reset(uniform_distribution(event->getRandomEngine()));
+                }
 
                 if(output_plots_) {
                     detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
@@ -845,7 +950,7 @@ TransientPropagationModule::propagate(Event* event,
     }
 
     // Set final state of charge carrier for plotting:
-    if(output_linegraphs_) {
+    if(record_plot_points_) {
         // If drift time is larger than integration time or the charge carriers have been collected at the backside, reset:
         if(runge_kutta.getTime() >= integration_time_ || last_position.z() < -model_->getSensorSize().z() * 0.45) {
             std::get<3>(output_plot_points.at(output_plot_index).first) = CarrierState::UNKNOWN;
@@ -893,6 +998,502 @@ TransientPropagationModule::propagate(Event* event,
     return std::make_tuple(recombined_charges_count, trapped_charges_count, propagated_charges_count);
 }
 
+/**
+ * The carrier is moved along the field lines using the same Runge-Kutta integration as the full propagation, without
+ * diffusion unless a random number generator is provided. The induced charge is recorded for all pixels of the induction
+ * matrix around the reference pixel.
+ */
+TransientPropagationModule::TemplateDrift
+TransientPropagationModule::drift_template(const CarrierType& type,
+                                           const ROOT::Math::XYZPoint& pos,
+                                           const Pixel::Index& reference,
+                                           RandomNumberGenerator* random_generator) const {
+    auto width = static_cast<int>(2 * distance_ + 1);
+    auto distance = static_cast<int>(distance_);
+    auto sign = static_cast<std::underlying_type<CarrierType>::type>(type);
+
+    TemplateDrift result;
+    result.pulses.resize(static_cast<size_t>(width * width));
+
+    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity =
+        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        auto [raw_field, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+
+        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
+    };
+
+    Eigen::Vector3d position(pos.x(), pos.y(), pos.z());
+    auto runge_kutta = make_runge_kutta(tableau::RK4, carrier_velocity, timestep_, position);
+
+    bool halted = false;
+    while(!halted && runge_kutta.getTime() < integration_time_) {
+        Eigen::Vector3d last_position = position;
+        runge_kutta.step();
+        position = runge_kutta.getValue();
+
+        // Apply diffusion step with the field at the pre-step position as in the full propagation
+        if(random_generator != nullptr) {
+            auto [efield, doping] = detector_->getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(last_position));
+            double diffusion_constant = boltzmann_kT_ * mobility_(type, std::sqrt(efield.Mag2()), doping);
+            allpix::normal_distribution<double> gauss_distribution(0, std::sqrt(2. * diffusion_constant * timestep_));
+            auto x = gauss_distribution(*random_generator);
+            auto y = gauss_distribution(*random_generator);
+            auto z = gauss_distribution(*random_generator);
+            position += Eigen::Vector3d(x, y, z);
+            runge_kutta.setValue(position);
+        }
+
+        if(auto implant = model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+            auto new_position = model_->getImplantIntercept(implant.value(),
+                                                            static_cast<ROOT::Math::XYZPoint>(last_position),
+                                                            static_cast<ROOT::Math::XYZPoint>(position));
+            position = Eigen::Vector3d(new_position.x(), new_position.y(), new_position.z());
+            halted = true;
+        }
+        if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+            auto intercept = model_->getSensorIntercept(static_cast<ROOT::Math::XYZPoint>(last_position),
+                                                        static_cast<ROOT::Math::XYZPoint>(position));
+            position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
+            halted = true;
+        }
+
+        auto bin = static_cast<size_t>(std::lround(runge_kutta.getTime() / timestep_));
+        for(int dx = -distance; dx <= distance; ++dx) {
+            for(int dy = -distance; dy <= distance; ++dy) {
+                auto pixel_index = Pixel::Index(reference.x() + dx, reference.y() + dy);
+                auto ramo = detector_->getWeightingPotential(static_cast<ROOT::Math::XYZPoint>(position), pixel_index);
+                auto last_ramo =
+                    detector_->getWeightingPotential(static_cast<ROOT::Math::XYZPoint>(last_position), pixel_index);
+
+                auto& pulse = result.pulses[static_cast<size_t>((dx + distance) * width + dy + distance)];
+                if(bin >= pulse.size()) {
+                    pulse.resize(bin + 1);
+                }
+                pulse[bin] += sign * (ramo - last_ramo);
+            }
+        }
+    }
+
+    // Remove trailing empty bins, e.g. from carriers resting in field-free regions
+    for(auto& pulse : result.pulses) {
+        while(!pulse.empty() && pulse.back() == 0.) {
+            pulse.pop_back();
+        }
+    }
+
+    result.position = static_cast<ROOT::Math::XYZPoint>(position);
+    result.time = runge_kutta.getTime();
+    return result;
+}
+
+/**
+ * The grid spans the pixel cell of the central pixel of the matrix and the full sensor thickness. If a template file is
+ * configured and was generated for the same configuration, the templates are read from the file instead. The configuration
+ * is identified by the relevant parameters and a hash of the field, doping and weighting potential values at the grid
+ * nodes.
+ */
+void TransientPropagationModule::build_templates() {
+    auto bins = config_.getArray<unsigned int>("template_bins");
+    if(bins.size() != 3 || bins[0] < 2 || bins[1] < 2 || bins[2] < 2) {
+        throw InvalidValueError(config_, "template_bins", "three values with at least two grid nodes each required");
+    }
+
+    templates_.bins = {bins[0], bins[1], bins[2]};
+    templates_.size = {model_->getPixelSize().x(), model_->getPixelSize().y(), model_->getSensorSize().z()};
+    templates_.timestep = timestep_;
+    templates_.distance = distance_;
+
+    // Reference pixel in the center of the matrix and position of the grid nodes within it
+    auto reference = Pixel::Index(static_cast<int>(model_->getNPixels().x() / 2),
+                                  static_cast<int>(model_->getNPixels().y() / 2));
+    auto center = model_->getPixelCenter(reference.x(), reference.y());
+    auto z_min = model_->getSensorCenter().z() - templates_.size[2] / 2;
+    auto node_position = [&](size_t x, size_t y, size_t z) {
+        return ROOT::Math::XYZPoint(
+            center.x() - templates_.size[0] / 2 + templates_.size[0] * static_cast<double>(x) / (bins[0] - 1),
+            center.y() - templates_.size[1] / 2 + templates_.size[1] * static_cast<double>(y) / (bins[1] - 1),
+            z_min + templates_.size[2] * static_cast<double>(z) / (bins[2] - 1));
+    };
+
+    // Identify the configuration the templates are valid for
+    FNV1aHash field_hash;
+    auto distance = static_cast<int>(distance_);
+    for(size_t x = 0; x < bins[0]; ++x) {
+        for(size_t y = 0; y < bins[1]; ++y) {
+            for(size_t z = 0; z < bins[2]; ++z) {
+                auto position = node_position(x, y, z);
+                auto efield = detector_->getElectricField(position);
+                field_hash.add(efield.x());
+                field_hash.add(efield.y());
+                field_hash.add(efield.z());
+                field_hash.add(detector_->getDopingConcentration(position));
+                for(int dx = -distance; dx <= distance; ++dx) {
+                    for(int dy = -distance; dy <= distance; ++dy) {
+                        auto pixel_index = Pixel::Index(reference.x() + dx, reference.y() + dy);
+                        field_hash.add(detector_->getWeightingPotential(position, pixel_index));
+                    }
+                }
+            }
+        }
+    }
+    std::stringstream key;
+    key << std::setprecision(12) << model_->getType() << ";" << templates_.size[0] << ";" << templates_.size[1] << ";"
+        << templates_.size[2] << ";" << bins[0] << ";" << bins[1] << ";" << bins[2] << ";" << timestep_ << ";"
+        << integration_time_ << ";" << distance_ << ";" << config_.get<std::string>("mobility_model") << ";" << temperature_
+        << ";" << std::hex << field_hash.value();
+    templates_.key = key.str();
+
+    // Read templates from file if available
+    std::filesystem::path template_file;
+    if(config_.has("template_file")) {
+        template_file = config_.getPath("template_file");
+        if(std::filesystem::exists(template_file)) {
+            InducedCurrentTemplates cached;
+            try {
+                std::ifstream file(template_file, std::ios::binary);
+                cereal::PortableBinaryInputArchive archive(file);
+                archive(cached);
+            } catch(cereal::Exception& e) {
+                throw InvalidValueError(config_, "template_file", "could not read templates: " + std::string(e.what()));
+            }
+
+            if(cached.key == templates_.key) {
+                templates_ = std::move(cached);
+                LOG(STATUS) << "Read induced current templates from " << template_file;
+                return;
+            }
+            LOG(WARNING) << "Induced current templates in " << template_file
+                         << " were generated for a different configuration, regenerating";
+        }
+    }
+
+    LOG(STATUS) << "Building induced current templates on " << bins[0] << "x" << bins[1] << "x" << bins[2]
+                << " grid, this may take a while";
+    auto nodes = 2 * bins[0] * bins[1] * bins[2];
+    templates_.pulses.assign(nodes * templates_.matrix(), {});
+    templates_.endpoints.assign(nodes, {});
+    for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+        size_t type_index = (type == CarrierType::ELECTRON ? 0 : 1);
+        for(size_t x = 0; x < bins[0]; ++x) {
+            for(size_t y = 0; y < bins[1]; ++y) {
+                for(size_t z = 0; z < bins[2]; ++z) {
+                    auto start = node_position(x, y, z);
+                    auto drift = drift_template(type, start, reference);
+
+                    auto node = templates_.node_index(type_index, x, y, z);
+                    for(int dx = -distance; dx <= distance; ++dx) {
+                        for(int dy = -distance; dy <= distance; ++dy) {
+                            auto width = 2 * distance + 1;
+                            templates_.pulses[templates_.index(node, dx, dy)] = std::move(
+                                drift.pulses[static_cast<size_t>((dx + distance) * width + dy + distance)]);
+                        }
+                    }
+                    templates_.endpoints[node] = {drift.position.x() - start.x(),
+                                                  drift.position.y() - start.y(),
+                                                  drift.position.z() - start.z(),
+                                                  drift.time};
+                }
+            }
+        }
+    }
+    LOG(INFO) << "Built induced current templates for 2 carrier types on " << bins[0] << "x" << bins[1] << "x" << bins[2]
+              << " grid";
+
+    if(!template_file.empty()) {
+        std::ofstream file(template_file, std::ios::binary);
+        if(!file) {
+            throw InvalidValueError(config_, "template_file", "file cannot be created");
+        }
+        cereal::PortableBinaryOutputArchive archive(file);
+        archive(templates_);
+        LOG(STATUS) << "Wrote induced current templates to " << template_file;
+    }
+}
+
+std::array<std::pair<size_t, double>, 8>
+TransientPropagationModule::template_weights(const CarrierType& type, const ROOT::Math::XYZPoint& pos) const {
+    const auto& bins = templates_.bins;
+    auto z_min = model_->getSensorCenter().z() - templates_.size[2] / 2;
+    std::array<double, 3> coordinates{(pos.x() / templates_.size[0] + 0.5) * static_cast<double>(bins[0] - 1),
+                                      (pos.y() / templates_.size[1] + 0.5) * static_cast<double>(bins[1] - 1),
+                                      (pos.z() - z_min) / templates_.size[2] * static_cast<double>(bins[2] - 1)};
+
+    // Find lower grid node and fractional distance to it, clamped to the grid
+    std::array<size_t, 3> lower{};
+    std::array<double, 3> fraction{};
+    for(size_t i = 0; i < 3; ++i) {
+        auto coordinate = std::clamp(coordinates[i], 0., static_cast<double>(bins[i] - 1));
+        lower[i] = std::min(static_cast<size_t>(coordinate), bins[i] - 2);
+        fraction[i] = coordinate - static_cast<double>(lower[i]);
+    }
+
+    size_t type_index = (type == CarrierType::ELECTRON ? 0 : 1);
+    std::array<std::pair<size_t, double>, 8> weights;
+    for(size_t corner = 0; corner < 8; ++corner) {
+        std::array<size_t, 3> offset{corner & 1, (corner >> 1) & 1, (corner >> 2) & 1};
+        double weight = 1.;
+        for(size_t i = 0; i < 3; ++i) {
+            weight *= (offset[i] == 1 ? fraction[i] : 1. - fraction[i]);
+        }
+        weights[corner] = {
+            templates_.node_index(type_index, lower[0] + offset[0], lower[1] + offset[1], lower[2] + offset[2]), weight};
+    }
+    return weights;
+}
+
+/**
+ * The pulses induced by the set of charges are obtained by trilinear interpolation of the templates at the deposition
+ * position within its pixel. Diffusion is accounted for statistically by displacing the starting point laterally by a
+ * random offset drawn from a Gaussian distribution with the width expected for the full drift time of the carriers.
+ */
+void TransientPropagationModule::propagate_with_templates(Event* event,
+                                                          const DepositedCharge& deposit,
+                                                          unsigned int charge,
+                                                          std::vector<PropagatedCharge>& propagated_charges) const {
+    auto type = deposit.getType();
+    auto position = deposit.getLocalPosition();
+
+    auto relative_position = [&](const ROOT::Math::XYZPoint& pos) {
+        auto [xpixel, ypixel] = model_->getPixelIndex(pos);
+        auto center = model_->getPixelCenter(xpixel, ypixel);
+        return ROOT::Math::XYZPoint(pos.x() - center.x(), pos.y() - center.y(), pos.z());
+    };
+
+    if(template_smearing_) {
+        double drift_time = 0;
+        for(const auto& [node, weight] : template_weights(type, relative_position(position))) {
+            drift_time += weight * templates_.endpoints[node][3];
+        }
+
+        auto [efield, doping] = detector_->getElectricFieldAndDoping(position);
+        double diffusion_constant = boltzmann_kT_ * mobility_(type, std::sqrt(efield.Mag2()), doping);
+        allpix::normal_distribution<double> gauss_distribution(0, std::sqrt(2. * diffusion_constant * drift_time));
+        position.SetX(position.x() + gauss_distribution(event->getRandomEngine()));
+        position.SetY(position.y() + gauss_distribution(event->getRandomEngine()));
+    }
+
+    auto [xpixel, ypixel] = model_->getPixelIndex(position);
+    auto weights = template_weights(type, relative_position(position));
+
+    std::array<double, 4> endpoint{};
+    for(const auto& [node, weight] : weights) {
+        for(size_t i = 0; i < 4; ++i) {
+            endpoint[i] += weight * templates_.endpoints[node][i];
+        }
+    }
+
+    // Superpose the weighted templates of the surrounding grid nodes for all pixels of the induction matrix
+    std::map<Pixel::Index, Pulse> pixel_map;
+    auto distance = static_cast<int>(distance_);
+    for(int dx = -distance; dx <= distance; ++dx) {
+        for(int dy = -distance; dy <= distance; ++dy) {
+            auto pixel_index = Pixel::Index(xpixel + dx, ypixel + dy);
+            if(!model_->isWithinMatrix(pixel_index)) {
+                continue;
+            }
+
+            Pulse pulse(timestep_, integration_time_);
+            for(const auto& [node, weight] : weights) {
+                if(weight == 0.) {
+                    continue;
+                }
+                const auto& induced = templates_.pulses[templates_.index(node, dx, dy)];
+                for(size_t bin = 0; bin < induced.size(); ++bin) {
+                    auto time = deposit.getLocalTime() + timestep_ * static_cast<double>(bin);
+                    if(time > integration_time_) {
+                        break;
+                    }
+                    pulse.addCharge(charge * weight * induced[bin], time);
+                }
+            }
+            pixel_map.emplace(pixel_index, std::move(pulse));
+        }
+    }
+
+    auto drift_time = endpoint[3];
+    auto state = (deposit.getLocalTime() + drift_time < integration_time_ ? CarrierState::HALTED : CarrierState::MOTION);
+    auto local_position =
+        ROOT::Math::XYZPoint(position.x() + endpoint[0], position.y() + endpoint[1], position.z() + endpoint[2]);
+    auto global_position = detector_->getGlobalPosition(local_position);
+
+    PropagatedCharge propagated_charge(local_position,
+                                       global_position,
+                                       type,
+                                       std::move(pixel_map),
+                                       deposit.getLocalTime() + drift_time,
+                                       deposit.getGlobalTime() + drift_time,
+                                       state,
+                                       &deposit);
+
+    LOG(DEBUG) << " Formed pulses of " << charge << " charges from templates, drift time "
+               << Units::display(drift_time, "ns") << ", induced " << Units::display(propagated_charge.getCharge(), {"e"});
+
+    propagated_charges.push_back(std::move(propagated_charge));
+}
+
+/**
+ * The lifetimes at the sensor center are combined into the capture rate, and the fractions of charge carriers captured
+ * within the integration time are compared for decisions in steps of the configured time step and for capture clocks.
+ */
+void TransientPropagationModule::validate_capture_times(unsigned int samples) const {
+    // Fixed seed, the validation should not depend on the event seeds
+    RandomNumberGenerator random_generator(0);
+
+    auto center = model_->getSensorCenter();
+    auto [efield, doping] = detector_->getElectricFieldAndDoping(center);
+    for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+        auto lifetime = 1. / (1. / recombination_.getLifetime(type, doping) +
+                              1. / trapping_.getLifetime(type, std::sqrt(efield.Mag2())));
+        auto [per_step, clock] = compare_capture_sampling(random_generator, lifetime, timestep_, integration_time_, samples);
+
+        auto expected = -std::expm1(-std::ceil(integration_time_ / timestep_) * timestep_ / lifetime);
+        auto sigma = std::sqrt(2 * expected * (1 - expected) / samples);
+        LOG(STATUS) << "Compared capture time sampling with per-step sampling for " << samples << " charge carriers ("
+                    << type << "):" << std::endl
+                    << "captured fraction " << clock << " with capture times, " << per_step << " per step, expected "
+                    << expected;
+        if(std::fabs(clock - per_step) > 5 * sigma) {
+            LOG(WARNING) << "Capture time sampling deviates from per-step sampling by "
+                         << std::fabs(clock - per_step) / sigma << " standard deviations";
+        }
+    }
+}
+
+/**
+ * The templates are interpolated at random positions within the pixel cell and compared to the direct drift from the same
+ * position. The deviation is quantified by the difference in total induced charge and the maximum difference of the
+ * cumulative induced charge over time, both per unit charge. If the templates are smeared to account for diffusion, the
+ * smearing is furthermore compared to a set of carriers drifted with diffusion from the same position, using the mean
+ * charge induced in the central pixel and the lateral spread of the end points.
+ */
+void TransientPropagationModule::validate_templates(unsigned int points) const {
+    // Fixed seed, the validation should not depend on the event seeds
+    RandomNumberGenerator random_generator(0);
+    allpix::uniform_real_distribution<double> uniform_distribution(-0.5, 0.5);
+
+    auto reference = Pixel::Index(static_cast<int>(model_->getNPixels().x() / 2),
+                                  static_cast<int>(model_->getNPixels().y() / 2));
+    auto center = model_->getPixelCenter(reference.x(), reference.y());
+    auto distance = static_cast<int>(distance_);
+    auto width = 2 * distance + 1;
+
+    double max_charge_deviation = 0, sum_charge_deviation = 0, max_shape_deviation = 0;
+    double max_diffusion_charge_deviation = 0, max_spread_deviation = 0;
+    size_t comparisons = 0;
+
+    // Number of carriers drifted with diffusion per position to compare the smearing of the templates with
+    const unsigned int diffusion_samples = 100;
+    for(unsigned int point = 0; point < points; ++point) {
+        auto relative = ROOT::Math::XYZPoint(templates_.size[0] * uniform_distribution(random_generator),
+                                             templates_.size[1] * uniform_distribution(random_generator),
+                                             model_->getSensorCenter().z() +
+                                                 templates_.size[2] * uniform_distribution(random_generator));
+        auto start = ROOT::Math::XYZPoint(center.x() + relative.x(), center.y() + relative.y(), relative.z());
+
+        for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+            auto drift = drift_template(type, start, reference);
+            auto weights = template_weights(type, relative);
+
+            for(int dx = -distance; dx <= distance; ++dx) {
+                for(int dy = -distance; dy <= distance; ++dy) {
+                    const auto& direct = drift.pulses[static_cast<size_t>((dx + distance) * width + dy + distance)];
+
+                    // Interpolated pulse from the templates
+                    std::vector<double> interpolated;
+                    for(const auto& [node, weight] : weights) {
+                        const auto& induced = templates_.pulses[templates_.index(node, dx, dy)];
+                        if(interpolated.size() < induced.size()) {
+                            interpolated.resize(induced.size());
+                        }
+                        for(size_t bin = 0; bin < induced.size(); ++bin) {
+                            interpolated[bin] += weight * induced[bin];
+                        }
+                    }
+
+                    // Compare cumulative induced charge over time
+                    double cumulative_direct = 0, cumulative_interpolated = 0, shape_deviation = 0;
+                    for(size_t bin = 0; bin < std::max(direct.size(), interpolated.size()); ++bin) {
+                        cumulative_direct += (bin < direct.size() ? direct[bin] : 0.);
+                        cumulative_interpolated += (bin < interpolated.size() ? interpolated[bin] : 0.);
+                        shape_deviation = std::max(shape_deviation, std::fabs(cumulative_direct - cumulative_interpolated));
+                    }
+                    auto charge_deviation = std::fabs(cumulative_direct - cumulative_interpolated);
+
+                    max_charge_deviation = std::max(max_charge_deviation, charge_deviation);
+                    max_shape_deviation = std::max(max_shape_deviation, shape_deviation);
+                    sum_charge_deviation += charge_deviation;
+                    comparisons++;
+                }
+            }
+
+            if(!template_smearing_) {
+                continue;
+            }
+
+            // Compare the smeared templates to the drift with diffusion from the same position, both for the charge
+            // induced in the central pixel and for the lateral spread of the end points around the drift without diffusion
+            double drift_time = 0;
+            for(const auto& [node, weight] : weights) {
+                drift_time += weight * templates_.endpoints[node][3];
+            }
+            auto [efield, doping] = detector_->getElectricFieldAndDoping(start);
+            auto smearing_width =
+                std::sqrt(2. * boltzmann_kT_ * mobility_(type, std::sqrt(efield.Mag2()), doping) * drift_time);
+            allpix::normal_distribution<double> smearing_distribution(0, smearing_width);
+
+            double direct_charge = 0, smeared_charge = 0, direct_variance = 0;
+            for(unsigned int sample = 0; sample < diffusion_samples; ++sample) {
+                auto diffused = drift_template(type, start, reference, &random_generator);
+                for(auto bin : diffused.pulses[static_cast<size_t>(distance * width + distance)]) {
+                    direct_charge += bin;
+                }
+                auto offset_x = diffused.position.x() - drift.position.x();
+                auto offset_y = diffused.position.y() - drift.position.y();
+                direct_variance += (offset_x * offset_x + offset_y * offset_y) / 2.;
+
+                // Charge induced in the central pixel by a carrier starting in a neighboring pixel after smearing
+                auto smeared_x = start.x() + smearing_distribution(random_generator);
+                auto smeared_y = start.y() + smearing_distribution(random_generator);
+                auto smeared = ROOT::Math::XYZPoint(smeared_x, smeared_y, start.z());
+                auto [xpixel, ypixel] = model_->getPixelIndex(smeared);
+                auto pixel_center = model_->getPixelCenter(xpixel, ypixel);
+                auto dx = reference.x() - xpixel;
+                auto dy = reference.y() - ypixel;
+                if(std::abs(dx) > distance || std::abs(dy) > distance) {
+                    continue;
+                }
+                auto smeared_relative =
+                    ROOT::Math::XYZPoint(smeared.x() - pixel_center.x(), smeared.y() - pixel_center.y(), smeared.z());
+                for(const auto& [node, weight] : template_weights(type, smeared_relative)) {
+                    for(auto bin : templates_.pulses[templates_.index(node, dx, dy)]) {
+                        smeared_charge += weight * bin;
+                    }
+                }
+            }
+            auto diffusion_charge_deviation = std::fabs(direct_charge - smeared_charge) / diffusion_samples;
+            auto direct_width = std::sqrt(direct_variance / diffusion_samples);
+            auto spread_deviation =
+                (smearing_width > 0 ? std::fabs(direct_width - smearing_width) / smearing_width : 0.);
+
+            max_diffusion_charge_deviation = std::max(max_diffusion_charge_deviation, diffusion_charge_deviation);
+            max_spread_deviation = std::max(max_spread_deviation, spread_deviation);
+        }
+    }
+
+    LOG(STATUS) << "Validated induced current templates against direct drift at " << points << " positions:" << std::endl
+                << "mean deviation of induced charge per carrier " << sum_charge_deviation / std::max<size_t>(1, comparisons)
+                << ", maximum " << max_charge_deviation << std::endl
+                << "maximum deviation of cumulative induced charge over time " << max_shape_deviation;
+    if(template_smearing_) {
+        LOG(STATUS) << "Validated smeared induced current templates against drift with diffusion of " << diffusion_samples
+                    << " carriers per position:" << std::endl
+                    << "maximum deviation of mean induced charge in central pixel per carrier "
+                    << max_diffusion_charge_deviation << std::endl
+                    << "maximum relative deviation of lateral diffusion width " << max_spread_deviation;
+    }
+}
+
 void TransientPropagationModule::finalize() {
     LOG(INFO) << deposits_exceeding_max_groups_ * 100.0 / total_deposits_ << "% of deposits have charge exceeding the "
               << max_charge_groups_ << " charge groups allowed, with a charge_per_step value of " << charge_per_step_ << ".";
@@ -9,7 +9,10 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <array>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <Math/DisplacementVector2D.h>
 #include <Math/Point3D.h>
@@ -34,6 +37,9 @@
 
 #include "tools/ROOT.h"
 #include "tools/line_graphs.h"
+#include "tools/trajectory_writer.h"
+
+#include "InducedCurrentTemplates.hpp"
 
 namespace allpix {
     /**
@@ -104,16 +110,87 @@ namespace allpix {
                   std::vector<PropagatedCharge>& propagated_charges,
                   LineGraph::OutputPlotPoints& output_plot_points) const;
 
+        /**
+         * @brief Result of the drift of a single charge carrier without diffusion
+         */
+        struct TemplateDrift {
+            std::vector<std::vector<double>> pulses;
+            ROOT::Math::XYZPoint position;
+            double time{};
+        };
+
+        /**
+         * @brief Drift a single charge carrier along the field lines and record the induced current on the matrix
+         * @param type             Type of the carrier to drift
+         * @param pos              Start position of the carrier in local coordinates
+         * @param reference        Index of the central pixel of the induction matrix
+         * @param random_generator Random number generator to apply diffusion steps with, no diffusion if not provided
+         * @return Induced charge per time bin for all pixels of the induction matrix, final position and drift time
+         */
+        TemplateDrift drift_template(const CarrierType& type,
+                                     const ROOT::Math::XYZPoint& pos,
+                                     const Pixel::Index& reference,
+                                     RandomNumberGenerator* random_generator = nullptr) const;
+
+        /**
+         * @brief Build the induced current template library for the configured grid
+         */
+        void build_templates();
+
+        /**
+         * @brief Compare pulses obtained from the templates with the direct drift at random positions
+         * @param points Number of random positions to evaluate
+         */
+        void validate_templates(unsigned int points) const;
+
+        /**
+         * @brief Compare the fraction of captured charge carriers between capture clocks and decisions per step
+         * @param samples Number of charge carriers to sample with each method
+         */
+        void validate_capture_times(unsigned int samples) const;
+
+        /**
+         * @brief Find the grid nodes surrounding a position and their trilinear interpolation weights
+         * @param type Type of the charge carrier
+         * @param pos  Position relative to the center of the pixel in x and y, local coordinate in z
+         * @return Indices of the eight surrounding grid nodes with their weights
+         */
+        std::array<std::pair<size_t, double>, 8> template_weights(const CarrierType& type,
+                                                                  const ROOT::Math::XYZPoint& pos) const;
+
+        /**
+         * @brief Form the induced pulses of a set of charges from the templates
+         * @param event              Pointer to current event
+         * @param deposit            Reference to the original deposited charge object
+         * @param charge             Total charge of the observed charge carrier set
+         * @param propagated_charges Reference to vector with all produced final PropagatedCharge objects
+         */
+        void propagate_with_templates(Event* event,
+                                      const DepositedCharge& deposit,
+                                      unsigned int charge,
+                                      std::vector<PropagatedCharge>& propagated_charges) const;
+
         // Local copies of configuration parameters to avoid costly lookup:
         double temperature_{}, timestep_{}, integration_time_{}, output_plots_step_{};
         bool output_plots_{}, output_linegraphs_{}, output_linegraphs_collected_{}, output_linegraphs_recombined_{},
-            output_linegraphs_trapped_{};
+            output_linegraphs_trapped_{}, output_trajectories_{}, record_plot_points_{};
         unsigned int distance_{};
         unsigned int charge_per_step_{};
         unsigned int max_charge_groups_{};
 
         unsigned int max_multiplication_level_{};
 
+        // Sample the time until recombination and trapping instead of deciding in every step
+        bool sample_capture_times_{};
+
+        // Writer for the sampled trajectories of the charge carriers
+        std::unique_ptr<TrajectoryWriter> trajectory_writer_;
+
+        // Induced current templates
+        bool use_templates_{};
+        bool template_smearing_{};
+        InducedCurrentTemplates templates_;
+
         // Models for electron and hole mobility and lifetime
         Mobility mobility_;
         Recombination recombination_;
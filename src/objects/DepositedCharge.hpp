@@ -24,6 +24,7 @@ namespace allpix {
      */
     class DepositedCharge : public SensorCharge {
         friend class PropagatedCharge;
+        template <typename T> friend class ObjectColumns;
 
     public:
         /**
@@ -24,6 +24,8 @@ namespace allpix {
      * @brief Monte-Carlo particle through the sensor
      */
     class MCParticle : public Object {
+        template <typename T> friend class ObjectColumns;
+
     public:
         /**
          * @brief Construct a Monte-Carlo particle
@@ -23,6 +23,8 @@ namespace allpix {
      * @brief Monte-Carlo track through the world
      */
     class MCTrack : public Object {
+        template <typename T> friend class ObjectColumns;
+
     public:
         /**
          * @brief Construct a Monte-Carlo track
@@ -26,6 +26,7 @@
 
 namespace allpix {
     template <typename T> class Message;
+    template <typename T> class ObjectColumns;
 
     /**
      * @ingroup Objects
@@ -74,6 +75,12 @@ namespace allpix {
          */
         virtual void petrifyHistory() = 0;
 
+        /**
+         * @brief Get the approximate size of the memory allocated by this object in addition to its own size
+         * @return Size of the dynamically allocated memory in bytes
+         */
+        virtual size_t getDynamicMemorySize() const { return 0; }
+
         void markForStorage() {
             // Using bit 14 of the TObject bit field, unused by ROOT:
             this->SetBit(1ull << 14);
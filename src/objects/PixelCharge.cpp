@@ -152,3 +152,9 @@ void PixelCharge::petrifyHistory() {
     std::for_each(propagated_charges_.begin(), propagated_charges_.end(), [](auto& n) { n.store(); });
     std::for_each(mc_particles_.begin(), mc_particles_.end(), [](auto& n) { n.store(); });
 }
+
+size_t PixelCharge::getDynamicMemorySize() const {
+    return pulse_.capacity() * sizeof(double) +
+           propagated_charges_.capacity() * sizeof(PointerWrapper<PropagatedCharge>) +
+           mc_particles_.capacity() * sizeof(PointerWrapper<MCParticle>);
+}
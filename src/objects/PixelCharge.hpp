@@ -30,6 +30,7 @@ namespace allpix {
     class PixelCharge : public Object {
         friend class PixelHit;
         friend class PixelPulse;
+        template <typename T> friend class ObjectColumns;
 
     public:
         /**
@@ -130,6 +131,7 @@ namespace allpix {
 
         void loadHistory() override;
         void petrifyHistory() override;
+        size_t getDynamicMemorySize() const override;
 
     private:
         Pixel pixel_;
@@ -129,3 +129,5 @@ void PixelHit::petrifyHistory() {
     pixel_charge_.store();
     std::for_each(mc_particles_.begin(), mc_particles_.end(), [](auto& n) { n.store(); });
 }
+
+size_t PixelHit::getDynamicMemorySize() const { return mc_particles_.capacity() * sizeof(PointerWrapper<MCParticle>); }
@@ -29,6 +29,8 @@ namespace allpix {
      * @brief Pixel triggered in an event after digitization
      */
     class PixelHit : public Object {
+        template <typename T> friend class ObjectColumns;
+
     public:
         /**
          * @brief Construct a digitized pixel hit
@@ -118,6 +120,7 @@ namespace allpix {
 
         void loadHistory() override;
         void petrifyHistory() override;
+        size_t getDynamicMemorySize() const override;
 
     private:
         Pixel pixel_;
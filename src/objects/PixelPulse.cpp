@@ -117,3 +117,7 @@ void PixelPulse::petrifyHistory() {
     pixel_charge_.store();
     std::for_each(mc_particles_.begin(), mc_particles_.end(), [](auto& n) { n.store(); });
 }
+
+size_t PixelPulse::getDynamicMemorySize() const {
+    return Pulse::capacity() * sizeof(double) + mc_particles_.capacity() * sizeof(PointerWrapper<MCParticle>);
+}
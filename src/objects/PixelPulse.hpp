@@ -29,6 +29,8 @@ namespace allpix {
      * @brief Pixel triggered in an event after digitization
      */
     class PixelPulse : public Object, public Pulse {
+        template <typename T> friend class ObjectColumns;
+
     public:
         /**
          * @brief Construct a digitized pixel front-end pulse
@@ -98,6 +100,7 @@ namespace allpix {
 
         void loadHistory() override;
         void petrifyHistory() override;
+        size_t getDynamicMemorySize() const override;
 
     private:
         Pixel pixel_;
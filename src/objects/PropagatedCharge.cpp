@@ -102,3 +102,12 @@ void PropagatedCharge::petrifyHistory() {
     deposited_charge_.store();
     mc_particle_.store();
 }
+
+size_t PropagatedCharge::getDynamicMemorySize() const {
+    // Every map node holds the pixel index and the pulse, in addition to the tree pointers and the pulse bins
+    size_t size = 0;
+    for(const auto& [index, pulse] : pulses_) {
+        size += sizeof(std::pair<const Pixel::Index, Pulse>) + 4 * sizeof(void*) + pulse.capacity() * sizeof(double);
+    }
+    return size;
+}
@@ -39,6 +39,7 @@ namespace allpix {
      */
     class PropagatedCharge : public SensorCharge {
         friend class PixelCharge;
+        template <typename T> friend class ObjectColumns;
 
     public:
         /**
@@ -122,6 +123,7 @@ namespace allpix {
 
         void loadHistory() override;
         void petrifyHistory() override;
+        size_t getDynamicMemorySize() const override;
 
     private:
         PointerWrapper<DepositedCharge> deposited_charge_;
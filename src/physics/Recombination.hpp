@@ -48,7 +48,18 @@ namespace allpix {
          * @param timestep Current time step performed for the charge carrier
          * @return Recombination status, true if charge carrier has recombined, false if it still is alive
          */
-        virtual bool operator()(const CarrierType& type, double doping, double survival_prob, double timestep) const = 0;
+        virtual bool operator()(const CarrierType& type, double doping, double survival_prob, double timestep) const {
+            return survival_prob < (1 - std::exp(-1. * timestep / getLifetime(type, doping)));
+        };
+
+        /**
+         * Lifetime of the given carrier at the given doping concentration, used to sample the time until the charge carrier
+         * recombines
+         * @param type Type of charge carrier (electron or hole)
+         * @param doping (Effective) doping concentration
+         * @return Lifetime of the charge carrier, infinite if it does not recombine
+         */
+        virtual double getLifetime(const CarrierType& type, double doping) const = 0;
     };
 
     /**
@@ -59,6 +70,7 @@ namespace allpix {
     class None : virtual public RecombinationModel {
     public:
         bool operator()(const CarrierType&, double, double, double) const override { return false; };
+        double getLifetime(const CarrierType&, double) const override { return std::numeric_limits<double>::infinity(); }
     };
 
     /**
@@ -82,9 +94,7 @@ namespace allpix {
             }
         }
 
-        bool operator()(const CarrierType& type, double doping, double survival_prob, double timestep) const override {
-            return survival_prob < (1 - std::exp(-1. * timestep / lifetime(type, doping)));
-        };
+        double getLifetime(const CarrierType& type, double doping) const override { return lifetime(type, doping); }
 
     protected:
         double lifetime(const CarrierType& type, double doping) const {
@@ -124,6 +134,11 @@ namespace allpix {
                                          : (survival_prob < (1 - std::exp(-1. * timestep / lifetime(type, doping)))));
         };
 
+        double getLifetime(const CarrierType& type, double doping) const override {
+            auto minorityType = (doping > 0 ? CarrierType::HOLE : CarrierType::ELECTRON);
+            return (minorityType != type ? std::numeric_limits<double>::infinity() : lifetime(type, doping));
+        }
+
     protected:
         double lifetime(const CarrierType&, double doping) const { return 1. / (auger_coefficient_ * doping * doping); }
 
@@ -152,6 +167,14 @@ namespace allpix {
                 return survival_prob < (1 - std::exp(-1. * timestep / combined_lifetime));
             }
         };
+
+        double getLifetime(const CarrierType& type, double doping) const override {
+            auto minorityType = (doping > 0 ? CarrierType::HOLE : CarrierType::ELECTRON);
+            if(minorityType != type) {
+                return ShockleyReadHall::lifetime(type, doping);
+            }
+            return 1. / (1. / ShockleyReadHall::lifetime(type, doping) + 1. / Auger::lifetime(type, doping));
+        }
     };
 
     /**
@@ -163,10 +186,9 @@ namespace allpix {
         ConstantLifetime(double electron_lifetime, double hole_lifetime)
             : electron_lifetime_(electron_lifetime), hole_lifetime_(hole_lifetime) {}
 
-        bool operator()(const CarrierType& type, double, double survival_prob, double timestep) const override {
-            return survival_prob <
-                   (1 - std::exp(-1. * timestep / (type == CarrierType::ELECTRON ? electron_lifetime_ : hole_lifetime_)));
-        };
+        double getLifetime(const CarrierType& type, double) const override {
+            return (type == CarrierType::ELECTRON ? electron_lifetime_ : hole_lifetime_);
+        }
 
     private:
         double electron_lifetime_;
@@ -184,11 +206,9 @@ namespace allpix {
             hole_lifetime_ = configure_lifetime(config, CarrierType::HOLE, doping);
         };
 
-        bool operator()(const CarrierType& type, double doping, double survival_prob, double timestep) const override {
-            return survival_prob < (1 - std::exp(-1. * timestep /
-                                                 (type == CarrierType::ELECTRON ? electron_lifetime_->Eval(doping)
-                                                                                : hole_lifetime_->Eval(doping))));
-        };
+        double getLifetime(const CarrierType& type, double doping) const override {
+            return (type == CarrierType::ELECTRON ? electron_lifetime_->Eval(doping) : hole_lifetime_->Eval(doping));
+        }
 
     private:
         std::unique_ptr<TFormula> electron_lifetime_;
@@ -281,6 +301,12 @@ namespace allpix {
             return model_->operator()(std::forward<ARGS>(args)...);
         }
 
+        /**
+         * Lifetime forwarded to the recombination model
+         * @return Lifetime of the charge carrier
+         */
+        double getLifetime(const CarrierType& type, double doping) const { return model_->getLifetime(type, doping); }
+
     private:
         std::unique_ptr<RecombinationModel> model_{};
     };
@@ -47,11 +47,20 @@ namespace allpix {
          * additional possible parameter: efield_mag Magnitude of the electric field
          * @return Trapping status of the charge carrier
          */
-        virtual bool operator()(const CarrierType& type, double probability, double timestep, double) const {
-            return probability <
-                   (1 - std::exp(-1. * timestep / (type == CarrierType::ELECTRON ? tau_eff_electron_ : tau_eff_hole_)));
+        virtual bool operator()(const CarrierType& type, double probability, double timestep, double efield_mag) const {
+            return probability < (1 - std::exp(-1. * timestep / getLifetime(type, efield_mag)));
         };
 
+        /**
+         * Effective trapping time of the given carrier, used to sample the time until the charge carrier is trapped
+         * @param type Type of charge carrier (electron or hole)
+         * additional possible parameter: efield_mag Magnitude of the electric field
+         * @return Effective trapping time at the current position of the charge carrier
+         */
+        virtual double getLifetime(const CarrierType& type, double) const {
+            return (type == CarrierType::ELECTRON ? tau_eff_electron_ : tau_eff_hole_);
+        }
+
     protected:
         double tau_eff_electron_{std::numeric_limits<double>::max()};
         double tau_eff_hole_{std::numeric_limits<double>::max()};
@@ -64,6 +73,7 @@ namespace allpix {
     class NoTrapping : virtual public TrappingModel {
     public:
         bool operator()(const CarrierType&, double, double, double) const override { return false; };
+        double getLifetime(const CarrierType&, double) const override { return std::numeric_limits<double>::infinity(); }
     };
 
     /**
@@ -152,10 +162,9 @@ namespace allpix {
             tf_tau_eff_hole_ = configure_tau_eff(config, CarrierType::HOLE);
         };
 
-        bool operator()(const CarrierType& type, double probability, double timestep, double efield_mag) const override {
-            return probability < (1 - std::exp(-1. * timestep /
-                                               (type == CarrierType::ELECTRON ? tf_tau_eff_electron_->Eval(efield_mag)
-                                                                              : tf_tau_eff_hole_->Eval(efield_mag))));
+        double getLifetime(const CarrierType& type, double efield_mag) const override {
+            return (type == CarrierType::ELECTRON ? tf_tau_eff_electron_->Eval(efield_mag)
+                                                  : tf_tau_eff_hole_->Eval(efield_mag));
         };
 
     private:
@@ -254,6 +263,14 @@ namespace allpix {
             return model_->operator()(std::forward<ARGS>(args)...);
         }
 
+        /**
+         * Effective trapping time forwarded to the trapping model
+         * @return Effective trapping time
+         */
+        double getLifetime(const CarrierType& type, double efield_mag) const {
+            return model_->getLifetime(type, efield_mag);
+        }
+
     private:
         std::unique_ptr<TrappingModel> model_{};
     };
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Utility to sample the time until charge carriers are captured by recombination or trapping
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_CAPTURE_CLOCK_H
+#define ALLPIX_CAPTURE_CLOCK_H
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "core/utils/distributions.h"
+
+namespace allpix {
+    /**
+     * @brief Clock counting down the remaining lifetime of a charge carrier
+     *
+     * Instead of deciding on the survival of a charge carrier in every step, the number of local lifetimes the carrier
+     * survives is drawn once from an exponential distribution. Every step consumes the elapsed time in units of the local
+     * lifetime, and the carrier is captured when the clock has run out. For constant lifetimes this reproduces the
+     * distribution of capture times of the decisions per step, for lifetimes varying along the path of the charge carrier
+     * it corresponds to integrating the capture rate over time.
+     */
+    class CaptureClock {
+    public:
+        /**
+         * @brief Construct a clock which never runs out
+         */
+        CaptureClock() = default;
+
+        /**
+         * @brief Draw the number of lifetimes until the charge carrier is captured
+         * @param probability Uniformly distributed random number in [0, 1)
+         */
+        void reset(double probability) { remaining_ = -std::log1p(-probability); }
+
+        /**
+         * @brief Time until the charge carrier is captured, if the lifetime stays constant
+         * @param lifetime Current lifetime of the charge carrier
+         * @return Remaining time until capture
+         */
+        double remaining(double lifetime) const { return remaining_ * lifetime; }
+
+        /**
+         * @brief Advance the clock by a time step
+         * @param timestep Time elapsed
+         * @param lifetime Lifetime of the charge carrier during the time step
+         * @return True if the charge carrier has been captured within the time step
+         */
+        bool advance(double timestep, double lifetime) {
+            remaining_ -= timestep / lifetime;
+            return remaining_ <= 0;
+        }
+
+    private:
+        double remaining_{std::numeric_limits<double>::infinity()};
+    };
+
+    /**
+     * @brief Compare the fraction of captured charge carriers between decisions per step and capture clocks
+     * @param random_generator Random number generator used for both methods
+     * @param lifetime Constant lifetime of the charge carriers
+     * @param timestep Time step of the decisions per step
+     * @param duration Time during which charge carriers can be captured
+     * @param samples Number of charge carriers to sample with each method
+     * @return Fraction of captured charge carriers with decisions per step and with capture clocks
+     */
+    template <typename RandomGenerator>
+    std::pair<double, double> compare_capture_sampling(
+        RandomGenerator& random_generator, double lifetime, double timestep, double duration, unsigned int samples) {
+        allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+        auto steps = static_cast<unsigned int>(std::ceil(duration / timestep));
+
+        unsigned int captured_per_step = 0, captured_clock = 0;
+        for(unsigned int sample = 0; sample < samples; ++sample) {
+            for(unsigned int step = 0; step < steps; ++step) {
+                if(uniform_distribution(random_generator) < (1 - std::exp(-1. * timestep / lifetime))) {
+                    captured_per_step++;
+                    break;
+                }
+            }
+
+            CaptureClock clock;
+            clock.reset(uniform_distribution(random_generator));
+            if(clock.advance(steps * timestep, lifetime)) {
+                captured_clock++;
+            }
+        }
+        return {static_cast<double>(captured_per_step) / samples, static_cast<double>(captured_clock) / samples};
+    }
+} // namespace allpix
+
+#endif /* ALLPIX_CAPTURE_CLOCK_H */
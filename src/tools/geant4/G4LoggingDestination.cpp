@@ -26,7 +26,8 @@ LogLevel G4LoggingDestination::getG4coutReportingLevel() { return G4LoggingDesti
 LogLevel G4LoggingDestination::getG4cerrReportingLevel() { return G4LoggingDestination::reporting_level_g4cerr; }
 
 void G4LoggingDestination::process_message(LogLevel level, std::string& msg) const {
-    if(!msg.empty() && level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty()) {
+    if(!msg.empty() && level <= allpix::compiled_log_level && level <= allpix::Log::getReportingLevel() &&
+       !allpix::Log::getStreams().empty()) {
         // Remove line-break always added to G4String
         msg.pop_back();
         auto prev_section = Log::getSection();
@@ -0,0 +1,726 @@
+/**
+ * @file
+ * @brief Columnar representation of the objects for storage in ROOT RNTuples
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_RNTUPLE_OBJECTS_H
+#define ALLPIX_RNTUPLE_OBJECTS_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleReader.hxx>
+#include <ROOT/RNTupleWriter.hxx>
+
+#include "objects/objects.h"
+
+namespace allpix {
+    /**
+     * @brief Index of every stored object within the entry of its type
+     */
+    using ObjectIndices = std::unordered_map<const Object*, int32_t>;
+    /**
+     * @brief Objects read from the entries of every type, in the order of their index
+     */
+    using ObjectTable = std::map<std::type_index, std::vector<const Object*>>;
+
+    /**
+     * @brief Index of a related object, or -1 if the object is not stored in the same event
+     * @param indices Indices of all stored objects
+     * @param object Related object
+     * @return Index of the object within the entry of its type
+     */
+    inline int32_t object_index(const ObjectIndices& indices, const Object* object) {
+        auto iter = indices.find(object);
+        return (iter == indices.end() ? -1 : iter->second);
+    }
+    /**
+     * @brief Related object from its index
+     * @param table Objects read for the current event
+     * @param index Index of the object within the entry of its type
+     * @return Pointer to the related object, or a null pointer if it has not been stored
+     */
+    template <typename T> const T* object_pointer(const ObjectTable& table, int32_t index) {
+        auto iter = table.find(typeid(T));
+        if(index < 0 || iter == table.end() || static_cast<size_t>(index) >= iter->second.size()) {
+            return nullptr;
+        }
+        return static_cast<const T*>(iter->second[static_cast<size_t>(index)]);
+    }
+
+    /**
+     * @brief Column of values with one element per object
+     */
+    template <typename T> using Column = std::shared_ptr<std::vector<T>>;
+
+    /**
+     * @brief Columns of the three coordinates of a point
+     */
+    class PointColumns {
+    public:
+        /**
+         * @brief Create the columns in a model
+         * @param model Model of the RNTuple
+         * @param name Name of the point, the coordinate is appended to the column names
+         */
+        PointColumns(ROOT::RNTupleModel& model, const std::string& name)
+            : x_(model.MakeField<std::vector<double>>(name + "_x")), y_(model.MakeField<std::vector<double>>(name + "_y")),
+              z_(model.MakeField<std::vector<double>>(name + "_z")) {}
+
+        void clear() {
+            x_->clear();
+            y_->clear();
+            z_->clear();
+        }
+        void push_back(const ROOT::Math::XYZPoint& point) {
+            x_->push_back(point.x());
+            y_->push_back(point.y());
+            z_->push_back(point.z());
+        }
+        ROOT::Math::XYZPoint at(size_t i) const { return {x_->at(i), y_->at(i), z_->at(i)}; }
+
+    private:
+        Column<double> x_, y_, z_;
+    };
+
+    /**
+     * @brief Columns describing the pixel of an object
+     */
+    class PixelColumns {
+    public:
+        /**
+         * @brief Create the columns in a model
+         * @param model Model of the RNTuple
+         */
+        explicit PixelColumns(ROOT::RNTupleModel& model)
+            : index_x_(model.MakeField<std::vector<int32_t>>("pixel_x")),
+              index_y_(model.MakeField<std::vector<int32_t>>("pixel_y")),
+              type_(model.MakeField<std::vector<int8_t>>("pixel_type")), local_center_(model, "pixel_local_center"),
+              global_center_(model, "pixel_global_center"), size_x_(model.MakeField<std::vector<double>>("pixel_size_x")),
+              size_y_(model.MakeField<std::vector<double>>("pixel_size_y")) {}
+
+        void clear() {
+            index_x_->clear();
+            index_y_->clear();
+            type_->clear();
+            local_center_.clear();
+            global_center_.clear();
+            size_x_->clear();
+            size_y_->clear();
+        }
+        void push_back(const Pixel& pixel) {
+            index_x_->push_back(pixel.getIndex().x());
+            index_y_->push_back(pixel.getIndex().y());
+            type_->push_back(static_cast<int8_t>(pixel.getType()));
+            local_center_.push_back(pixel.getLocalCenter());
+            global_center_.push_back(pixel.getGlobalCenter());
+            size_x_->push_back(pixel.getSize().x());
+            size_y_->push_back(pixel.getSize().y());
+        }
+        Pixel at(size_t i) const {
+            return {Pixel::Index(index_x_->at(i), index_y_->at(i)),
+                    static_cast<Pixel::Type>(type_->at(i)),
+                    local_center_.at(i),
+                    global_center_.at(i),
+                    ROOT::Math::XYVector(size_x_->at(i), size_y_->at(i))};
+        }
+
+    private:
+        Column<int32_t> index_x_, index_y_;
+        Column<int8_t> type_;
+        PointColumns local_center_, global_center_;
+        Column<double> size_x_, size_y_;
+    };
+
+    /**
+     * @brief Columns describing the common properties of charges in the sensor
+     */
+    class SensorChargeColumns {
+    public:
+        /**
+         * @brief Create the columns in a model
+         * @param model Model of the RNTuple
+         */
+        explicit SensorChargeColumns(ROOT::RNTupleModel& model)
+            : local_position_(model, "local_position"), global_position_(model, "global_position"),
+              local_time_(model.MakeField<std::vector<double>>("local_time")),
+              global_time_(model.MakeField<std::vector<double>>("global_time")),
+              type_(model.MakeField<std::vector<int8_t>>("carrier_type")),
+              charge_(model.MakeField<std::vector<uint32_t>>("charge")) {}
+
+        void clear() {
+            local_position_.clear();
+            global_position_.clear();
+            local_time_->clear();
+            global_time_->clear();
+            type_->clear();
+            charge_->clear();
+        }
+        void push_back(const SensorCharge& charge) {
+            local_position_.push_back(charge.getLocalPosition());
+            global_position_.push_back(charge.getGlobalPosition());
+            local_time_->push_back(charge.getLocalTime());
+            global_time_->push_back(charge.getGlobalTime());
+            type_->push_back(static_cast<int8_t>(charge.getType()));
+            charge_->push_back(charge.getCharge());
+        }
+
+        ROOT::Math::XYZPoint localPosition(size_t i) const { return local_position_.at(i); }
+        ROOT::Math::XYZPoint globalPosition(size_t i) const { return global_position_.at(i); }
+        double localTime(size_t i) const { return local_time_->at(i); }
+        double globalTime(size_t i) const { return global_time_->at(i); }
+        CarrierType type(size_t i) const { return static_cast<CarrierType>(type_->at(i)); }
+        unsigned int charge(size_t i) const { return charge_->at(i); }
+
+    private:
+        PointColumns local_position_, global_position_;
+        Column<double> local_time_, global_time_;
+        Column<int8_t> type_;
+        Column<uint32_t> charge_;
+    };
+
+    /**
+     * @brief Convert a pulse to its binning and values, a binning of zero indicates an uninitialized pulse
+     */
+    inline double pulse_binning(const Pulse& pulse) { return pulse.isInitialized() ? pulse.getBinning() : 0.; }
+    inline Pulse make_pulse(double binning, const std::vector<double>& values) {
+        Pulse pulse = (binning > 0 ? Pulse(binning) : Pulse());
+        pulse.assign(values.begin(), values.end());
+        return pulse;
+    }
+
+    /**
+     * @brief Columns common to the storage of all object types
+     *
+     * Every entry of an RNTuple holds all objects of one type in an event. Every object stores the branch it has been
+     * dispatched with, which is the combination of detector and message name as for the tree output. Relations to other
+     * objects are stored as index of the related object within the entry of its type in the same event.
+     */
+    class BaseObjectColumns {
+    public:
+        virtual ~BaseObjectColumns() = default;
+
+        /// @{
+        /**
+         * @brief Disable copying and moving, the columns are bound to the model
+         */
+        BaseObjectColumns(const BaseObjectColumns&) = delete;
+        BaseObjectColumns& operator=(const BaseObjectColumns&) = delete;
+        BaseObjectColumns(BaseObjectColumns&&) = delete;
+        BaseObjectColumns& operator=(BaseObjectColumns&&) = delete;
+        /// @}
+
+        /**
+         * @brief Remove all objects from the columns
+         */
+        virtual void clear() = 0;
+
+        /**
+         * @brief Append an object to the columns
+         * @param object Object to append, has to be of the type of the columns
+         * @param branch Index of the branch of the object
+         * @param indices Indices of all objects stored in the event
+         */
+        virtual void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) = 0;
+
+        /**
+         * @brief Number of objects in the columns
+         */
+        size_t size() const { return branch_->size(); }
+        /**
+         * @brief Index of the branch of an object
+         * @param i Index of the object
+         */
+        uint32_t branch(size_t i) const { return branch_->at(i); }
+
+    protected:
+        explicit BaseObjectColumns(ROOT::RNTupleModel& model)
+            : branch_(model.MakeField<std::vector<uint32_t>>("branch")) {}
+
+        Column<uint32_t> branch_;
+    };
+
+    /**
+     * @brief Columns of a specific object type
+     *
+     * Every specialization provides a method to construct an object without its relations, and a method to set the
+     * relations once all objects of the event have been constructed.
+     */
+    template <typename T> class ObjectColumns;
+
+    template <> class ObjectColumns<MCTrack> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), start_point_(model, "start_point"), end_point_(model, "end_point"),
+              start_volume_(model.MakeField<std::vector<std::string>>("start_volume")),
+              end_volume_(model.MakeField<std::vector<std::string>>("end_volume")),
+              process_name_(model.MakeField<std::vector<std::string>>("creation_process_name")),
+              process_type_(model.MakeField<std::vector<int32_t>>("creation_process_type")),
+              particle_id_(model.MakeField<std::vector<int32_t>>("particle_id")),
+              start_time_(model.MakeField<std::vector<double>>("global_start_time")),
+              end_time_(model.MakeField<std::vector<double>>("global_end_time")),
+              initial_kinetic_energy_(model.MakeField<std::vector<double>>("initial_kinetic_energy")),
+              final_kinetic_energy_(model.MakeField<std::vector<double>>("final_kinetic_energy")),
+              initial_total_energy_(model.MakeField<std::vector<double>>("initial_total_energy")),
+              final_total_energy_(model.MakeField<std::vector<double>>("final_total_energy")),
+              parent_(model.MakeField<std::vector<int32_t>>("parent")) {}
+
+        void clear() override {
+            branch_->clear();
+            start_point_.clear();
+            end_point_.clear();
+            start_volume_->clear();
+            end_volume_->clear();
+            process_name_->clear();
+            process_type_->clear();
+            particle_id_->clear();
+            start_time_->clear();
+            end_time_->clear();
+            initial_kinetic_energy_->clear();
+            final_kinetic_energy_->clear();
+            initial_total_energy_->clear();
+            final_total_energy_->clear();
+            parent_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& track = static_cast<const MCTrack&>(object);
+            branch_->push_back(branch);
+            start_point_.push_back(track.start_point_);
+            end_point_.push_back(track.end_point_);
+            start_volume_->push_back(track.start_g4_vol_name_);
+            end_volume_->push_back(track.end_g4_vol_name_);
+            process_name_->push_back(track.origin_g4_process_name_);
+            process_type_->push_back(track.origin_g4_process_type_);
+            particle_id_->push_back(track.particle_id_);
+            start_time_->push_back(track.global_start_time_);
+            end_time_->push_back(track.global_end_time_);
+            initial_kinetic_energy_->push_back(track.initial_kin_E_);
+            final_kinetic_energy_->push_back(track.final_kin_E_);
+            initial_total_energy_->push_back(track.initial_tot_E_);
+            final_total_energy_->push_back(track.final_tot_E_);
+            parent_->push_back(object_index(indices, track.parent_.get()));
+        }
+
+        MCTrack get(size_t i) const {
+            return {start_point_.at(i),
+                    end_point_.at(i),
+                    start_volume_->at(i),
+                    end_volume_->at(i),
+                    process_name_->at(i),
+                    process_type_->at(i),
+                    particle_id_->at(i),
+                    start_time_->at(i),
+                    end_time_->at(i),
+                    initial_kinetic_energy_->at(i),
+                    final_kinetic_energy_->at(i),
+                    initial_total_energy_->at(i),
+                    final_total_energy_->at(i)};
+        }
+        void link(MCTrack& track, size_t i, const ObjectTable& table) const {
+            track.parent_ = Object::PointerWrapper<MCTrack>(object_pointer<MCTrack>(table, parent_->at(i)));
+        }
+
+    private:
+        PointColumns start_point_, end_point_;
+        Column<std::string> start_volume_, end_volume_, process_name_;
+        Column<int32_t> process_type_, particle_id_;
+        Column<double> start_time_, end_time_;
+        Column<double> initial_kinetic_energy_, final_kinetic_energy_, initial_total_energy_, final_total_energy_;
+        Column<int32_t> parent_;
+    };
+
+    template <> class ObjectColumns<MCParticle> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), local_start_point_(model, "local_start_point"),
+              global_start_point_(model, "global_start_point"), local_end_point_(model, "local_end_point"),
+              global_end_point_(model, "global_end_point"),
+              particle_id_(model.MakeField<std::vector<int32_t>>("particle_id")),
+              local_time_(model.MakeField<std::vector<double>>("local_time")),
+              global_time_(model.MakeField<std::vector<double>>("global_time")),
+              deposited_charge_(model.MakeField<std::vector<uint32_t>>("deposited_charge")),
+              total_energy_start_(model.MakeField<std::vector<double>>("total_energy_start")),
+              kinetic_energy_start_(model.MakeField<std::vector<double>>("kinetic_energy_start")),
+              parent_(model.MakeField<std::vector<int32_t>>("parent")),
+              track_(model.MakeField<std::vector<int32_t>>("track")) {}
+
+        void clear() override {
+            branch_->clear();
+            local_start_point_.clear();
+            global_start_point_.clear();
+            local_end_point_.clear();
+            global_end_point_.clear();
+            particle_id_->clear();
+            local_time_->clear();
+            global_time_->clear();
+            deposited_charge_->clear();
+            total_energy_start_->clear();
+            kinetic_energy_start_->clear();
+            parent_->clear();
+            track_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& particle = static_cast<const MCParticle&>(object);
+            branch_->push_back(branch);
+            local_start_point_.push_back(particle.local_start_point_);
+            global_start_point_.push_back(particle.global_start_point_);
+            local_end_point_.push_back(particle.local_end_point_);
+            global_end_point_.push_back(particle.global_end_point_);
+            particle_id_->push_back(particle.particle_id_);
+            local_time_->push_back(particle.local_time_);
+            global_time_->push_back(particle.global_time_);
+            deposited_charge_->push_back(particle.deposited_charge_);
+            total_energy_start_->push_back(particle.total_energy_start_);
+            kinetic_energy_start_->push_back(particle.kinetic_energy_start_);
+            parent_->push_back(object_index(indices, particle.parent_.get()));
+            track_->push_back(object_index(indices, particle.track_.get()));
+        }
+
+        MCParticle get(size_t i) const {
+            MCParticle particle(local_start_point_.at(i),
+                                global_start_point_.at(i),
+                                local_end_point_.at(i),
+                                global_end_point_.at(i),
+                                particle_id_->at(i),
+                                local_time_->at(i),
+                                global_time_->at(i));
+            particle.deposited_charge_ = deposited_charge_->at(i);
+            particle.total_energy_start_ = total_energy_start_->at(i);
+            particle.kinetic_energy_start_ = kinetic_energy_start_->at(i);
+            return particle;
+        }
+        void link(MCParticle& particle, size_t i, const ObjectTable& table) const {
+            particle.parent_ = Object::PointerWrapper<MCParticle>(object_pointer<MCParticle>(table, parent_->at(i)));
+            particle.track_ = Object::PointerWrapper<MCTrack>(object_pointer<MCTrack>(table, track_->at(i)));
+        }
+
+    private:
+        PointColumns local_start_point_, global_start_point_, local_end_point_, global_end_point_;
+        Column<int32_t> particle_id_;
+        Column<double> local_time_, global_time_;
+        Column<uint32_t> deposited_charge_;
+        Column<double> total_energy_start_, kinetic_energy_start_;
+        Column<int32_t> parent_, track_;
+    };
+
+    template <> class ObjectColumns<DepositedCharge> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), charge_(model), mc_particle_(model.MakeField<std::vector<int32_t>>("mc_particle")) {}
+
+        void clear() override {
+            branch_->clear();
+            charge_.clear();
+            mc_particle_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& deposit = static_cast<const DepositedCharge&>(object);
+            branch_->push_back(branch);
+            charge_.push_back(deposit);
+            mc_particle_->push_back(object_index(indices, deposit.mc_particle_.get()));
+        }
+
+        DepositedCharge get(size_t i) const {
+            return {charge_.localPosition(i),
+                    charge_.globalPosition(i),
+                    charge_.type(i),
+                    charge_.charge(i),
+                    charge_.localTime(i),
+                    charge_.globalTime(i)};
+        }
+        void link(DepositedCharge& deposit, size_t i, const ObjectTable& table) const {
+            deposit.mc_particle_ =
+                Object::PointerWrapper<MCParticle>(object_pointer<MCParticle>(table, mc_particle_->at(i)));
+        }
+
+    private:
+        SensorChargeColumns charge_;
+        Column<int32_t> mc_particle_;
+    };
+
+    template <> class ObjectColumns<PropagatedCharge> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), charge_(model), state_(model.MakeField<std::vector<int8_t>>("state")),
+              pulse_x_(model.MakeField<std::vector<std::vector<int32_t>>>("pulse_pixel_x")),
+              pulse_y_(model.MakeField<std::vector<std::vector<int32_t>>>("pulse_pixel_y")),
+              pulse_binning_(model.MakeField<std::vector<std::vector<double>>>("pulse_binning")),
+              pulse_values_(model.MakeField<std::vector<std::vector<std::vector<double>>>>("pulse_values")),
+              deposited_charge_(model.MakeField<std::vector<int32_t>>("deposited_charge")),
+              mc_particle_(model.MakeField<std::vector<int32_t>>("mc_particle")) {}
+
+        void clear() override {
+            branch_->clear();
+            charge_.clear();
+            state_->clear();
+            pulse_x_->clear();
+            pulse_y_->clear();
+            pulse_binning_->clear();
+            pulse_values_->clear();
+            deposited_charge_->clear();
+            mc_particle_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& propagated = static_cast<const PropagatedCharge&>(object);
+            branch_->push_back(branch);
+            charge_.push_back(propagated);
+            state_->push_back(static_cast<int8_t>(propagated.state_));
+
+            auto& pulse_x = pulse_x_->emplace_back();
+            auto& pulse_y = pulse_y_->emplace_back();
+            auto& pulse_binning = pulse_binning_->emplace_back();
+            auto& pulse_values = pulse_values_->emplace_back();
+            for(const auto& [index, pulse] : propagated.pulses_) {
+                pulse_x.push_back(index.x());
+                pulse_y.push_back(index.y());
+                pulse_binning.push_back(pulse_binning(pulse));
+                pulse_values.emplace_back(pulse.begin(), pulse.end());
+            }
+
+            deposited_charge_->push_back(object_index(indices, propagated.deposited_charge_.get()));
+            mc_particle_->push_back(object_index(indices, propagated.mc_particle_.get()));
+        }
+
+        PropagatedCharge get(size_t i) const {
+            PropagatedCharge propagated(charge_.localPosition(i),
+                                        charge_.globalPosition(i),
+                                        charge_.type(i),
+                                        charge_.charge(i),
+                                        charge_.localTime(i),
+                                        charge_.globalTime(i),
+                                        static_cast<CarrierState>(state_->at(i)));
+            for(size_t j = 0; j < pulse_x_->at(i).size(); ++j) {
+                propagated.pulses_.emplace(Pixel::Index(pulse_x_->at(i).at(j), pulse_y_->at(i).at(j)),
+                                           make_pulse(pulse_binning_->at(i).at(j), pulse_values_->at(i).at(j)));
+            }
+            return propagated;
+        }
+        void link(PropagatedCharge& propagated, size_t i, const ObjectTable& table) const {
+            propagated.deposited_charge_ =
+                Object::PointerWrapper<DepositedCharge>(object_pointer<DepositedCharge>(table, deposited_charge_->at(i)));
+            propagated.mc_particle_ =
+                Object::PointerWrapper<MCParticle>(object_pointer<MCParticle>(table, mc_particle_->at(i)));
+        }
+
+    private:
+        SensorChargeColumns charge_;
+        Column<int8_t> state_;
+        Column<std::vector<int32_t>> pulse_x_, pulse_y_;
+        Column<std::vector<double>> pulse_binning_;
+        Column<std::vector<std::vector<double>>> pulse_values_;
+        Column<int32_t> deposited_charge_, mc_particle_;
+    };
+
+    template <> class ObjectColumns<PixelCharge> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), pixel_(model), charge_(model.MakeField<std::vector<int64_t>>("charge")),
+              pulse_binning_(model.MakeField<std::vector<double>>("pulse_binning")),
+              pulse_values_(model.MakeField<std::vector<std::vector<double>>>("pulse_values")),
+              local_time_(model.MakeField<std::vector<double>>("local_time")),
+              global_time_(model.MakeField<std::vector<double>>("global_time")),
+              propagated_charges_(model.MakeField<std::vector<std::vector<int32_t>>>("propagated_charges")),
+              mc_particles_(model.MakeField<std::vector<std::vector<int32_t>>>("mc_particles")) {}
+
+        void clear() override {
+            branch_->clear();
+            pixel_.clear();
+            charge_->clear();
+            pulse_binning_->clear();
+            pulse_values_->clear();
+            local_time_->clear();
+            global_time_->clear();
+            propagated_charges_->clear();
+            mc_particles_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& pixel_charge = static_cast<const PixelCharge&>(object);
+            branch_->push_back(branch);
+            pixel_.push_back(pixel_charge.pixel_);
+            charge_->push_back(pixel_charge.charge_);
+            pulse_binning_->push_back(pulse_binning(pixel_charge.pulse_));
+            pulse_values_->emplace_back(pixel_charge.pulse_.begin(), pixel_charge.pulse_.end());
+            local_time_->push_back(pixel_charge.local_time_);
+            global_time_->push_back(pixel_charge.global_time_);
+
+            auto& propagated_charges = propagated_charges_->emplace_back();
+            for(const auto& propagated_charge : pixel_charge.propagated_charges_) {
+                propagated_charges.push_back(object_index(indices, propagated_charge.get()));
+            }
+            auto& mc_particles = mc_particles_->emplace_back();
+            for(const auto& mc_particle : pixel_charge.mc_particles_) {
+                mc_particles.push_back(object_index(indices, mc_particle.get()));
+            }
+        }
+
+        PixelCharge get(size_t i) const {
+            PixelCharge pixel_charge;
+            pixel_charge.pixel_ = pixel_.at(i);
+            pixel_charge.charge_ = charge_->at(i);
+            pixel_charge.pulse_ = make_pulse(pulse_binning_->at(i), pulse_values_->at(i));
+            pixel_charge.local_time_ = local_time_->at(i);
+            pixel_charge.global_time_ = global_time_->at(i);
+            return pixel_charge;
+        }
+        void link(PixelCharge& pixel_charge, size_t i, const ObjectTable& table) const {
+            pixel_charge.propagated_charges_.clear();
+            for(auto index : propagated_charges_->at(i)) {
+                pixel_charge.propagated_charges_.emplace_back(object_pointer<PropagatedCharge>(table, index));
+            }
+            pixel_charge.mc_particles_.clear();
+            for(auto index : mc_particles_->at(i)) {
+                pixel_charge.mc_particles_.emplace_back(object_pointer<MCParticle>(table, index));
+            }
+        }
+
+    private:
+        PixelColumns pixel_;
+        Column<int64_t> charge_;
+        Column<double> pulse_binning_;
+        Column<std::vector<double>> pulse_values_;
+        Column<double> local_time_, global_time_;
+        Column<std::vector<int32_t>> propagated_charges_, mc_particles_;
+    };
+
+    template <> class ObjectColumns<PixelPulse> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), pixel_(model), pulse_binning_(model.MakeField<std::vector<double>>("pulse_binning")),
+              pulse_values_(model.MakeField<std::vector<std::vector<double>>>("pulse_values")),
+              local_time_(model.MakeField<std::vector<double>>("local_time")),
+              global_time_(model.MakeField<std::vector<double>>("global_time")),
+              pixel_charge_(model.MakeField<std::vector<int32_t>>("pixel_charge")),
+              mc_particles_(model.MakeField<std::vector<std::vector<int32_t>>>("mc_particles")) {}
+
+        void clear() override {
+            branch_->clear();
+            pixel_.clear();
+            pulse_binning_->clear();
+            pulse_values_->clear();
+            local_time_->clear();
+            global_time_->clear();
+            pixel_charge_->clear();
+            mc_particles_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& pulse = static_cast<const PixelPulse&>(object);
+            branch_->push_back(branch);
+            pixel_.push_back(pulse.pixel_);
+            pulse_binning_->push_back(pulse_binning(pulse));
+            pulse_values_->emplace_back(pulse.begin(), pulse.end());
+            local_time_->push_back(pulse.local_time_);
+            global_time_->push_back(pulse.global_time_);
+            pixel_charge_->push_back(object_index(indices, pulse.pixel_charge_.get()));
+
+            auto& mc_particles = mc_particles_->emplace_back();
+            for(const auto& mc_particle : pulse.mc_particles_) {
+                mc_particles.push_back(object_index(indices, mc_particle.get()));
+            }
+        }
+
+        PixelPulse get(size_t i) const {
+            PixelPulse pulse(pixel_.at(i), make_pulse(pulse_binning_->at(i), pulse_values_->at(i)));
+            pulse.local_time_ = local_time_->at(i);
+            pulse.global_time_ = global_time_->at(i);
+            return pulse;
+        }
+        void link(PixelPulse& pulse, size_t i, const ObjectTable& table) const {
+            pulse.pixel_charge_ =
+                Object::PointerWrapper<PixelCharge>(object_pointer<PixelCharge>(table, pixel_charge_->at(i)));
+            pulse.mc_particles_.clear();
+            for(auto index : mc_particles_->at(i)) {
+                pulse.mc_particles_.emplace_back(object_pointer<MCParticle>(table, index));
+            }
+        }
+
+    private:
+        PixelColumns pixel_;
+        Column<double> pulse_binning_;
+        Column<std::vector<double>> pulse_values_;
+        Column<double> local_time_, global_time_;
+        Column<int32_t> pixel_charge_;
+        Column<std::vector<int32_t>> mc_particles_;
+    };
+
+    template <> class ObjectColumns<PixelHit> : public BaseObjectColumns {
+    public:
+        explicit ObjectColumns(ROOT::RNTupleModel& model)
+            : BaseObjectColumns(model), pixel_(model), local_time_(model.MakeField<std::vector<double>>("local_time")),
+              global_time_(model.MakeField<std::vector<double>>("global_time")),
+              signal_(model.MakeField<std::vector<double>>("signal")),
+              pixel_charge_(model.MakeField<std::vector<int32_t>>("pixel_charge")),
+              pixel_pulse_(model.MakeField<std::vector<int32_t>>("pixel_pulse")),
+              mc_particles_(model.MakeField<std::vector<std::vector<int32_t>>>("mc_particles")) {}
+
+        void clear() override {
+            branch_->clear();
+            pixel_.clear();
+            local_time_->clear();
+            global_time_->clear();
+            signal_->clear();
+            pixel_charge_->clear();
+            pixel_pulse_->clear();
+            mc_particles_->clear();
+        }
+
+        void fill(const Object& object, uint32_t branch, const ObjectIndices& indices) override {
+            const auto& hit = static_cast<const PixelHit&>(object);
+            branch_->push_back(branch);
+            pixel_.push_back(hit.pixel_);
+            local_time_->push_back(hit.local_time_);
+            global_time_->push_back(hit.global_time_);
+            signal_->push_back(hit.signal_);
+            pixel_charge_->push_back(object_index(indices, hit.pixel_charge_.get()));
+            pixel_pulse_->push_back(object_index(indices, hit.pixel_pulse_.get()));
+
+            auto& mc_particles = mc_particles_->emplace_back();
+            for(const auto& mc_particle : hit.mc_particles_) {
+                mc_particles.push_back(object_index(indices, mc_particle.get()));
+            }
+        }
+
+        PixelHit get(size_t i) const {
+            PixelHit hit;
+            hit.pixel_ = pixel_.at(i);
+            hit.local_time_ = local_time_->at(i);
+            hit.global_time_ = global_time_->at(i);
+            hit.signal_ = signal_->at(i);
+            return hit;
+        }
+        void link(PixelHit& hit, size_t i, const ObjectTable& table) const {
+            hit.pixel_charge_ =
+                Object::PointerWrapper<PixelCharge>(object_pointer<PixelCharge>(table, pixel_charge_->at(i)));
+            hit.pixel_pulse_ = Object::PointerWrapper<PixelPulse>(object_pointer<PixelPulse>(table, pixel_pulse_->at(i)));
+            hit.mc_particles_.clear();
+            for(auto index : mc_particles_->at(i)) {
+                hit.mc_particles_.emplace_back(object_pointer<MCParticle>(table, index));
+            }
+        }
+
+    private:
+        PixelColumns pixel_;
+        Column<double> local_time_, global_time_, signal_;
+        Column<int32_t> pixel_charge_, pixel_pulse_;
+        Column<std::vector<int32_t>> mc_particles_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_RNTUPLE_OBJECTS_H */
@@ -0,0 +1,236 @@
+/**
+ * @file
+ * @brief Utility to stream sampled charge carrier drift paths to compact trajectory files
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_TRAJECTORY_WRITER_H
+#define ALLPIX_TRAJECTORY_WRITER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/module/Module.hpp"
+#include "core/module/ThreadPool.hpp"
+#include "tools/line_graphs.h"
+
+namespace allpix {
+    /**
+     * @brief Writer for sampled charge carrier drift paths
+     *
+     * Every thread writes the trajectories of the events it processes to a separate file, such that no synchronization
+     * between threads is required. The files are named after the requested file name and the number of the writing thread,
+     * and are only created if the thread processes at least one event. Trajectories can be rendered offline, e.g. with the
+     * \c renderTrajectories.C macro shipped with the framework.
+     *
+     * Every file starts with a header containing the magic string \c APTRAJ01, the format version, the position precision,
+     * the decimation factor, the sampling step, and the center and half size of the sensor. The header is followed by one
+     * block per event with the event number, the number of charge carrier groups and the total number of points, and the
+     * columns of the start time, charge, carrier type, final state and number of points of every group as well as the x, y
+     * and z columns of all points. Positions are stored relative to the sensor center either as 16 bit integers scaled to
+     * the half size of the sensor or as half-precision floating point numbers in millimeters.
+     */
+    class TrajectoryWriter {
+    public:
+        /**
+         * @brief Type used to store the coordinates of the points
+         */
+        enum class Precision : uint8_t {
+            INT16 = 0, ///< Coordinates as 16 bit integers scaled to the half size of the sensor
+            FLOAT16,   ///< Coordinates as half-precision floating point numbers
+        };
+
+        /**
+         * @brief Construct the writer and determine the output file of every thread
+         * @param module Module to write the trajectories for, used to create output files and to obtain the detector
+         * @param file_name Name of the output files, to which the thread number is appended
+         * @param precision Type used to store the coordinates of the points
+         * @param decimation Only every n-th point of a trajectory is stored, the last point is always stored
+         * @param step Time between two points of the trajectories before decimation
+         */
+        TrajectoryWriter(
+            Module* module, const std::string& file_name, Precision precision, unsigned int decimation, double step)
+            : precision_(precision), decimation_(std::max(decimation, 1u)), step_(step) {
+            auto model = module->getDetector()->getModel();
+            auto center = model->getSensorCenter();
+            auto size = model->getSensorSize();
+            center_ = {static_cast<float>(center.x()), static_cast<float>(center.y()), static_cast<float>(center.z())};
+            half_size_ = {
+                static_cast<float>(size.x() / 2), static_cast<float>(size.y() / 2), static_cast<float>(size.z() / 2)};
+
+            // Create one file per thread, only opened when the thread first writes
+            for(unsigned int i = 0; i < ThreadPool::threadCount(); ++i) {
+                file_names_.push_back(module->createOutputFile(file_name + "_" + std::to_string(i), "aptraj", false, true));
+            }
+            files_.resize(file_names_.size());
+        }
+
+        /**
+         * @brief Write the trajectories of an event to the file of the calling thread
+         * @param event_num Index of the event
+         * @param output_plot_points List of points cached for plotting
+         */
+        void write(uint64_t event_num, const LineGraph::OutputPlotPoints& output_plot_points) {
+            auto& file = files_.at(ThreadPool::threadNum());
+            if(file == nullptr) {
+                file = open(file_names_.at(ThreadPool::threadNum()));
+            }
+
+            // Select the points to store for every trajectory
+            std::vector<float> times;
+            std::vector<uint32_t> charges, point_counts;
+            std::vector<int8_t> types;
+            std::vector<uint8_t> states;
+            std::vector<uint16_t> x, y, z;
+            for(const auto& [deposit, points] : output_plot_points) {
+                const auto& [time, charge, type, state] = deposit;
+                times.push_back(static_cast<float>(time));
+                charges.push_back(charge);
+                types.push_back(static_cast<int8_t>(type));
+                states.push_back(static_cast<uint8_t>(state));
+
+                auto count = x.size();
+                for(size_t i = 0; i < points.size(); ++i) {
+                    if(i % decimation_ != 0 && i + 1 != points.size()) {
+                        continue;
+                    }
+                    x.push_back(encode(points[i].x(), 0));
+                    y.push_back(encode(points[i].y(), 1));
+                    z.push_back(encode(points[i].z(), 2));
+                }
+                point_counts.push_back(static_cast<uint32_t>(x.size() - count));
+            }
+
+            auto carriers = static_cast<uint32_t>(output_plot_points.size());
+            auto total_points = static_cast<uint32_t>(x.size());
+            write_value(*file, event_num);
+            write_value(*file, carriers);
+            write_value(*file, total_points);
+            write_column(*file, times);
+            write_column(*file, charges);
+            write_column(*file, types);
+            write_column(*file, states);
+            write_column(*file, point_counts);
+            write_column(*file, x);
+            write_column(*file, y);
+            write_column(*file, z);
+
+            if(!file->good()) {
+                throw ModuleError("Could not write trajectories to file " + file_names_.at(ThreadPool::threadNum()));
+            }
+        }
+
+        /**
+         * @brief Convert a single precision floating point number to half precision, rounding to the nearest value
+         * @param value Value to convert
+         * @return Bit pattern of the half precision number
+         */
+        static uint16_t toHalf(float value) {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+            auto exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+            auto mantissa = bits & 0x7fffffu;
+
+            if(exponent >= 31) {
+                // Overflow, infinity and NaN
+                return static_cast<uint16_t>(sign | 0x7c00u | ((bits & 0x7fffffffu) > 0x7f800000u ? 0x200u : 0u));
+            }
+            if(exponent <= 0) {
+                // Subnormal numbers and underflow to zero
+                if(exponent < -10) {
+                    return sign;
+                }
+                mantissa |= 0x800000u;
+                auto shift = static_cast<unsigned int>(14 - exponent);
+                auto half = mantissa >> shift;
+                auto remainder = mantissa & ((1u << shift) - 1);
+                auto midpoint = 1u << (shift - 1);
+                if(remainder > midpoint || (remainder == midpoint && (half & 1u) != 0)) {
+                    ++half;
+                }
+                return static_cast<uint16_t>(sign | half);
+            }
+
+            // Normal numbers, a carry from rounding correctly increments the exponent
+            auto half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+            auto remainder = mantissa & 0x1fffu;
+            if(remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0)) {
+                ++half;
+            }
+            return static_cast<uint16_t>(sign | std::min(half, 0x7c00u));
+        }
+
+    private:
+        /**
+         * @brief Open the output file of a thread and write the header
+         * @param file_name Path of the output file
+         * @return Output stream
+         */
+        std::unique_ptr<std::ofstream> open(const std::string& file_name) const {
+            auto file = std::make_unique<std::ofstream>(file_name, std::ios_base::out | std::ios_base::binary);
+            if(!file->good()) {
+                throw ModuleError("Could not open trajectory file " + file_name);
+            }
+
+            file->write("APTRAJ01", 8);
+            write_value(*file, static_cast<uint16_t>(1));
+            write_value(*file, static_cast<uint8_t>(precision_));
+            write_value(*file, static_cast<uint32_t>(decimation_));
+            write_value(*file, step_);
+            for(const auto& value : center_) {
+                write_value(*file, value);
+            }
+            for(const auto& value : half_size_) {
+                write_value(*file, value);
+            }
+            return file;
+        }
+
+        /**
+         * @brief Quantize a coordinate relative to the sensor center
+         * @param value Coordinate in local coordinates
+         * @param axis Index of the axis
+         * @return Stored bit pattern
+         */
+        uint16_t encode(double value, size_t axis) const {
+            auto relative = static_cast<float>(value) - center_.at(axis);
+            if(precision_ == Precision::FLOAT16) {
+                return toHalf(relative);
+            }
+            auto scaled = std::clamp<long>(std::lround(relative / half_size_.at(axis) * INT16_MAX), -INT16_MAX, INT16_MAX);
+            return static_cast<uint16_t>(static_cast<int16_t>(scaled));
+        }
+
+        template <typename T> static void write_value(std::ofstream& file, const T& value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T)); // NOLINT
+        }
+        template <typename T> static void write_column(std::ofstream& file, const std::vector<T>& column) {
+            file.write(reinterpret_cast<const char*>(column.data()), // NOLINT
+                       static_cast<std::streamsize>(column.size() * sizeof(T)));
+        }
+
+        Precision precision_;
+        unsigned int decimation_;
+        double step_;
+        std::array<float, 3> center_{};
+        std::array<float, 3> half_size_{};
+
+        std::vector<std::string> file_names_;
+        std::vector<std::unique_ptr<std::ofstream>> files_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_TRAJECTORY_WRITER_H */
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Minimal harness to time micro-benchmarks of framework components
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_BENCHMARK_H
+#define ALLPIX_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace allpix::benchmark {
+
+    /**
+     * @brief Prevent the compiler from optimizing away the computation of a value
+     * @param value Value which should be considered as used
+     */
+    template <typename T> inline void keep(T&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile auto sink = &value;
+        (void)sink;
+#endif
+    }
+
+    /**
+     * @brief Result of a single benchmark
+     */
+    struct Result {
+        std::string name;
+        uint64_t iterations{};
+        double ns_per_op{};
+        double min_ns_per_op{};
+        double max_ns_per_op{};
+    };
+
+    /**
+     * @brief Collection of benchmarks which are timed with an automatically calibrated number of iterations
+     *
+     * Every benchmark is a function executing the measured operation a given number of times. The number of iterations is
+     * increased until a single repetition takes at least the minimum time, then the benchmark is repeated and the median
+     * time per operation is reported.
+     */
+    class Suite {
+    public:
+        using Function = std::function<void(uint64_t iterations)>;
+
+        /**
+         * @brief Construct a benchmark suite
+         * @param min_time Minimum duration of a single repetition in seconds
+         * @param repetitions Number of repetitions of every benchmark
+         */
+        Suite(double min_time, unsigned int repetitions)
+            : min_time_(min_time), repetitions_(std::max(1u, repetitions)) {}
+
+        /**
+         * @brief Only run benchmarks with names matching the given regular expression
+         * @param filter Regular expression to match benchmark names against
+         */
+        void setFilter(const std::string& filter) { filter_ = std::regex(filter); }
+
+        /**
+         * @brief Check whether a benchmark is selected by the filter
+         * @param name Name of the benchmark
+         * @return True if the benchmark should be executed
+         */
+        bool selected(const std::string& name) const { return std::regex_search(name, filter_); }
+
+        /**
+         * @brief Time a benchmark and store its result
+         * @param name Unique name of the benchmark, groups are separated by slashes
+         * @param function Function executing the measured operation the requested number of times
+         */
+        void run(const std::string& name, const Function& function) {
+            if(!selected(name)) {
+                return;
+            }
+
+            // Calibrate the number of iterations
+            uint64_t iterations = 1;
+            while(true) {
+                auto duration = time(function, iterations);
+                if(duration >= min_time_ || iterations >= (uint64_t(1) << 40)) {
+                    break;
+                }
+                // Aim slightly above the minimum time, but grow at most by a factor of ten per step
+                auto factor = duration > 0 ? 1.2 * min_time_ / duration : 10.;
+                iterations =
+                    std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * std::min(factor, 10.)));
+            }
+
+            // Repeat the measurement and use the median
+            std::vector<double> ns_per_op;
+            for(unsigned int i = 0; i < repetitions_; ++i) {
+                ns_per_op.push_back(1e9 * time(function, iterations) / static_cast<double>(iterations));
+            }
+            std::sort(ns_per_op.begin(), ns_per_op.end());
+
+            Result result;
+            result.name = name;
+            result.iterations = iterations;
+            result.ns_per_op = ns_per_op[ns_per_op.size() / 2];
+            result.min_ns_per_op = ns_per_op.front();
+            result.max_ns_per_op = ns_per_op.back();
+            results_.push_back(result);
+        }
+
+        /**
+         * @brief Get all results of the benchmarks run so far
+         * @return List of results in order of execution
+         */
+        const std::vector<Result>& getResults() const { return results_; }
+
+    private:
+        static double time(const Function& function, uint64_t iterations) {
+            auto start = std::chrono::steady_clock::now();
+            function(iterations);
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        }
+
+        double min_time_;
+        unsigned int repetitions_;
+        std::regex filter_{".*"};
+        std::vector<Result> results_;
+    };
+
+} // namespace allpix::benchmark
+
+#endif /* ALLPIX_BENCHMARK_H */
@@ -0,0 +1,486 @@
+/**
+ * @file
+ * @brief Micro-benchmarks of performance-critical framework components
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "Benchmark.hpp"
+
+#include "core/config/ConfigReader.hpp"
+#include "core/config/Configuration.hpp"
+#include "core/geometry/Detector.hpp"
+#include "core/geometry/DetectorModel.hpp"
+#include "core/module/ThreadPool.hpp"
+#include "core/utils/log.h"
+#include "objects/Pulse.hpp"
+#include "physics/Mobility.hpp"
+#include "physics/Recombination.hpp"
+#include "tools/runge_kutta.h"
+#include "tools/units.h"
+
+using namespace allpix;
+using allpix::benchmark::keep;
+
+// Number of pre-generated random inputs cycled through by the benchmarks
+static constexpr size_t n_samples = 4096;
+
+/**
+ * @brief Create the detector model all geometry and field benchmarks are based on
+ */
+static std::shared_ptr<DetectorModel> create_model() {
+    std::istringstream model_config("type = \"hybrid\"\n"
+                                    "geometry = \"pixel\"\n"
+                                    "number_of_pixels = 256 256\n"
+                                    "pixel_size = 55um 55um\n"
+                                    "sensor_thickness = 300um\n");
+    ConfigReader reader(model_config, "benchmark");
+    return DetectorModel::factory("benchmark", reader);
+}
+
+/**
+ * @brief Generate random positions within the sensor of the given model
+ */
+static std::vector<ROOT::Math::XYZPoint> sensor_positions(const std::shared_ptr<DetectorModel>& model) {
+    std::mt19937_64 random_generator(1);
+    auto center = model->getSensorCenter();
+    auto size = model->getSensorSize();
+    std::uniform_real_distribution<double> uniform(-0.5, 0.5);
+
+    std::vector<ROOT::Math::XYZPoint> positions;
+    for(size_t i = 0; i < n_samples; ++i) {
+        positions.emplace_back(center.x() + size.x() * uniform(random_generator),
+                               center.y() + size.y() * uniform(random_generator),
+                               center.z() + size.z() * uniform(random_generator));
+    }
+    return positions;
+}
+
+static void benchmark_fields(benchmark::Suite& suite) {
+    auto model = create_model();
+    auto positions = sensor_positions(model);
+    auto thickness_domain = std::make_pair(model->getSensorCenter().z() - model->getSensorSize().z() / 2,
+                                           model->getSensorCenter().z() + model->getSensorSize().z() / 2);
+
+    const std::vector<std::pair<std::string, FieldMapping>> mappings = {
+        {"pixel_full", FieldMapping::PIXEL_FULL},
+        {"pixel_full_inverse", FieldMapping::PIXEL_FULL_INVERSE},
+        {"pixel_half_left", FieldMapping::PIXEL_HALF_LEFT},
+        {"pixel_half_top", FieldMapping::PIXEL_HALF_TOP},
+        {"pixel_quadrant_i", FieldMapping::PIXEL_QUADRANT_I},
+        {"pixel_quadrant_iii", FieldMapping::PIXEL_QUADRANT_III},
+        {"sensor", FieldMapping::SENSOR},
+    };
+
+    std::mt19937_64 random_generator(2);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+
+    for(const auto& [name, mapping] : mappings) {
+        // Field size follows the area covered by the respective mapping
+        double scale_x = 1., scale_y = 1.;
+        if(mapping == FieldMapping::PIXEL_HALF_LEFT || mapping == FieldMapping::PIXEL_QUADRANT_I ||
+           mapping == FieldMapping::PIXEL_QUADRANT_III) {
+            scale_x = 0.5;
+        }
+        if(mapping == FieldMapping::PIXEL_HALF_TOP || mapping == FieldMapping::PIXEL_QUADRANT_I ||
+           mapping == FieldMapping::PIXEL_QUADRANT_III) {
+            scale_y = 0.5;
+        }
+        auto area = (mapping == FieldMapping::SENSOR ? ROOT::Math::XYVector(model->getSensorSize().x(),
+                                                                              model->getSensorSize().y())
+                                                     : model->getPixelSize());
+        std::array<double, 3> size{area.x() * scale_x, area.y() * scale_y, model->getSensorSize().z()};
+        std::array<size_t, 3> bins{mapping == FieldMapping::SENSOR ? 128ul : 25ul,
+                                   mapping == FieldMapping::SENSOR ? 128ul : 25ul,
+                                   30ul};
+
+        auto field = std::make_shared<std::vector<double>>(bins[0] * bins[1] * bins[2] * 3);
+        for(auto& value : *field) {
+            value = uniform(random_generator);
+        }
+
+        Detector detector("benchmark", model, ROOT::Math::XYZPoint(), ROOT::Math::Rotation3D());
+        detector.setElectricFieldGrid(field, bins, size, mapping, {1., 1.}, {0., 0.}, thickness_domain);
+
+        suite.run("field/electric/" + name, [&](uint64_t iterations) {
+            for(uint64_t i = 0; i < iterations; ++i) {
+                keep(detector.getElectricField(positions[i % n_samples]));
+            }
+        });
+    }
+}
+
+/**
+ * Separate lookups of the electric field and the doping concentration read from two arrays, i.e. two cache lines per
+ * query, while the field bundle reads both from a single interleaved record. The velocity evaluations of an RK5 step
+ * perform six such queries at nearby positions.
+ */
+static void benchmark_field_bundle(benchmark::Suite& suite) {
+    auto model = create_model();
+    auto positions = sensor_positions(model);
+    auto thickness_domain = std::make_pair(model->getSensorCenter().z() - model->getSensorSize().z() / 2,
+                                           model->getSensorCenter().z() + model->getSensorSize().z() / 2);
+
+    // Field map spanning the full sensor, larger than the typical last-level cache
+    std::array<size_t, 3> bins{256ul, 256ul, 30ul};
+    std::array<double, 3> size{model->getSensorSize().x(), model->getSensorSize().y(), model->getSensorSize().z()};
+    std::mt19937_64 random_generator(7);
+    std::uniform_real_distribution<double> uniform(-1., 1.);
+    auto efield = std::make_shared<std::vector<double>>(bins[0] * bins[1] * bins[2] * 3);
+    for(auto& value : *efield) {
+        value = uniform(random_generator);
+    }
+    auto doping = std::make_shared<std::vector<double>>(bins[0] * bins[1] * bins[2]);
+    for(auto& value : *doping) {
+        value = 1e12 * (2. + uniform(random_generator));
+    }
+
+    Detector detector("benchmark", model, ROOT::Math::XYZPoint(), ROOT::Math::Rotation3D());
+    detector.setElectricFieldGrid(efield, bins, size, FieldMapping::SENSOR, {1., 1.}, {0., 0.}, thickness_domain);
+    detector.setDopingProfileGrid(doping, bins, size, FieldMapping::SENSOR, {1., 1.}, {0., 0.}, thickness_domain);
+    if(!detector.hasFieldBundle()) {
+        throw std::runtime_error("field bundle has not been built");
+    }
+
+    suite.run("field/electric_doping/separate", [&](uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i) {
+            const auto& position = positions[i % n_samples];
+            keep(detector.getElectricField(position));
+            keep(detector.getDopingConcentration(position));
+        }
+    });
+    suite.run("field/electric_doping/bundle", [&](uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i) {
+            keep(detector.getElectricFieldAndDoping(positions[i % n_samples]));
+        }
+    });
+
+    // RK5 steps with the carrier velocity obtained from the field maps, restarted at random positions to defeat caching
+    Configuration config;
+    config.set<std::string>("mobility_model", "masetti");
+    config.set<double>("temperature", 293.15);
+    Mobility mobility(config, SensorMaterial::SILICON, true);
+    auto timestep = Units::get(0.01, "ns");
+
+    auto separate_velocity = [&](double, const Eigen::Vector3d& position) -> Eigen::Vector3d {
+        auto raw_field = detector.getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
+        Eigen::Vector3d field(raw_field.x(), raw_field.y(), raw_field.z());
+        auto concentration = detector.getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        return -mobility(CarrierType::ELECTRON, field.norm(), concentration) * field;
+    };
+    auto bundle_velocity = [&](double, const Eigen::Vector3d& position) -> Eigen::Vector3d {
+        auto [raw_field, concentration] = detector.getElectricFieldAndDoping(static_cast<ROOT::Math::XYZPoint>(position));
+        Eigen::Vector3d field(raw_field.x(), raw_field.y(), raw_field.z());
+        return -mobility(CarrierType::ELECTRON, field.norm(), concentration) * field;
+    };
+
+    auto run_steps = [&](const auto& velocity, uint64_t iterations) {
+        auto runge_kutta = make_runge_kutta(tableau::RK5, velocity, timestep, Eigen::Vector3d(0, 0, 0));
+        for(uint64_t i = 0; i < iterations; ++i) {
+            const auto& position = positions[i % n_samples];
+            runge_kutta.setValue(Eigen::Vector3d(position.x(), position.y(), position.z()));
+            keep(runge_kutta.step());
+        }
+    };
+    suite.run("propagation/runge_kutta_rk5_step_fields_separate",
+              [&](uint64_t iterations) { run_steps(separate_velocity, iterations); });
+    suite.run("propagation/runge_kutta_rk5_step_fields_bundle",
+              [&](uint64_t iterations) { run_steps(bundle_velocity, iterations); });
+}
+
+static void benchmark_mobility(benchmark::Suite& suite) {
+    std::mt19937_64 random_generator(3);
+    std::uniform_real_distribution<double> efield(0., Units::get(10., "kV/cm"));
+    std::uniform_real_distribution<double> doping(1e12, 1e18);
+    std::vector<std::array<double, 2>> samples;
+    for(size_t i = 0; i < n_samples; ++i) {
+        samples.push_back({efield(random_generator), doping(random_generator)});
+    }
+
+    for(const auto& model : {"jacoboni",
+                             "canali",
+                             "canali_fast",
+                             "hamburg",
+                             "hamburg_highfield",
+                             "masetti",
+                             "masetti_canali",
+                             "arora",
+                             "quay",
+                             "constant"}) {
+        Configuration config;
+        config.set<std::string>("mobility_model", model);
+        config.set<double>("temperature", 293.15);
+        config.set<double>("mobility_electron", Units::get(1400., "cm*cm/V/s"));
+        config.set<double>("mobility_hole", Units::get(450., "cm*cm/V/s"));
+        Mobility mobility(config, SensorMaterial::SILICON, true);
+
+        suite.run(std::string("physics/mobility/") + model, [&](uint64_t iterations) {
+            for(uint64_t i = 0; i < iterations; ++i) {
+                const auto& sample = samples[i % n_samples];
+                auto type = (i % 2 == 0 ? CarrierType::ELECTRON : CarrierType::HOLE);
+                keep(mobility(type, sample[0], sample[1]));
+            }
+        });
+    }
+}
+
+static void benchmark_recombination(benchmark::Suite& suite) {
+    std::mt19937_64 random_generator(4);
+    std::uniform_real_distribution<double> doping(1e12, 1e18);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::vector<std::array<double, 2>> samples;
+    for(size_t i = 0; i < n_samples; ++i) {
+        samples.push_back({doping(random_generator), uniform(random_generator)});
+    }
+
+    for(const auto& model : {"srh", "auger", "srh_auger", "constant", "none"}) {
+        Configuration config;
+        config.set<std::string>("recombination_model", model);
+        config.set<double>("temperature", 293.15);
+        config.set<double>("lifetime_electron", Units::get(1e-5, "s"));
+        config.set<double>("lifetime_hole", Units::get(4.5e-4, "s"));
+        Recombination recombination(config, true);
+
+        suite.run(std::string("physics/recombination/") + model, [&](uint64_t iterations) {
+            for(uint64_t i = 0; i < iterations; ++i) {
+                const auto& sample = samples[i % n_samples];
+                auto type = (i % 2 == 0 ? CarrierType::ELECTRON : CarrierType::HOLE);
+                keep(recombination(type, sample[0], sample[1], Units::get(0.1, "ns")));
+            }
+        });
+    }
+}
+
+static void benchmark_runge_kutta(benchmark::Suite& suite) {
+    // Carrier velocity in a linear field with field-dependent mobility, as used for the drift in the propagation modules
+    Configuration config;
+    config.set<std::string>("mobility_model", "jacoboni");
+    config.set<double>("temperature", 293.15);
+    Mobility mobility(config, SensorMaterial::SILICON);
+
+    auto velocity = [&](double, const Eigen::Vector3d& position) -> Eigen::Vector3d {
+        Eigen::Vector3d efield(0, 0, Units::get(200., "V") / Units::get(300., "um") * (1 + position.z()));
+        return -mobility(CarrierType::ELECTRON, efield.norm(), 0.) * efield;
+    };
+
+    suite.run("propagation/runge_kutta_rk5_step", [&](uint64_t iterations) {
+        auto runge_kutta = make_runge_kutta(tableau::RK5, velocity, Units::get(0.01, "ns"), Eigen::Vector3d(0, 0, 0.1));
+        for(uint64_t i = 0; i < iterations; ++i) {
+            auto step = runge_kutta.step();
+            keep(step);
+            // Keep the carrier within a sensible range of the field
+            if(i % 64 == 0) {
+                runge_kutta.setValue(Eigen::Vector3d(0, 0, 0.1));
+            }
+        }
+    });
+}
+
+static void benchmark_neighbors(benchmark::Suite& suite) {
+    auto model = create_model();
+    std::mt19937_64 random_generator(5);
+    std::uniform_int_distribution<int> index(0, 255);
+    std::vector<Pixel::Index> pixels;
+    for(size_t i = 0; i < n_samples; ++i) {
+        pixels.emplace_back(index(random_generator), index(random_generator));
+    }
+
+    for(size_t distance : {1ul, 3ul}) {
+        suite.run("geometry/neighbors/pixel_distance_" + std::to_string(distance), [&](uint64_t iterations) {
+            for(uint64_t i = 0; i < iterations; ++i) {
+                keep(model->getNeighbors(pixels[i % n_samples], distance));
+            }
+        });
+    }
+}
+
+static void benchmark_thread_pool(benchmark::Suite& suite) {
+    for(unsigned int workers : {1u, 4u}) {
+        ThreadPool::registerThreadCount(workers);
+        ThreadPool pool(workers, 1024);
+        std::atomic<uint64_t> counter{0};
+
+        suite.run("threadpool/submit_wait_" + std::to_string(workers) + "_workers", [&](uint64_t iterations) {
+            for(uint64_t i = 0; i < iterations; ++i) {
+                pool.submit([&counter]() { counter++; });
+            }
+            pool.wait();
+        });
+        pool.destroy();
+    }
+}
+
+static void benchmark_pulse(benchmark::Suite& suite) {
+    const auto timestep = Units::get(0.01, "ns");
+    const auto total_time = Units::get(25., "ns");
+
+    std::mt19937_64 random_generator(6);
+    std::uniform_real_distribution<double> time(0., total_time);
+    std::vector<double> times;
+    for(size_t i = 0; i < n_samples; ++i) {
+        times.push_back(time(random_generator));
+    }
+
+    suite.run("objects/pulse_add_charge", [&](uint64_t iterations) {
+        Pulse pulse(timestep, total_time);
+        for(uint64_t i = 0; i < iterations; ++i) {
+            pulse.addCharge(1., times[i % n_samples]);
+        }
+        keep(pulse);
+    });
+
+    // Convolution of a pulse with the amplifier response as performed per pixel in the CSADigitizer module, using the
+    // default integration time of the module
+    const auto csa_timestep = Units::get(0.1, "ns");
+    auto ntimepoints = static_cast<size_t>(std::lround(Units::get(500., "ns") / csa_timestep));
+    std::vector<double> impulse_response(ntimepoints);
+    for(size_t k = 0; k < ntimepoints; ++k) {
+        auto t = csa_timestep * static_cast<double>(k);
+        impulse_response[k] = (std::exp(-t / Units::get(10., "ns")) - std::exp(-t / Units::get(1., "ns"))) / 9.;
+    }
+    Pulse pulse(csa_timestep, total_time);
+    for(size_t i = 0; i < n_samples; ++i) {
+        pulse.addCharge(1., times[i]);
+    }
+
+    suite.run("digitization/csa_convolution", [&](uint64_t iterations) {
+        for(uint64_t n = 0; n < iterations; ++n) {
+            Pulse amplified_pulse(csa_timestep, Units::get(500., "ns"));
+            for(size_t k = 0; k < ntimepoints; ++k) {
+                double outsum{};
+                size_t jmin = (k >= pulse.size() - 1) ? k - (pulse.size() - 1) : 0;
+                for(size_t i = jmin; i <= k; ++i) {
+                    outsum += pulse.at(k - i) * impulse_response.at(i);
+                }
+                amplified_pulse.addCharge(outsum, csa_timestep * static_cast<double>(k));
+            }
+            keep(amplified_pulse);
+        }
+    });
+}
+
+/**
+ * @brief Write the benchmark results in JSON format as understood by the comparison script
+ */
+static void write_json(std::ostream& out, const std::vector<benchmark::Result>& results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for(size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << "    {\"name\": \"micro/" << result.name << "\", \"value\": " << std::setprecision(6) << result.ns_per_op
+            << ", \"unit\": \"ns\", \"higher_is_better\": false, \"iterations\": " << result.iterations
+            << ", \"min\": " << result.min_ns_per_op << ", \"max\": " << result.max_ns_per_op << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/**
+ * @brief Main function running the application
+ */
+int main(int argc, const char* argv[]) {
+
+    int return_code = 0;
+    try {
+        // Register the default set of units with this executable:
+        register_units();
+
+        // Add cout as the default logging stream
+        Log::addStream(std::cout);
+        Log::setReportingLevel(LogLevel::ERROR);
+
+        // Parse arguments
+        bool print_help = false;
+        std::string filter = ".*";
+        std::string json_file;
+        double min_time = 0.2;
+        unsigned int repetitions = 5;
+        for(int i = 1; i < argc; i++) {
+            if(strcmp(argv[i], "-h") == 0) {
+                print_help = true;
+            } else if(strcmp(argv[i], "-v") == 0 && (i + 1 < argc)) {
+                try {
+                    LogLevel log_level = Log::getLevelFromString(std::string(argv[++i]));
+                    Log::setReportingLevel(log_level);
+                } catch(std::invalid_argument& e) {
+                    LOG(ERROR) << "Invalid verbosity level \"" << std::string(argv[i]) << "\", ignoring overwrite";
+                }
+            } else if(strcmp(argv[i], "--filter") == 0 && (i + 1 < argc)) {
+                filter = std::string(argv[++i]);
+            } else if(strcmp(argv[i], "--json") == 0 && (i + 1 < argc)) {
+                json_file = std::string(argv[++i]);
+            } else if(strcmp(argv[i], "--min-time") == 0 && (i + 1 < argc)) {
+                min_time = std::stod(argv[++i]);
+            } else if(strcmp(argv[i], "--repetitions") == 0 && (i + 1 < argc)) {
+                repetitions = static_cast<unsigned int>(std::stoul(argv[++i]));
+            } else {
+                LOG(ERROR) << "Unrecognized command line argument \"" << argv[i] << "\"";
+                print_help = true;
+                return_code = 1;
+            }
+        }
+
+        if(print_help) {
+            std::cerr << "Usage: allpix_benchmark [--filter <regex>] [--json <file>]" << std::endl;
+            std::cerr << "Options are:" << std::endl;
+            std::cerr << "  --filter <regex>       only run benchmarks with names matching the regular expression"
+                      << std::endl;
+            std::cerr << "  --json <file>          write results in JSON format to the given file" << std::endl;
+            std::cerr << "  --min-time <seconds>   minimum duration of a single repetition (default 0.2)" << std::endl;
+            std::cerr << "  --repetitions <n>      number of repetitions, the median is reported (default 5)" << std::endl;
+            std::cerr << "  -v <level>             verbosity level, overwriting the global level" << std::endl;
+            return return_code;
+        }
+
+        benchmark::Suite suite(min_time, repetitions);
+        suite.setFilter(filter);
+
+        benchmark_fields(suite);
+        benchmark_field_bundle(suite);
+        benchmark_mobility(suite);
+        benchmark_recombination(suite);
+        benchmark_runge_kutta(suite);
+        benchmark_neighbors(suite);
+        benchmark_thread_pool(suite);
+        benchmark_pulse(suite);
+
+        for(const auto& result : suite.getResults()) {
+            std::cout << std::left << std::setw(48) << result.name << std::right << std::setw(14) << std::fixed
+                      << std::setprecision(2) << result.ns_per_op << " ns/op" << std::setw(14) << result.iterations
+                      << " iterations" << std::endl;
+        }
+
+        if(!json_file.empty()) {
+            std::ofstream json(json_file);
+            if(!json) {
+                throw std::runtime_error("cannot open output file " + json_file);
+            }
+            write_json(json, suite.getResults());
+            LOG(STATUS) << "Wrote benchmark results to " << json_file;
+        }
+    } catch(std::exception& e) {
+        LOG(FATAL) << "Fatal internal error" << std::endl << e.what() << std::endl << "Cannot continue.";
+        return_code = 127;
+    }
+
+    return return_code;
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/python3
+
+# SPDX-FileCopyrightText: 2024 CERN and the Allpix Squared authors
+# SPDX-License-Identifier: MIT
+
+"""
+Compare benchmark results against a stored baseline and report regressions exceeding a relative threshold. The exit code
+is non-zero if any benchmark regressed, such that the script can be used in continuous integration.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(files: list) -> dict:
+    """
+    Load and merge the benchmark entries of one or more JSON result files, keyed by their name.
+    """
+    results = {}
+    for file_name in files:
+        with open(file_name, encoding='utf-8') as file:
+            for entry in json.load(file)['benchmarks']:
+                results[entry['name']] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--baseline', nargs='+', required=True, help='JSON files with the baseline results')
+    parser.add_argument('--current', nargs='+', required=True, help='JSON files with the current results')
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='relative change above which a benchmark is considered regressed (default: 0.1)')
+    parser.add_argument('--ignore-missing', action='store_true',
+                        help='do not fail if a baseline benchmark is missing from the current results')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    missing = []
+    print('{:<72} {:>12} {:>12} {:>9}'.format('benchmark', 'baseline', 'current', 'change'))
+    for name, reference in sorted(baseline.items()):
+        if name not in current:
+            missing.append(name)
+            continue
+
+        old = reference['value']
+        new = current[name]['value']
+        change = (new - old) / old if old != 0 else 0.
+        # Express the change such that positive values always correspond to a slowdown
+        slowdown = -change if reference.get('higher_is_better', False) else change
+        if reference.get('symmetric', False):
+            slowdown = abs(change)
+
+        status = ''
+        if slowdown > args.threshold:
+            status = 'REGRESSION'
+            regressions.append(name)
+        elif slowdown < -args.threshold:
+            status = 'improved'
+        print('{:<72} {:>12.5g} {:>12.5g} {:>+8.1f}% {}'.format(name, old, new, 100 * change, status))
+
+    for name in sorted(set(current) - set(baseline)):
+        print('{:<72} {:>12} {:>12.5g} {:>9} new'.format(name, '-', current[name]['value'], ''))
+
+    if missing:
+        print('\nMissing from current results: ' + ', '.join(missing))
+    if regressions:
+        print('\n{} benchmarks regressed by more than {:.0f}%: {}'.format(
+            len(regressions), 100 * args.threshold, ', '.join(regressions)))
+
+    if regressions or (missing and not args.ignore_missing):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
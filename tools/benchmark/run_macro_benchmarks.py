@@ -0,0 +1,119 @@
+#!/usr/bin/python3
+
+# SPDX-FileCopyrightText: 2024 CERN and the Allpix Squared authors
+# SPDX-License-Identifier: MIT
+
+"""
+Run full simulations with the performance test configurations and report the event rate, the time spent per module and
+the memory usage in the JSON format used by the benchmark comparison script.
+"""
+
+import argparse
+import glob
+import json
+import logging
+import os
+import re
+import subprocess
+import tempfile
+
+
+ANSI_ESCAPE = re.compile(r'\x1B\[[0-9;]*m')
+TIME_UNITS = {'ns': 1e-9, 'us': 1e-6, 'ms': 1e-3, 's': 1.}
+
+RE_MODULE_TIME = re.compile(r'Module (\S+) took ([-+.\deE]+)(ns|us|ms|s)\b')
+RE_EVENT_TIME = re.compile(r'Average processing time is ([-+.\deE]+)(ns|us|ms|s)/event')
+RE_EVENT_RATE = re.compile(r'event generation at ([-+.\deE]+) Hz')
+RE_ARENA = re.compile(r'Event memory arenas served (\d+) events from (\d+) allocated buffers of \d+ kiB, '
+                      r'(\d+) allocations of (\d+) kiB exceeded the buffers')
+RE_PEAK_MEMORY = re.compile(r'Peak resident memory of the process is (\d+) MiB')
+RE_AVERAGE_CHARGE = re.compile(r'sensor\(s\) \(average of (\d+) per sensor for every event\)')
+
+
+def run_config(allpix: str, config: str, options: list, label: str = None) -> list:
+    """
+    Run a single configuration and parse the timing summary printed by the framework at the end of the run.
+    """
+    name = label if label else os.path.splitext(os.path.basename(config))[0]
+    with tempfile.TemporaryDirectory() as output_directory:
+        command = [allpix, '-c', os.path.basename(config),
+                   '-o', 'log_level="INFO"',
+                   '-o', 'log_format="SHORT"',
+                   '-o', 'output_directory="{}"'.format(output_directory)]
+        for option in options:
+            command += ['-o', option]
+        logging.info('Running %s', ' '.join(command))
+        process = subprocess.run(command, cwd=os.path.dirname(os.path.abspath(config)),
+                                 stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, check=False)
+
+    if process.returncode != 0:
+        raise RuntimeError('Simulation of {} failed with exit code {}:\n{}'.format(
+            config, process.returncode, process.stdout[-2000:]))
+
+    output = ANSI_ESCAPE.sub('', process.stdout)
+    results = []
+    rate = RE_EVENT_RATE.search(output)
+    if rate:
+        results.append({'name': 'macro/{}/events_per_second'.format(name), 'value': float(rate.group(1)),
+                        'unit': 'Hz', 'higher_is_better': True})
+    event_time = RE_EVENT_TIME.search(output)
+    if event_time:
+        results.append({'name': 'macro/{}/time_per_event'.format(name),
+                        'value': float(event_time.group(1)) * TIME_UNITS[event_time.group(2)],
+                        'unit': 's', 'higher_is_better': False})
+    arena = RE_ARENA.search(output)
+    if arena:
+        results.append({'name': 'macro/{}/arena_buffers'.format(name), 'value': int(arena.group(2)),
+                        'unit': '', 'higher_is_better': False})
+        results.append({'name': 'macro/{}/arena_overflow_allocations'.format(name), 'value': int(arena.group(3)),
+                        'unit': '', 'higher_is_better': False})
+    peak_memory = RE_PEAK_MEMORY.search(output)
+    if peak_memory:
+        results.append({'name': 'macro/{}/peak_memory'.format(name), 'value': int(peak_memory.group(1)) * 2**20,
+                        'unit': 'B', 'higher_is_better': False})
+    average_charge = RE_AVERAGE_CHARGE.search(output)
+    if average_charge:
+        # Physics result rather than a performance figure, any change in either direction is reported
+        results.append({'name': 'macro/{}/average_charge'.format(name), 'value': int(average_charge.group(1)),
+                        'unit': 'e', 'higher_is_better': False, 'symmetric': True})
+    for module, value, unit in RE_MODULE_TIME.findall(output):
+        results.append({'name': 'macro/{}/module/{}'.format(name, module), 'value': float(value) * TIME_UNITS[unit],
+                        'unit': 's', 'higher_is_better': False})
+
+    if not results:
+        raise RuntimeError('No timing information found in output of {}'.format(config))
+    return results
+
+
+def main():
+    source_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+    default_configs = sorted(glob.glob(os.path.join(source_dir, 'etc', 'unittests', 'test_performance', 'test_*.conf')))
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('configs', nargs='*', default=default_configs,
+                        help='configuration files to run (default: all performance test configurations)')
+    parser.add_argument('--allpix', default='allpix', help='path to the allpix executable')
+    parser.add_argument('--json', help='write results in JSON format to the given file')
+    parser.add_argument('-o', '--option', action='append', default=[],
+                        help='additional configuration option passed to every simulation')
+    parser.add_argument('--label', help='name to report the results of the configuration under instead of its file name, '
+                        'allowing to compare the results of different configurations')
+    parser.add_argument('-v', '--verbose', action='store_true', help='print the executed commands')
+    args = parser.parse_args()
+
+    logging.basicConfig(format='%(message)s', level=logging.INFO if args.verbose else logging.WARNING)
+
+    results = []
+    for config in args.configs:
+        results += run_config(args.allpix, config, args.option, args.label)
+
+    for result in results:
+        print('{:<72} {:>14.6g} {}'.format(result['name'], result['value'], result['unit']))
+
+    if args.json:
+        with open(args.json, 'w', encoding='utf-8') as file:
+            json.dump({'benchmarks': results}, file, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,320 @@
+#!/usr/bin/python3
+
+# SPDX-FileCopyrightText: 2024 CERN and the Allpix Squared authors
+# SPDX-License-Identifier: MIT
+
+"""
+Split a simulation into shards of consecutive events, run them as independent processes locally or on an HTCondor batch
+system, and merge the ROOT output files of all shards afterwards.
+
+Every shard is executed with the global parameters `number_of_shards` and `shard_index`, which makes the framework process
+only the corresponding range of events. Event numbers and event seeds are identical to a single-process run with the same
+random seed, such that the merged output reproduces the output of a single process.
+"""
+
+import argparse
+import logging
+import multiprocessing
+import os
+import shlex
+import subprocess
+import sys
+
+
+def shard_directory(output_directory: str, index: int) -> str:
+    """
+    Output directory of a single shard
+    """
+    return os.path.join(output_directory, 'shard_{}'.format(index))
+
+
+def shard_command(args, index) -> list:
+    """
+    Command line to execute a single shard
+    """
+    command = [args.allpix, '-c', os.path.abspath(args.config),
+               '-o', 'number_of_shards={}'.format(args.shards),
+               '-o', 'shard_index={}'.format(index),
+               '-o', 'output_directory="{}"'.format(shard_directory(os.path.abspath(args.output_directory), index))]
+    if args.seed is not None:
+        command += ['-o', 'random_seed={}'.format(args.seed)]
+    for option in args.option:
+        command += ['-o', option]
+    return command
+
+
+def run_shard(args_index) -> int:
+    """
+    Run a single shard and write its terminal output to a log file in the shard output directory
+    """
+    args, index = args_index
+    directory = shard_directory(args.output_directory, index)
+    os.makedirs(directory, exist_ok=True)
+    command = shard_command(args, index)
+    logging.info('Starting shard %d: %s', index, ' '.join(command))
+    with open(os.path.join(directory, 'allpix.log'), 'w') as log:
+        process = subprocess.run(command, cwd=os.path.dirname(os.path.abspath(args.config)),
+                                 stdout=log, stderr=subprocess.STDOUT, check=False)
+    if process.returncode != 0:
+        logging.error('Shard %d failed with exit code %d, see %s', index, process.returncode,
+                      os.path.join(directory, 'allpix.log'))
+    else:
+        logging.info('Finished shard %d', index)
+    return process.returncode
+
+
+def command_run(args) -> int:
+    """
+    Run all shards as local processes
+    """
+    jobs = args.jobs if args.jobs > 0 else min(args.shards, os.cpu_count())
+    with multiprocessing.Pool(jobs) as pool:
+        results = pool.map(run_shard, [(args, index) for index in range(args.shards)], chunksize=1)
+
+    failed = [index for index, result in enumerate(results) if result != 0]
+    if failed:
+        logging.error('Shards %s failed', ', '.join(str(index) for index in failed))
+        return 1
+
+    if args.merge:
+        return merge([shard_directory(args.output_directory, index) for index in range(args.shards)],
+                     args.output_directory, args.file, args.jobs)
+    return 0
+
+
+def command_submit(args) -> int:
+    """
+    Write an HTCondor submit description running one job per shard and optionally submit it
+    """
+    os.makedirs(args.output_directory, exist_ok=True)
+    command = shard_command(args, '$(Process)')
+
+    # Every shard creates its own output directory, but HTCondor needs the log directories to exist at submission time
+    for index in range(args.shards):
+        os.makedirs(shard_directory(args.output_directory, index), exist_ok=True)
+
+    submit_file = os.path.join(args.output_directory, 'shards.sub')
+    log_file = os.path.join(os.path.abspath(shard_directory(args.output_directory, '$(Process)')), 'allpix')
+    with open(submit_file, 'w') as submit:
+        submit.write('executable = {}\n'.format(command[0]))
+        submit.write('arguments = "{}"\n'.format(' '.join(
+            "'{}'".format(argument.replace('"', '""').replace("'", "''")) for argument in command[1:])))
+        submit.write('initialdir = {}\n'.format(os.path.dirname(os.path.abspath(args.config))))
+        submit.write('getenv = true\n')
+        submit.write('output = {}.log\n'.format(log_file))
+        submit.write('error = {}.err\n'.format(log_file))
+        submit.write('log = {}\n'.format(os.path.join(os.path.abspath(args.output_directory), 'shards.condor.log')))
+        for line in args.submit_option:
+            submit.write(line + '\n')
+        submit.write('queue {}\n'.format(args.shards))
+    logging.info('Wrote HTCondor submit description to %s', submit_file)
+
+    if args.submit:
+        return subprocess.run(['condor_submit', submit_file], check=False).returncode
+
+    print('Submit with: condor_submit {}'.format(shlex.quote(submit_file)))
+    print('Merge afterwards with: {} merge {} -o {}'.format(
+        sys.argv[0], ' '.join(shlex.quote(shard_directory(args.output_directory, index)) for index in range(args.shards)),
+        shlex.quote(args.output_directory)))
+    return 0
+
+
+def event_range(file_name: str):
+    """
+    Numbers of the first and last event stored in an output file of the ROOTObjectWriter, None for other files
+    """
+    import ROOT
+
+    input_file = ROOT.TFile.Open(file_name)
+    tree = input_file.Get('Event')
+    result = None
+    if tree and tree.GetEntries() > 0:
+        tree.GetEntry(0)
+        first = int(tree.ID)
+        tree.GetEntry(tree.GetEntries() - 1)
+        result = (first, int(tree.ID))
+    input_file.Close()
+    return result
+
+
+def merge_files(inputs_output) -> str:
+    """
+    Merge a list of files in the given order into a single output file.
+
+    The trees are concatenated by fast cloning of the baskets. The process identifiers of the input files are copied to the
+    output file and the references stored in TRefs are corrected for the offset in the process identifier table, such that
+    the cross-object references of all shards stay valid. Histograms are added. The configuration and geometry directories
+    written by the ROOTObjectWriter are not merged since they are identical for all shards.
+    """
+    import ROOT
+
+    inputs, output = inputs_output
+    merger = ROOT.TFileMerger(False, False)
+    merger.SetPrintLevel(0)
+    if not merger.OutputFile(output, 'RECREATE'):
+        raise RuntimeError('Cannot create output file {}'.format(output))
+    for input_file in inputs:
+        if not merger.AddFile(input_file, False):
+            raise RuntimeError('Cannot open input file {}'.format(input_file))
+    merger.AddObjectNames('config detectors models')
+    if not merger.PartialMerge(ROOT.TFileMerger.kAll | ROOT.TFileMerger.kRegular | ROOT.TFileMerger.kSkipListed):
+        raise RuntimeError('Merging into {} failed'.format(output))
+    return output
+
+
+def copy_directory(source, target, overrides: dict):
+    """
+    Recursively copy the objects of a directory, replacing the values of the given keys
+    """
+    import ROOT
+
+    copied = set()
+    for key in source.GetListOfKeys():
+        name = key.GetName()
+        if name in copied:
+            continue
+        copied.add(name)
+        if ROOT.TClass.GetClass(key.GetClassName()).InheritsFrom('TDirectory'):
+            copy_directory(key.ReadObj(), target.mkdir(name), {})
+        elif name in overrides:
+            if overrides[name] is not None:
+                target.WriteObject(ROOT.std.string(overrides[name]), name)
+        else:
+            target.WriteObjectAny(source.Get(name), key.GetClassName(), name)
+
+
+def merge(directories: list, output_directory: str, file_names: list, jobs: int) -> int:
+    """
+    Merge the output files of all shards
+    """
+    import ROOT
+
+    jobs = jobs if jobs > 0 else os.cpu_count()
+    os.makedirs(output_directory, exist_ok=True)
+    status = 0
+    for file_name in file_names:
+        file_name = file_name if file_name.endswith('.root') else file_name + '.root'
+        inputs = [os.path.join(directory, file_name) for directory in directories]
+        missing = [path for path in inputs if not os.path.isfile(path)]
+        if missing:
+            logging.warning('Skipping %s, not found in %s', file_name, ', '.join(missing))
+            continue
+
+        # Order the shards by their first event and check that no event is contained twice
+        ranges = [event_range(path) for path in inputs]
+        if all(shard_range is not None for shard_range in ranges):
+            order = sorted(range(len(inputs)), key=lambda index: ranges[index][0])
+            inputs = [inputs[index] for index in order]
+            ranges = [ranges[index] for index in order]
+            for previous, current, path in zip(ranges, ranges[1:], inputs[1:]):
+                if current[0] <= previous[1]:
+                    logging.error('Events %d to %d of %s overlap with the previous shard', current[0], previous[1], path)
+                    status = 1
+                elif current[0] != previous[1] + 1:
+                    logging.warning('Events %d to %d are missing before %s', previous[1] + 1, current[0] - 1, path)
+            if status != 0:
+                continue
+
+        output = os.path.join(output_directory, file_name)
+        logging.info('Merging %d files into %s', len(inputs), output)
+
+        # Merge contiguous groups of shards in parallel and concatenate the partial files afterwards
+        groups = min(jobs, len(inputs) // 2)
+        if groups > 1:
+            chunks = [inputs[len(inputs) * group // groups:len(inputs) * (group + 1) // groups] for group in range(groups)]
+            partials = ['{}.part{}'.format(output, group) for group in range(groups)]
+            context = multiprocessing.get_context('spawn')
+            with context.Pool(groups) as pool:
+                pool.map(merge_files, list(zip(chunks, partials)), chunksize=1)
+            merge_files((partials, output))
+            for partial in partials:
+                os.remove(partial)
+        else:
+            merge_files((inputs, output))
+
+        # Copy configuration and geometry of the first shard, updating the global configuration to the full run
+        first_file = ROOT.TFile.Open(inputs[0])
+        config_dir = first_file.Get('config')
+        if config_dir:
+            number_of_events = 0
+            for path in inputs:
+                shard_file = ROOT.TFile.Open(path)
+                number_of_events += int(str(shard_file.Get('config/Allpix/number_of_events')))
+                shard_file.Close()
+
+            output_file = ROOT.TFile.Open(output, 'UPDATE')
+            overrides = {'number_of_events': str(number_of_events), 'number_of_shards': None, 'shard_index': None}
+            for name in ['config', 'detectors', 'models']:
+                source = first_file.Get(name)
+                if source:
+                    target = output_file.mkdir(name)
+                    if name == 'config':
+                        for key in source.GetListOfKeys():
+                            sub_target = target.mkdir(key.GetName())
+                            copy_directory(key.ReadObj(), sub_target, overrides if key.GetName() == 'Allpix' else {})
+                    else:
+                        copy_directory(source, target, {})
+            output_file.Close()
+        first_file.Close()
+
+    return status
+
+
+def command_merge(args) -> int:
+    """
+    Merge the output files of shards that have been run before
+    """
+    return merge(args.directories, args.output_directory, args.file, args.jobs)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('-v', '--verbose', action='store_true', help='print progress information')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    def add_shard_arguments(subparser):
+        subparser.add_argument('config', help='main configuration file of the simulation')
+        subparser.add_argument('-n', '--shards', type=int, required=True, help='number of shards to split the run into')
+        subparser.add_argument('-d', '--output-directory', default='output',
+                               help='base output directory, shards are written to subdirectories shard_<index>')
+        subparser.add_argument('--allpix', default='allpix', help='path to the allpix executable')
+        subparser.add_argument('--seed', type=int,
+                               help='random seed of the run, required unless set in the configuration file')
+        subparser.add_argument('-o', '--option', action='append', default=[],
+                               help='additional configuration option passed to every shard')
+
+    def add_merge_arguments(subparser):
+        subparser.add_argument('-f', '--file', action='append', default=None,
+                               help='output file to merge relative to the shard directories (default: data.root and '
+                                    'modules.root)')
+        subparser.add_argument('-j', '--jobs', type=int, default=0,
+                               help='number of parallel processes (default: number of cores)')
+
+    run_parser = subparsers.add_parser('run', help='run all shards as local processes')
+    add_shard_arguments(run_parser)
+    add_merge_arguments(run_parser)
+    run_parser.add_argument('--merge', action='store_true', help='merge the output files after all shards finished')
+    run_parser.set_defaults(function=command_run)
+
+    submit_parser = subparsers.add_parser('submit', help='write an HTCondor submit description with one job per shard')
+    add_shard_arguments(submit_parser)
+    submit_parser.add_argument('-s', '--submit-option', action='append', default=[],
+                               help='additional line for the submit description, e.g. "+JobFlavour = \\"longlunch\\""')
+    submit_parser.add_argument('--submit', action='store_true', help='submit the jobs with condor_submit')
+    submit_parser.set_defaults(function=command_submit)
+
+    merge_parser = subparsers.add_parser('merge', help='merge the output files of all shards')
+    merge_parser.add_argument('directories', nargs='+', help='output directories of the shards')
+    merge_parser.add_argument('-o', '--output-directory', required=True, help='directory to write the merged files to')
+    add_merge_arguments(merge_parser)
+    merge_parser.set_defaults(function=command_merge)
+
+    args = parser.parse_args()
+    logging.basicConfig(format='%(levelname)s: %(message)s', level=logging.INFO if args.verbose else logging.WARNING)
+    if hasattr(args, 'file') and args.file is None:
+        args.file = ['data', 'modules']
+    return args.function(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
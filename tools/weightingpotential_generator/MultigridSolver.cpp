@@ -0,0 +1,360 @@
+/**
+ * @file
+ * @brief Implementation of the geometric multigrid solver for the weighting potential
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "MultigridSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <tuple>
+
+#include "core/utils/log.h"
+
+using namespace allpix;
+
+/**
+ * The grid is coarsened along every dimension with at least eight cells on the current level. The number of cells is
+ * rounded up such that all coarsening steps divide the grid evenly. Coarse grids fix every cell containing a fixed fine cell
+ * and use the front surface as electrode wherever a fine column does, with zero potential for the correction.
+ */
+MultigridSolver::MultigridSolver(std::array<size_t, 3> bins,
+                                 std::array<double, 3> size,
+                                 const VolumeElectrode& volume,
+                                 const SurfaceElectrode& surface,
+                                 ThreadPool& pool)
+    : size_(size), pool_(pool) {
+    // Determine the number of coarsening steps per dimension
+    std::array<size_t, 3> steps{};
+    size_t num_levels = 1;
+    for(size_t axis = 0; axis < 3; ++axis) {
+        bins[axis] = std::max(bins[axis], size_t(1));
+        while((bins[axis] >> steps[axis]) >= 8) {
+            steps[axis]++;
+        }
+        auto factor = size_t(1) << steps[axis];
+        bins[axis] = (bins[axis] + factor - 1) / factor * factor;
+        num_levels = std::max(num_levels, steps[axis] + 1);
+    }
+
+    levels_.resize(num_levels);
+    for(size_t level = 0; level < num_levels; ++level) {
+        auto& grid = levels_[level];
+        for(size_t axis = 0; axis < 3; ++axis) {
+            grid.bins[axis] = (level == 0 ? bins[axis] : levels_[level - 1].bins[axis] / levels_[level - 1].ratio[axis]);
+            grid.ratio[axis] = (level < steps[axis] ? 2 : 1);
+            auto h = size_[axis] / static_cast<double>(grid.bins[axis]);
+            grid.inv_h2[axis] = 1. / (h * h);
+        }
+        auto cells = grid.bins[0] * grid.bins[1] * grid.bins[2];
+        grid.potential.assign(cells, 0.);
+        grid.source.assign(cells, 0.);
+        grid.residual.assign(cells, 0.);
+        grid.fixed.assign(cells, 0);
+        grid.front.assign(grid.bins[0] * grid.bins[1], 0);
+        grid.front_potential.assign(grid.bins[0] * grid.bins[1], 0.);
+    }
+
+    // Sample the electrodes on the finest grid
+    auto& fine = levels_.front();
+    auto center = [&](size_t axis, size_t index) {
+        return (static_cast<double>(index) + 0.5) * size_[axis] / static_cast<double>(fine.bins[axis]) - size_[axis] / 2;
+    };
+    parallel_for(fine.bins[0], [&](size_t begin, size_t end) {
+        for(size_t x = begin; x < end; ++x) {
+            for(size_t y = 0; y < fine.bins[1]; ++y) {
+                auto column = x * fine.bins[1] + y;
+                auto front = surface(center(0, x), center(1, y));
+                if(front.has_value()) {
+                    fine.front[column] = 1;
+                    fine.front_potential[column] = front.value();
+                }
+                for(size_t z = 0; z < fine.bins[2]; ++z) {
+                    auto index = fine.index(x, y, z);
+                    auto fixed = volume({center(0, x), center(1, y), center(2, z)});
+                    if(fixed.has_value()) {
+                        fine.fixed[index] = 1;
+                        fine.potential[index] = fixed.value();
+                    }
+                }
+                // The potential of the front surface enters the equation of the adjacent cell as source
+                if(front.has_value()) {
+                    fine.source[fine.index(x, y, fine.bins[2] - 1)] = 2 * front.value() * fine.inv_h2[2];
+                }
+            }
+        }
+    });
+
+    // Propagate the electrodes to the coarse grids
+    for(size_t level = 1; level < num_levels; ++level) {
+        const auto& child = levels_[level - 1];
+        auto& grid = levels_[level];
+        for(size_t x = 0; x < child.bins[0]; ++x) {
+            for(size_t y = 0; y < child.bins[1]; ++y) {
+                auto column = (x / child.ratio[0]) * grid.bins[1] + y / child.ratio[1];
+                grid.front[column] |= child.front[x * child.bins[1] + y];
+                for(size_t z = 0; z < child.bins[2]; ++z) {
+                    grid.fixed[grid.index(x / child.ratio[0], y / child.ratio[1], z / child.ratio[2])] |=
+                        child.fixed[child.index(x, y, z)];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Neighbors outside the lateral boundaries are omitted, corresponding to insulating boundaries. The boundary conditions at
+ * the back and front surfaces are placed half a cell beyond the outermost cells, such that a fixed surface potential adds
+ * twice the coupling to the diagonal element. The contribution of the surface potential itself is part of the source term.
+ */
+inline std::pair<double, double> MultigridSolver::Level::stencil(size_t x, size_t y, size_t z) const {
+    auto index = this->index(x, y, z);
+    auto stride_x = bins[1] * bins[2];
+    auto stride_y = bins[2];
+    double sum = 0, diagonal = 0;
+    if(x > 0) {
+        sum += inv_h2[0] * potential[index - stride_x];
+        diagonal += inv_h2[0];
+    }
+    if(x + 1 < bins[0]) {
+        sum += inv_h2[0] * potential[index + stride_x];
+        diagonal += inv_h2[0];
+    }
+    if(y > 0) {
+        sum += inv_h2[1] * potential[index - stride_y];
+        diagonal += inv_h2[1];
+    }
+    if(y + 1 < bins[1]) {
+        sum += inv_h2[1] * potential[index + stride_y];
+        diagonal += inv_h2[1];
+    }
+    if(z > 0) {
+        sum += inv_h2[2] * potential[index - 1];
+        diagonal += inv_h2[2];
+    } else {
+        diagonal += 2 * inv_h2[2];
+    }
+    if(z + 1 < bins[2]) {
+        sum += inv_h2[2] * potential[index + 1];
+        diagonal += inv_h2[2];
+    } else if(front[x * bins[1] + y] != 0) {
+        diagonal += 2 * inv_h2[2];
+    }
+    return {sum, diagonal};
+}
+
+void MultigridSolver::parallel_for(size_t count, const std::function<void(size_t, size_t)>& function) {
+    auto chunks = std::min(count, size_t(4) * ThreadPool::threadCount());
+    for(size_t chunk = 0; chunk < chunks; ++chunk) {
+        pool_.submit(function, chunk * count / chunks, (chunk + 1) * count / chunks);
+    }
+    pool_.wait();
+}
+
+void MultigridSolver::smooth(Level& level, unsigned int sweeps) {
+    for(unsigned int sweep = 0; sweep < 2 * sweeps; ++sweep) {
+        auto color = sweep % 2;
+        parallel_for(level.bins[0], [&](size_t begin, size_t end) {
+            for(size_t x = begin; x < end; ++x) {
+                for(size_t y = 0; y < level.bins[1]; ++y) {
+                    for(size_t z = (x + y + color) % 2; z < level.bins[2]; z += 2) {
+                        auto index = level.index(x, y, z);
+                        if(level.fixed[index] != 0) {
+                            continue;
+                        }
+                        auto [sum, diagonal] = level.stencil(x, y, z);
+                        level.potential[index] = (sum + level.source[index]) / diagonal;
+                    }
+                }
+            }
+        });
+    }
+}
+
+double MultigridSolver::compute_residual(Level& level) {
+    std::mutex mutex;
+    double maximum = 0;
+    parallel_for(level.bins[0], [&](size_t begin, size_t end) {
+        double local_maximum = 0;
+        for(size_t x = begin; x < end; ++x) {
+            for(size_t y = 0; y < level.bins[1]; ++y) {
+                for(size_t z = 0; z < level.bins[2]; ++z) {
+                    auto index = level.index(x, y, z);
+                    if(level.fixed[index] != 0) {
+                        level.residual[index] = 0;
+                        continue;
+                    }
+                    auto [sum, diagonal] = level.stencil(x, y, z);
+                    level.residual[index] = level.source[index] + sum - diagonal * level.potential[index];
+                    local_maximum = std::max(local_maximum, std::fabs(level.residual[index]));
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock{mutex};
+        maximum = std::max(maximum, local_maximum);
+    });
+    return maximum;
+}
+
+/**
+ * The residual is restricted by averaging the merged cells, and the coarse correction is interpolated linearly between the
+ * cell centers of the coarse grid. On the coarsest grid, enough Gauss-Seidel sweeps are executed to converge.
+ */
+void MultigridSolver::cycle(size_t level) {
+    auto& grid = levels_[level];
+    if(level + 1 == levels_.size()) {
+        auto largest = *std::max_element(grid.bins.begin(), grid.bins.end());
+        smooth(grid, static_cast<unsigned int>(std::min(largest * largest, size_t(10000))));
+        return;
+    }
+
+    // Pre-smoothing and restriction of the residual to the coarse grid
+    smooth(grid, 2);
+    compute_residual(grid);
+    auto& coarse = levels_[level + 1];
+    const auto& ratio = grid.ratio;
+    auto weight = 1. / static_cast<double>(ratio[0] * ratio[1] * ratio[2]);
+    parallel_for(coarse.bins[0], [&](size_t begin, size_t end) {
+        for(size_t x = begin; x < end; ++x) {
+            for(size_t y = 0; y < coarse.bins[1]; ++y) {
+                for(size_t z = 0; z < coarse.bins[2]; ++z) {
+                    auto index = coarse.index(x, y, z);
+                    coarse.potential[index] = 0;
+                    double sum = 0;
+                    for(size_t dx = 0; dx < ratio[0]; ++dx) {
+                        for(size_t dy = 0; dy < ratio[1]; ++dy) {
+                            for(size_t dz = 0; dz < ratio[2]; ++dz) {
+                                sum += grid.residual[grid.index(x * ratio[0] + dx, y * ratio[1] + dy, z * ratio[2] + dz)];
+                            }
+                        }
+                    }
+                    coarse.source[index] = (coarse.fixed[index] != 0 ? 0. : sum * weight);
+                }
+            }
+        }
+    });
+
+    // Solve for the correction on the coarse grid
+    cycle(level + 1);
+
+    // Interpolate the correction to the fine grid
+    auto neighbors = [&](size_t axis, size_t index) {
+        std::array<std::pair<size_t, double>, 2> result{{{index / ratio[axis], 1.}, {index / ratio[axis], 0.}}};
+        if(ratio[axis] == 2) {
+            auto coarse_index = index / 2;
+            auto neighbor = (index % 2 == 0 ? coarse_index - 1 : coarse_index + 1);
+            if(index % 2 == 0 ? coarse_index > 0 : neighbor < coarse.bins[axis]) {
+                result = {{{coarse_index, 0.75}, {neighbor, 0.25}}};
+            }
+        }
+        return result;
+    };
+    parallel_for(grid.bins[0], [&](size_t begin, size_t end) {
+        for(size_t x = begin; x < end; ++x) {
+            auto nx = neighbors(0, x);
+            for(size_t y = 0; y < grid.bins[1]; ++y) {
+                auto ny = neighbors(1, y);
+                for(size_t z = 0; z < grid.bins[2]; ++z) {
+                    auto index = grid.index(x, y, z);
+                    if(grid.fixed[index] != 0) {
+                        continue;
+                    }
+                    auto nz = neighbors(2, z);
+                    double correction = 0;
+                    for(const auto& [cx, wx] : nx) {
+                        for(const auto& [cy, wy] : ny) {
+                            for(const auto& [cz, wz] : nz) {
+                                correction += wx * wy * wz * coarse.potential[coarse.index(cx, cy, cz)];
+                            }
+                        }
+                    }
+                    grid.potential[index] += correction;
+                }
+            }
+        }
+    });
+
+    // Post-smoothing
+    smooth(grid, 2);
+}
+
+std::pair<unsigned int, double> MultigridSolver::solve(double tolerance, unsigned int max_cycles) {
+    auto initial = compute_residual(levels_.front());
+    if(initial == 0) {
+        return {0, 0.};
+    }
+
+    unsigned int cycles = 0;
+    double relative = 1.;
+    while(cycles < max_cycles && relative > tolerance) {
+        cycle(0);
+        relative = compute_residual(levels_.front()) / initial;
+        cycles++;
+        LOG_PROGRESS(INFO, "multigrid") << "V-cycle " << cycles << ", relative residual " << relative;
+    }
+    return {cycles, relative};
+}
+
+/**
+ * The potential is interpolated linearly between the cell centers. Laterally, it is extrapolated as constant towards the
+ * insulating boundaries. Along z, the interpolation extends to the back surface at zero potential and to the front surface,
+ * which either is at the electrode potential or follows the adjacent cell.
+ */
+double MultigridSolver::get(const std::array<double, 3>& position) const {
+    const auto& grid = levels_.front();
+
+    // Continuous index relative to the cell centers
+    std::array<double, 3> coordinate{};
+    for(size_t axis = 0; axis < 3; ++axis) {
+        coordinate[axis] = (position[axis] + size_[axis] / 2) / size_[axis] * static_cast<double>(grid.bins[axis]) - 0.5;
+    }
+
+    auto lateral = [&](size_t axis) {
+        auto max_index = static_cast<double>(grid.bins[axis] - 1);
+        auto clamped = std::clamp(coordinate[axis], 0., max_index);
+        auto lower = static_cast<size_t>(std::floor(clamped));
+        auto upper = std::min(lower + 1, grid.bins[axis] - 1);
+        return std::make_tuple(lower, upper, clamped - static_cast<double>(lower));
+    };
+    auto [x0, x1, wx] = lateral(0);
+    auto [y0, y1, wy] = lateral(1);
+
+    // Potential along z of a column, with the surfaces at index -1 and bins
+    auto nz = static_cast<double>(grid.bins[2]);
+    auto t = std::clamp(coordinate[2], -0.5, nz - 0.5);
+    auto column_value = [&](size_t x, size_t y) {
+        auto value = [&](double k) {
+            if(k < 0) {
+                return 0.;
+            }
+            if(k >= nz) {
+                auto column = x * grid.bins[1] + y;
+                return (grid.front[column] != 0 ? grid.front_potential[column]
+                                                 : grid.potential[grid.index(x, y, grid.bins[2] - 1)]);
+            }
+            return grid.potential[grid.index(x, y, static_cast<size_t>(k))];
+        };
+        if(t < 0) {
+            auto w = (t + 0.5) / 0.5;
+            return (1 - w) * value(-1) + w * value(0);
+        }
+        if(t > nz - 1) {
+            auto w = (t - (nz - 1)) / 0.5;
+            return (1 - w) * value(nz - 1) + w * value(nz);
+        }
+        auto lower = std::floor(t);
+        auto upper = std::min(lower + 1, nz - 1);
+        auto w = t - lower;
+        return (1 - w) * value(lower) + w * value(upper);
+    };
+
+    return (1 - wx) * ((1 - wy) * column_value(x0, y0) + wy * column_value(x0, y1)) +
+           wx * ((1 - wy) * column_value(x1, y0) + wy * column_value(x1, y1));
+}
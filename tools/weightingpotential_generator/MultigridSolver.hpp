@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief Geometric multigrid solver for the Laplace equation of the weighting potential
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_MULTIGRID_SOLVER_H
+#define ALLPIX_MULTIGRID_SOLVER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core/module/ThreadPool.hpp"
+
+namespace allpix {
+
+    /**
+     * @brief Solver for the Laplace equation on a regular grid spanning the sensor volume
+     *
+     * The potential is discretized on the centers of the grid cells, with the sensor centered around the origin. Electrodes
+     * are either volumes in which the potential is fixed, or areas on the front surface of the sensor. The back surface is
+     * held at zero potential, all remaining boundaries are insulating.
+     *
+     * The equation is solved with V-cycles of a geometric multigrid using the correction scheme. Red-black Gauss-Seidel
+     * iterations serve as smoother, and the work on every level is distributed over the threads of a thread pool. Coarse
+     * grids are obtained by merging pairs of cells along every dimension with sufficient cells, and coarse cells containing
+     * an electrode are fixed to zero correction.
+     */
+    class MultigridSolver {
+    public:
+        /**
+         * @brief Function returning the potential of an electrode volume at a position, if any
+         */
+        using VolumeElectrode = std::function<std::optional<double>(const std::array<double, 3>&)>;
+
+        /**
+         * @brief Function returning the potential of an electrode on the front surface at a lateral position, if any
+         */
+        using SurfaceElectrode = std::function<std::optional<double>(double, double)>;
+
+        /**
+         * @brief Set up the grid hierarchy and the electrodes
+         * @param bins Minimum number of cells in x, y and z, rounded up to allow for coarsening
+         * @param size Size of the sensor volume
+         * @param volume Function providing the potential of volume electrodes
+         * @param surface Function providing the potential of electrodes on the front surface
+         * @param pool Thread pool to distribute the work to
+         */
+        MultigridSolver(std::array<size_t, 3> bins,
+                        std::array<double, 3> size,
+                        const VolumeElectrode& volume,
+                        const SurfaceElectrode& surface,
+                        ThreadPool& pool);
+
+        /**
+         * @brief Execute V-cycles until the residual has been reduced by the requested factor
+         * @param tolerance Maximum residual relative to the initial residual
+         * @param max_cycles Maximum number of V-cycles
+         * @return Number of V-cycles executed and final relative residual
+         */
+        std::pair<unsigned int, double> solve(double tolerance, unsigned int max_cycles);
+
+        /**
+         * @brief Interpolate the potential at a position
+         * @param position Position relative to the center of the sensor
+         * @return Potential at the position, taking into account the boundaries of the sensor
+         */
+        double get(const std::array<double, 3>& position) const;
+
+        /**
+         * @brief Get the number of cells on the finest grid
+         * @return Number of cells in x, y and z
+         */
+        std::array<size_t, 3> getBins() const { return levels_.front().bins; }
+
+        /**
+         * @brief Get the number of grids in the hierarchy
+         * @return Number of levels
+         */
+        size_t getLevels() const { return levels_.size(); }
+
+    private:
+        /**
+         * @brief Grid of one level of the hierarchy
+         */
+        struct Level {
+            std::array<size_t, 3> bins{};
+            std::array<double, 3> inv_h2{};
+            // Number of cells of this level merged into one cell of the next coarser level, per dimension
+            std::array<size_t, 3> ratio{{1, 1, 1}};
+            std::vector<double> potential;
+            std::vector<double> source;
+            std::vector<double> residual;
+            // Cells with fixed potential
+            std::vector<uint8_t> fixed;
+            // Columns whose front face is an electrode, and its potential
+            std::vector<uint8_t> front;
+            std::vector<double> front_potential;
+
+            size_t index(size_t x, size_t y, size_t z) const { return (x * bins[1] + y) * bins[2] + z; }
+
+            /**
+             * @brief Evaluate the stencil of the discretized Laplace operator at a cell
+             * @return Weighted sum of the neighboring potentials and diagonal element of the operator
+             */
+            std::pair<double, double> stencil(size_t x, size_t y, size_t z) const;
+        };
+
+        /**
+         * @brief Execute a V-cycle starting at the given level
+         * @param level Index of the level
+         */
+        void cycle(size_t level);
+
+        /**
+         * @brief Execute red-black Gauss-Seidel sweeps
+         * @param level Grid to smooth
+         * @param sweeps Number of sweeps
+         */
+        void smooth(Level& level, unsigned int sweeps);
+
+        /**
+         * @brief Compute the residual of the current potential
+         * @param level Grid to compute the residual for
+         * @return Maximum absolute residual
+         */
+        double compute_residual(Level& level);
+
+        /**
+         * @brief Execute a function for ranges of a dimension on the thread pool
+         * @param count Size of the dimension
+         * @param function Function called with the begin and end of a range
+         */
+        void parallel_for(size_t count, const std::function<void(size_t, size_t)>& function);
+
+        std::array<double, 3> size_;
+        std::vector<Level> levels_;
+        ThreadPool& pool_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_MULTIGRID_SOLVER_H */
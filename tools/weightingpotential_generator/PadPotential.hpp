@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief Analytic weighting potential of a rectangular pad
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_PAD_POTENTIAL_H
+#define ALLPIX_PAD_POTENTIAL_H
+
+#include <cmath>
+
+namespace allpix {
+
+    /**
+     * @brief Weighting potential of a rectangular pad on the front side of a sensor with infinite lateral extent
+     * @param pad_x Size of the pad in x
+     * @param pad_y Size of the pad in y
+     * @param thickness Thickness of the sensor
+     * @param x Position in x relative to the center of the pad
+     * @param y Position in y relative to the center of the pad
+     * @param z Position in z relative to the center of the sensor, with the pad at thickness / 2
+     * @return Weighting potential at the position
+     *
+     * The potential is calculated from the series expansion of mirror charges with the back side at zero potential.
+     */
+    inline double pad_potential(double pad_x, double pad_y, double thickness, double x, double y, double z) {
+        // Calculate values of the "f" function
+        auto f = [pad_x, pad_y](double px, double py, double u) {
+            // Calculate arctan fractions
+            auto arctan = [](double a, double b, double c) {
+                return std::atan(a * b / c / std::sqrt(a * a + b * b + c * c));
+            };
+
+            // Shift the x and y coordinates by plus/minus half the implant size:
+            double x1 = px - pad_x / 2;
+            double x2 = px + pad_x / 2;
+            double y1 = py - pad_y / 2;
+            double y2 = py + pad_y / 2;
+
+            // Calculate arctan sum and return
+            return arctan(x1, y1, u) + arctan(x2, y2, u) - arctan(x1, y2, u) - arctan(x2, y1, u);
+        };
+
+        // Transform into coordinate system with sensor between d/2 < z < -d/2:
+        auto d = thickness;
+        auto local_z = -z + thickness / 2;
+
+        // Calculate the series expansion
+        double sum = 0;
+        for(int n = 1; n <= 100; n++) {
+            sum += f(x, y, 2 * n * d - local_z) - f(x, y, 2 * n * d + local_z);
+        }
+
+        return (1 / (2 * M_PI) * (f(x, y, local_z) - sum));
+    }
+} // namespace allpix
+
+#endif /* ALLPIX_PAD_POTENTIAL_H */
@@ -11,6 +11,11 @@
 #include <csignal>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <optional>
+
+#include "MultigridSolver.hpp"
+#include "PadPotential.hpp"
 
 #include "core/config/ConfigReader.hpp"
 #include "core/config/Configuration.hpp"
@@ -77,12 +82,18 @@ int main(int argc, char** argv) {
         XYVectorInt matrix(3, 3);
         XYZVectorInt binning;
         auto file_type = allpix::FileType::APF;
+        bool numerical = false;
+        double tolerance = 1e-6;
 
         for(int i = 1; i < argc; i++) {
             if(strcmp(argv[i], "-h") == 0) {
                 print_help = true;
             } else if(strcmp(argv[i], "--init") == 0) {
                 file_type = allpix::FileType::INIT;
+            } else if(strcmp(argv[i], "--solver") == 0) {
+                numerical = true;
+            } else if(strcmp(argv[i], "--tolerance") == 0 && (i + 1 < argc)) {
+                tolerance = allpix::from_string<double>(std::string(argv[++i]));
             } else if(strcmp(argv[i], "--binning") == 0 && (i + 1 < argc)) {
                 binning = allpix::from_string<XYZVectorInt>(std::string(argv[++i]));
             } else if(strcmp(argv[i], "--matrix") == 0 && (i + 1 < argc)) {
@@ -125,6 +136,11 @@ int main(int argc, char** argv) {
             std::cout
                 << "\t --init                  Switch to enable writing the potential in the INIT format instead of APF"
                 << std::endl;
+            std::cout << "\t --solver                Switch to solve for the potential numerically using the electrodes "
+                         "of the model instead of the analytic pad model"
+                      << std::endl;
+            std::cout << "\t --tolerance <value>     Residual reduction at which the solver has converged (default 1e-6)"
+                      << std::endl;
             std::cout << "\t -v <level>              verbosity level (default reporiting level is INFO)" << std::endl;
             std::cout << "\t -h                      print this help text" << std::endl;
 
@@ -142,14 +158,14 @@ int main(int argc, char** argv) {
 
         // Get pixel implant size from the detector model:
         auto implants = model->getImplants();
-        if(implants.size() > 1) {
+        if(implants.size() > 1 && !numerical) {
             throw std::invalid_argument("Detector model contains more than one implant, not supported for pad potential");
         }
 
         auto implant = (implants.empty() ? ROOT::Math::XYZVector(model->getPixelSize().x(), model->getPixelSize().y(), 0)
                                          : implants.front().getSize());
-        // This module currently only works with pad definition, i.e. 2D implant deinition:
-        if(implant.z() > std::numeric_limits<double>::epsilon()) {
+        // The analytic potential only works with pad definition, i.e. 2D implant deinition:
+        if(implant.z() > std::numeric_limits<double>::epsilon() && !numerical) {
             throw std::invalid_argument("Generator can only be used with 2D implants, but non-zero thickness found");
         }
 
@@ -185,38 +201,102 @@ int main(int argc, char** argv) {
         LOG(STATUS) << "Starting weighting potential generation with " << num_threads << " threads.";
         auto weighting_potential = std::make_shared<std::vector<double>>();
 
-        auto generate_section = [&](size_t index_x) {
+        // clang-format off
+        auto init_function = [log_level = allpix::Log::getReportingLevel(), log_format = allpix::Log::getFormat()]() {
+            // clang-format on
+            // Initialize the threads to the same log level and format as the master setting
             allpix::Log::setReportingLevel(log_level);
+            allpix::Log::setFormat(log_format);
+        };
+
+        ThreadPool pool(num_threads, num_threads * 1024, init_function);
+
+        // Solve for the potential numerically if requested. The frontside implants of the pixel in the center of the field
+        // are held at unit potential, all other implants and the backside at zero potential. Without implants, the full
+        // pixel area on the front side is used as electrode.
+        std::unique_ptr<allpix::MultigridSolver> solver;
+        if(numerical) {
+            auto pixel_of = [pixel_pitch](double x, double y) {
+                return std::make_pair(std::lround(x / pixel_pitch.x()), std::lround(y / pixel_pitch.y()));
+            };
+            auto electrode_potential = [](const allpix::DetectorModel::Implant* electrode, long px, long py) {
+                auto readout =
+                    (electrode == nullptr || electrode->getType() == allpix::DetectorModel::Implant::Type::FRONTSIDE);
+                return (readout && px == 0 && py == 0 ? 1. : 0.);
+            };
+
+            auto volume = [&](const std::array<double, 3>& pos) -> std::optional<double> {
+                auto [px, py] = pixel_of(pos[0], pos[1]);
+                ROOT::Math::XYZVector in_pixel(pos[0] - static_cast<double>(px) * pixel_pitch.x(),
+                                               pos[1] - static_cast<double>(py) * pixel_pitch.y(),
+                                               pos[2]);
+                for(const auto& electrode : implants) {
+                    if(electrode.getSize().z() > std::numeric_limits<double>::epsilon() && electrode.contains(in_pixel)) {
+                        return electrode_potential(&electrode, px, py);
+                    }
+                }
+                return std::nullopt;
+            };
+
+            auto surface = [&](double x, double y) -> std::optional<double> {
+                auto [px, py] = pixel_of(x, y);
+                if(implants.empty()) {
+                    return electrode_potential(nullptr, px, py);
+                }
 
-            auto potential = [implant, thickness_domain](const ROOT::Math::XYZPoint& pos) {
-                // Calculate values of the "f" function
-                auto f = [implant](double x, double y, double u) {
-                    // Calculate arctan fractions
-                    auto arctan = [](double a, double b, double c) {
-                        return std::atan(a * b / c / std::sqrt(a * a + b * b + c * c));
-                    };
-
-                    // Shift the x and y coordinates by plus/minus half the implant size:
-                    double x1 = x - implant.x() / 2;
-                    double x2 = x + implant.x() / 2;
-                    double y1 = y - implant.y() / 2;
-                    double y2 = y + implant.y() / 2;
-
-                    // Calculate arctan sum and return
-                    return arctan(x1, y1, u) + arctan(x2, y2, u) - arctan(x1, y2, u) - arctan(x2, y1, u);
-                };
-
-                // Transform into coordinate system with sensor between d/2 < z < -d/2:
-                auto d = thickness_domain.second - thickness_domain.first;
-                auto local_z = -pos.z() + thickness_domain.second;
-
-                // Calculate the series expansion
-                double sum = 0;
-                for(int n = 1; n <= 100; n++) {
-                    sum += f(pos.x(), pos.y(), 2 * n * d - local_z) - f(pos.x(), pos.y(), 2 * n * d + local_z);
+                // Check the lateral extent of the two-dimensional implants on the front side
+                ROOT::Math::XYZVector in_pixel(
+                    x - static_cast<double>(px) * pixel_pitch.x(), y - static_cast<double>(py) * pixel_pitch.y(), 0);
+                for(const auto& electrode : implants) {
+                    if(electrode.getSize().z() > std::numeric_limits<double>::epsilon() ||
+                       electrode.getType() != allpix::DetectorModel::Implant::Type::FRONTSIDE) {
+                        continue;
+                    }
+                    auto local = electrode.getOrientation()(in_pixel - electrode.getOffset());
+                    auto size = electrode.getSize();
+                    bool covered = false;
+                    if(electrode.getShape() == allpix::DetectorModel::Implant::Shape::RECTANGLE) {
+                        covered = (std::fabs(local.x()) <= size.x() / 2 && std::fabs(local.y()) <= size.y() / 2);
+                    } else {
+                        covered = (local.x() * local.x() / (size.x() * size.x() / 4) +
+                                       local.y() * local.y() / (size.y() * size.y() / 4) <=
+                                   1);
+                    }
+                    if(covered) {
+                        return electrode_potential(&electrode, px, py);
+                    }
                 }
+                return std::nullopt;
+            };
+
+            std::array<size_t, 3> solver_bins{{binning.x(), binning.y(), binning.z()}};
+            std::array<double, 3> solver_size{{fieldsize.x(), fieldsize.y(), fieldsize.z()}};
+            solver = std::make_unique<allpix::MultigridSolver>(solver_bins, solver_size, volume, surface, pool);
+            solver_bins = solver->getBins();
+            LOG(STATUS) << "Solving for the potential on a grid of " << solver_bins[0] << "x" << solver_bins[1] << "x"
+                        << solver_bins[2] << " cells with " << solver->getLevels() << " multigrid levels";
+            auto [cycles, residual] = solver->solve(tolerance, 100);
+            if(residual > tolerance) {
+                LOG(WARNING) << "Solver did not converge after " << cycles << " V-cycles, relative residual is " << residual;
+            } else {
+                LOG(STATUS) << "Solver converged after " << cycles << " V-cycles, relative residual is " << residual;
+            }
+        }
 
-                return (1 / (2 * M_PI) * (f(pos.x(), pos.y(), local_z) - sum));
+        auto generate_section = [&](size_t index_x) {
+            allpix::Log::setReportingLevel(log_level);
+
+            auto potential = [implant, thickness_domain, &solver](const ROOT::Math::XYZPoint& pos) {
+                // Interpolate the numerical solution
+                if(solver) {
+                    return solver->get({pos.x(), pos.y(), pos.z()});
+                }
+                return allpix::pad_potential(implant.x(),
+                                             implant.y(),
+                                             thickness_domain.second - thickness_domain.first,
+                                             pos.x(),
+                                             pos.y(),
+                                             pos.z());
             };
 
             std::vector<double> slice;
@@ -232,15 +312,6 @@ int main(int argc, char** argv) {
             return slice;
         };
 
-        // clang-format off
-        auto init_function = [log_level = allpix::Log::getReportingLevel(), log_format = allpix::Log::getFormat()]() {
-            // clang-format on
-            // Initialize the threads to the same log level and format as the master setting
-            allpix::Log::setReportingLevel(log_level);
-            allpix::Log::setFormat(log_format);
-        };
-
-        ThreadPool pool(num_threads, num_threads * 1024, init_function);
         std::vector<std::shared_future<std::vector<double>>> wp_futures;
 
         // Loop over x coordinate, add tasks for each coordinate to the queue
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Unit test of the multigrid solver against the analytic weighting potential of a pad
+ *
+ * @copyright Copyright (c) 2024 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "MultigridSolver.hpp"
+#include "PadPotential.hpp"
+
+#include "core/module/ThreadPool.hpp"
+
+using namespace allpix;
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const std::string& message) {
+        if(!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++failures;
+        }
+    }
+
+    // Pad of 60um x 60um in the center of a field of 320um x 320um, on a sensor of 100um thickness
+    constexpr double pad = 60e-3;
+    constexpr double field = 320e-3;
+    constexpr double thickness = 100e-3;
+
+    /**
+     * @brief Solve for the potential of the pad and return the maximum deviation from the analytic potential
+     * @param pool Thread pool for the solver
+     * @param lateral_bins Number of cells in x and y
+     * @param depth_bins Number of cells in z
+     */
+    double max_deviation(ThreadPool& pool, size_t lateral_bins, size_t depth_bins) {
+        // The front side is grounded outside of the pad, as assumed by the analytic potential
+        auto surface = [](double x, double y) -> std::optional<double> {
+            return (std::fabs(x) <= pad / 2 && std::fabs(y) <= pad / 2 ? 1. : 0.);
+        };
+        auto volume = [](const std::array<double, 3>&) -> std::optional<double> { return std::nullopt; };
+
+        MultigridSolver solver(
+            {{lateral_bins, lateral_bins, depth_bins}}, {{field, field, thickness}}, volume, surface, pool);
+        check(solver.getBins() == std::array<size_t, 3>{{lateral_bins, lateral_bins, depth_bins}},
+              "grid of " + std::to_string(lateral_bins) + " cells has been resized");
+
+        // The residual has to be reduced by ten orders of magnitude within a few V-cycles, independent of the grid size
+        auto [cycles, residual] = solver.solve(1e-10, 50);
+        check(residual <= 1e-10, "solver did not converge, relative residual " + std::to_string(residual));
+        check(cycles <= 20, "solver took " + std::to_string(cycles) + " V-cycles to converge");
+
+        // Compare along the central axis, below the pad edge and below the neighboring pixels, where the potential is smooth
+        double deviation = 0;
+        for(auto x : {0., pad / 2, pad, 2 * pad}) {
+            for(auto y : {0., pad / 4}) {
+                for(int k = 1; k < 10; ++k) {
+                    auto z = thickness / 2 - thickness * k / 10;
+                    auto numerical = solver.get({x, y, z});
+                    auto analytic = pad_potential(pad, pad, thickness, x, y, z);
+                    deviation = std::max(deviation, std::fabs(numerical - analytic));
+                }
+            }
+        }
+        return deviation;
+    }
+} // namespace
+
+int main() {
+    ThreadPool::registerThreadCount(2);
+    ThreadPool pool(2, 1024);
+
+    auto coarse = max_deviation(pool, 32, 20);
+    auto fine = max_deviation(pool, 64, 40);
+    std::cout << "Maximum deviation from the analytic potential: " << coarse << " on the coarse grid, " << fine
+              << " on the fine grid" << std::endl;
+
+    // The discretization error has to decrease at least linearly with the cell size
+    check(fine < coarse / 2, "deviation does not decrease on the finer grid");
+    check(fine < 0.01, "deviation from the analytic potential " + std::to_string(fine));
+
+    pool.destroy();
+    if(failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}